@@ -0,0 +1,400 @@
+#!/usr/bin/env python3
+"""
+Workload benchmark suite for specio3.
+
+Runs defined workloads (many small files, one huge multifile, random subfile
+access, batch matrix loading) with every applicable reader mode, against a
+warm and a cold page cache, and reports latency percentiles, throughput,
+peak RSS, native heap high-water mark and CPU utilization. Each (workload,
+mode, cache) combination runs in a fresh process so peak RSS belongs to that
+run alone.
+
+Results are written as JSON so runs can be compared across commits:
+
+    python scripts/benchmark_suite.py --output before.json
+    python scripts/benchmark_suite.py --output after.json
+    python scripts/benchmark_suite.py --compare before.json after.json
+"""
+
+import argparse
+import json
+import multiprocessing
+import os
+import platform
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+import numpy as np
+
+# Add the project root to Python path so we can import specio3
+script_dir = Path(__file__).parent
+project_root = script_dir.parent
+sys.path.insert(0, str(project_root))
+
+import specio3  # noqa: E402
+
+try:
+    import resource
+except ImportError:  # Windows
+    resource = None
+
+try:
+    import psutil
+except ImportError:
+    psutil = None
+
+
+def write_synthetic_multifile(path, num_subfiles, num_points, seed=0):
+    """
+    Write an XYY multifile (shared X, 32-bit integer Y) readable by specio3.
+
+    Header fields are placed where ``read_spc_impl`` reads them: flags and
+    exponent in bytes 0-1, the point count in bytes 2-3, first/last X as
+    floats at 8 and 12 and the subfile count at 22.
+    """
+    if num_points > 0xFFFF:
+        raise ValueError("num_points must fit in 16 bits")
+    rng = np.random.default_rng(seed)
+    exponent = 8
+    header = bytearray(512)
+    header[0] = 0x90  # multifile, explicit X
+    header[1] = exponent
+    struct.pack_into('<H', header, 2, num_points)
+    struct.pack_into('<ff', header, 8, 400.0, 4000.0)
+    struct.pack_into('<I', header, 22, num_subfiles)
+
+    x = np.linspace(400.0, 4000.0, num_points, dtype='<f4')
+    base = np.sin(np.linspace(0, 20, num_points)) * 2**20
+    with open(path, 'wb') as f:
+        f.write(header)
+        f.write(x.tobytes())
+        for i in range(num_subfiles):
+            subheader = bytearray(32)
+            subheader[1] = exponent
+            struct.pack_into('<ff', subheader, 4, float(i), float(i))
+            f.write(subheader)
+        for _ in range(num_subfiles):
+            y = base + rng.normal(0, 2**12, num_points)
+            f.write(y.astype('<i4').tobytes())
+
+
+def drop_from_page_cache(path):
+    """Ask the OS to evict a file's pages. Returns False where unsupported."""
+    if not hasattr(os, 'posix_fadvise'):
+        return False
+    fd = os.open(path, os.O_RDONLY)
+    try:
+        os.posix_fadvise(fd, 0, 0, os.POSIX_FADV_DONTNEED)
+    finally:
+        os.close(fd)
+    return True
+
+
+def peak_rss_mb():
+    """Peak resident set size of this process in MB."""
+    if resource is not None:
+        peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        # ru_maxrss is in bytes on macOS and in kilobytes elsewhere
+        return peak / (1024 * 1024) if sys.platform == 'darwin' else peak / 1024
+    if psutil is not None:
+        return getattr(psutil.Process().memory_info(), 'peak_wset', 0) / (1024 * 1024)
+    return float('nan')
+
+
+def current_rss_mb():
+    if psutil is not None:
+        return psutil.Process().memory_info().rss / (1024 * 1024)
+    return float('nan')
+
+
+# ---------------------------------------------------------------------------
+# Workloads
+#
+# Each workload maps reader modes to a factory. A factory receives the
+# workload context and returns a list of operations; each operation is a
+# (files_touched, callable) pair and one call is one latency sample.
+# ---------------------------------------------------------------------------
+
+
+def _read_spc_matrix_rows(path):
+    return specio3.read_spc_matrix(path)[1]
+
+
+def small_files_ops(ctx, mode):
+    readers = {
+        'read_spc': specio3.read_spc,
+        'read_spc_matrix': _read_spc_matrix_rows,
+    }
+    read = readers[mode]
+    return [([p], (lambda p=p: read(p))) for p in ctx['small_files']]
+
+
+def huge_multifile_ops(ctx, mode):
+    path = ctx['huge_file']
+    readers = {
+        'read_spc': lambda: specio3.read_spc(path),
+        'read_spc_matrix': lambda: specio3.read_spc_matrix(path),
+        'read_spc_matrix_transposed': lambda: specio3.read_spc_matrix(path, transpose=True),
+        'read_trace': lambda: specio3.read_trace(path, x=[1000.0, 2000.0]),
+    }
+    return [([path], readers[mode])] * ctx['repeat']
+
+
+def random_subfile_ops(ctx, mode):
+    path = ctx['huge_file']
+    rng = random.Random(ctx['seed'])
+    indices = [rng.randrange(ctx['huge_subfiles']) for _ in range(ctx['repeat'])]
+    if mode == 'SPCHandle.read':
+        # Opened once, outside the timed operations, as a long-lived service would
+        read = specio3.SPCHandle(path).read
+    else:
+        def read(i):
+            # Parse the headers and map the file again for every subfile
+            return specio3.SPCHandle(path).read(i)
+    return [([path], (lambda i=i: read(i))) for i in indices]
+
+
+def batch_matrix_ops(ctx, mode):
+    files = ctx['batch_files']
+
+    def read_spc_vstack():
+        return np.vstack([y for path in files for _, y in specio3.read_spc(path)])
+
+    def read_spc_matrix_vstack():
+        return np.vstack([specio3.read_spc_matrix(path)[1] for path in files])
+
+    readers = {
+        'read_spc': read_spc_vstack,
+        'read_spc_matrix': read_spc_matrix_vstack,
+    }
+    return [(files, readers[mode])] * ctx['repeat']
+
+
+WORKLOADS = {
+    'small_files': (small_files_ops, ['read_spc', 'read_spc_matrix']),
+    'huge_multifile': (
+        huge_multifile_ops,
+        ['read_spc', 'read_spc_matrix', 'read_spc_matrix_transposed', 'read_trace'],
+    ),
+    'random_subfile': (random_subfile_ops, ['SPCHandle.read', 'open_and_read']),
+    'batch_matrix': (batch_matrix_ops, ['read_spc', 'read_spc_matrix']),
+}
+
+
+# ---------------------------------------------------------------------------
+# Measurement
+# ---------------------------------------------------------------------------
+
+
+def run_case(ctx, workload, mode, cache, warmup):
+    """Run one (workload, mode, cache) case in the current process."""
+    factory, _ = WORKLOADS[workload]
+    ops = factory(ctx, mode)
+    for files, op in ops[:warmup]:
+        op()
+
+    rss_start = current_rss_mb()
+    latencies = []
+    native_peaks = []
+    native_allocations = []
+    bytes_read = 0
+    cpu_start = os.times()
+    wall_start = time.perf_counter()
+    for files, op in ops:
+        if cache == 'cold':
+            for path in files:
+                drop_from_page_cache(path)
+        specio3.reset_allocation_stats()
+        in_use = specio3.allocation_stats('global')['bytes_in_use']
+        start = time.perf_counter()
+        op()
+        latencies.append(time.perf_counter() - start)
+        native = specio3.allocation_stats('global')
+        native_peaks.append(native['peak_bytes'] - in_use)
+        native_allocations.append(native['allocations'])
+        bytes_read += sum(os.path.getsize(p) for p in files)
+    wall = time.perf_counter() - wall_start
+    cpu_end = os.times()
+    cpu = (cpu_end.user - cpu_start.user) + (cpu_end.system - cpu_start.system)
+
+    lat_ms = np.asarray(latencies) * 1000.0
+    busy = float(np.sum(latencies))
+    return {
+        'workload': workload,
+        'mode': mode,
+        'cache': cache,
+        'num_ops': len(latencies),
+        'latency_ms': {
+            'p50': float(np.percentile(lat_ms, 50)),
+            'p95': float(np.percentile(lat_ms, 95)),
+            'p99': float(np.percentile(lat_ms, 99)),
+            'mean': float(lat_ms.mean()),
+            'min': float(lat_ms.min()),
+            'max': float(lat_ms.max()),
+        },
+        'throughput_mb_s': bytes_read / (1024 * 1024) / busy if busy > 0 else float('nan'),
+        'ops_per_s': len(latencies) / busy if busy > 0 else float('nan'),
+        'peak_rss_mb': peak_rss_mb(),
+        'start_rss_mb': rss_start,
+        # Tracked native allocations: high-water mark above the pre-op level, and count per op
+        'native_peak_mb': max(native_peaks) / (1024 * 1024),
+        'native_allocations_per_op': float(np.mean(native_allocations)),
+        # CPU seconds per wall second; above 1.0 means several cores were busy
+        'cpu_utilization': cpu / wall if wall > 0 else float('nan'),
+    }
+
+
+def _case_worker(conn, ctx, workload, mode, cache, warmup):
+    try:
+        conn.send(run_case(ctx, workload, mode, cache, warmup))
+    except Exception as e:  # reported in the parent
+        conn.send({'workload': workload, 'mode': mode, 'cache': cache, 'error': repr(e)})
+    finally:
+        conn.close()
+
+
+def run_isolated(ctx, workload, mode, cache, warmup):
+    """Run one case in a fresh process so peak RSS is not shared between cases."""
+    mp = multiprocessing.get_context('spawn')
+    parent, child = mp.Pipe(duplex=False)
+    proc = mp.Process(target=_case_worker, args=(child, ctx, workload, mode, cache, warmup))
+    proc.start()
+    child.close()
+    result = parent.recv()
+    proc.join()
+    return result
+
+
+def git_commit():
+    try:
+        out = subprocess.run(
+            ['git', 'rev-parse', 'HEAD'], cwd=project_root, capture_output=True, text=True, check=True
+        )
+        return out.stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def metadata():
+    return {
+        'commit': git_commit(),
+        'timestamp': time.strftime('%Y-%m-%dT%H:%M:%S%z'),
+        'python': platform.python_version(),
+        'platform': platform.platform(),
+        'machine': platform.machine(),
+        'cpu_count': os.cpu_count(),
+        'numpy': np.__version__,
+    }
+
+
+def print_results(results):
+    header = (
+        f"{'Workload':<16} {'Mode':<28} {'Cache':<5} {'p50 ms':>9} {'p95 ms':>9} {'p99 ms':>9} "
+        f"{'MB/s':>9} {'RSS MB':>8} {'Heap MB':>8} {'CPU':>5}"
+    )
+    print(header)
+    print('-' * len(header))
+    for r in results:
+        if 'error' in r:
+            print(f"{r['workload']:<16} {r['mode']:<28} {r['cache']:<5} error: {r['error']}")
+            continue
+        lat = r['latency_ms']
+        print(
+            f"{r['workload']:<16} {r['mode']:<28} {r['cache']:<5} {lat['p50']:>9.2f} {lat['p95']:>9.2f} "
+            f"{lat['p99']:>9.2f} {r['throughput_mb_s']:>9.1f} {r['peak_rss_mb']:>8.1f} {r['native_peak_mb']:>8.1f} "
+            f"{r['cpu_utilization']:>5.2f}"
+        )
+
+
+def compare(before_path, after_path):
+    """Print p50/p99, peak RSS and native peak ratios (after / before) for cases present in both files."""
+    with open(before_path) as f:
+        before = json.load(f)
+    with open(after_path) as f:
+        after = json.load(f)
+
+    def key(r):
+        return r['workload'], r['mode'], r['cache']
+
+    old = {key(r): r for r in before['results'] if 'error' not in r}
+    print(f"before: {before['meta'].get('commit')}  after: {after['meta'].get('commit')}")
+    print(f"{'Workload':<16} {'Mode':<28} {'Cache':<5} {'p50':>8} {'p99':>8} {'RSS':>8} {'Heap':>8}")
+    for r in after['results']:
+        if 'error' in r or key(r) not in old:
+            continue
+        o = old[key(r)]
+        p50 = r['latency_ms']['p50'] / o['latency_ms']['p50']
+        p99 = r['latency_ms']['p99'] / o['latency_ms']['p99']
+        rss = r['peak_rss_mb'] / o['peak_rss_mb']
+        heap = r['native_peak_mb'] / o['native_peak_mb'] if o.get('native_peak_mb') else float('nan')
+        print(
+            f"{r['workload']:<16} {r['mode']:<28} {r['cache']:<5} {p50:>7.2f}x {p99:>7.2f}x {rss:>7.2f}x {heap:>7.2f}x"
+        )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--output', '-o', help='write results as JSON to this file')
+    parser.add_argument('--compare', nargs=2, metavar=('BEFORE', 'AFTER'), help='compare two JSON result files')
+    parser.add_argument('--workloads', nargs='+', choices=sorted(WORKLOADS), default=list(WORKLOADS))
+    parser.add_argument('--cache', nargs='+', choices=['warm', 'cold'], default=['warm', 'cold'])
+    parser.add_argument('--repeat', type=int, default=20, help='operations per case for repeated workloads')
+    parser.add_argument('--warmup', type=int, default=2, help='untimed operations before each case')
+    parser.add_argument('--huge-subfiles', type=int, default=5000, help='subfiles in the synthetic multifile')
+    parser.add_argument('--huge-points', type=int, default=4000, help='points per subfile in the synthetic multifile')
+    parser.add_argument('--data-dir', default=str(project_root / 'tests' / 'data'), help='directory of small SPC files')
+    parser.add_argument('--seed', type=int, default=0)
+    args = parser.parse_args()
+
+    if args.compare:
+        compare(*args.compare)
+        return
+
+    caches = list(args.cache)
+    if 'cold' in caches and not hasattr(os, 'posix_fadvise'):
+        print("Cold-cache runs need posix_fadvise; skipping them on this platform")
+        caches.remove('cold')
+
+    small_files = sorted(str(p) for p in Path(args.data_dir).glob('*.spc'))
+    if not small_files:
+        print(f"No SPC files found in {args.data_dir}")
+        return
+    # Batch loading stacks spectra, so it uses the files sharing the most common length
+    lengths = {p: len(specio3.read_spc(p)[0][0]) for p in small_files}
+    common = max(set(lengths.values()), key=list(lengths.values()).count)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        ctx = {
+            'small_files': small_files,
+            'batch_files': [p for p in small_files if lengths[p] == common],
+            'huge_file': os.path.join(tmp, 'huge.spc'),
+            'huge_subfiles': args.huge_subfiles,
+            'repeat': args.repeat,
+            'seed': args.seed,
+        }
+        if {'huge_multifile', 'random_subfile'} & set(args.workloads):
+            print(f"Writing synthetic multifile ({args.huge_subfiles} x {args.huge_points})...")
+            write_synthetic_multifile(ctx['huge_file'], args.huge_subfiles, args.huge_points, args.seed)
+
+        results = []
+        for workload in args.workloads:
+            for mode in WORKLOADS[workload][1]:
+                for cache in caches:
+                    print(f"  {workload} / {mode} / {cache}", flush=True)
+                    results.append(run_isolated(ctx, workload, mode, cache, args.warmup))
+
+    print()
+    print_results(results)
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'meta': metadata(), 'results': results}, f, indent=2)
+        print(f"\nResults written to {args.output}")
+
+
+if __name__ == '__main__':
+    main()
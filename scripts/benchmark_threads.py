@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+Thread scaling benchmark for specio3.read_spc.
+
+Reads the same set of files from 1, 2, 4, ... threads and reports wall time,
+throughput, speedup and parallel efficiency. On a free-threaded interpreter
+(python3.13t and later) the extension declares that it does not need the GIL,
+so the Python-side conversion runs in parallel as well as the decoding:
+
+    python3.13t scripts/benchmark_threads.py
+    python3.13t scripts/benchmark_threads.py --threads 1 2 4 8 16 --output threads.json
+
+On a regular interpreter only the native decode runs without the GIL, which
+bounds the speedup.
+"""
+
+import argparse
+import json
+import os
+import platform
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+# Add the project root to Python path so we can import specio3
+script_dir = Path(__file__).parent
+project_root = script_dir.parent
+sys.path.insert(0, str(project_root))
+
+import specio3  # noqa: E402
+from benchmark_suite import write_synthetic_multifile  # noqa: E402
+
+
+def gil_enabled():
+    """True if the GIL is active (always on interpreters without free threading)."""
+    is_enabled = getattr(sys, '_is_gil_enabled', None)
+    return True if is_enabled is None else is_enabled()
+
+
+def run(paths, num_threads, repeat):
+    """Read every path `repeat` times from `num_threads` threads; return wall seconds."""
+    work = paths * repeat
+    with ThreadPoolExecutor(max_workers=num_threads) as pool:
+        start = time.perf_counter()
+        for _ in pool.map(specio3.read_spc, work):
+            pass
+        return time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--threads', nargs='+', type=int, default=[1, 2, 4, 8])
+    parser.add_argument('--repeat', type=int, default=20, help='passes over the file set per measurement')
+    parser.add_argument('--trials', type=int, default=3, help='measurements per thread count (best is kept)')
+    parser.add_argument('--data-dir', default=str(project_root / 'tests' / 'data'), help='directory of SPC files')
+    parser.add_argument('--synthetic', type=int, default=16,
+                        help='additional synthetic multifiles (64 x 2000 points) to read; 0 to disable')
+    parser.add_argument('--output', '-o', help='write results as JSON to this file')
+    args = parser.parse_args()
+
+    paths = sorted(str(p) for p in Path(args.data_dir).glob('*.spc'))
+    with tempfile.TemporaryDirectory() as tmp:
+        for i in range(args.synthetic):
+            path = os.path.join(tmp, f'synthetic_{i}.spc')
+            write_synthetic_multifile(path, 64, 2000, seed=i)
+            paths.append(path)
+        if not paths:
+            print(f"No SPC files found in {args.data_dir}")
+            return
+        total_bytes = sum(os.path.getsize(p) for p in paths) * args.repeat
+
+        print(f"Python {platform.python_version()} ({'GIL enabled' if gil_enabled() else 'free-threaded'}), "
+              f"{os.cpu_count()} CPUs, {len(paths)} files x {args.repeat} passes")
+        # Warm the page cache and the module
+        run(paths, 1, 1)
+
+        results = []
+        for num_threads in args.threads:
+            seconds = min(run(paths, num_threads, args.repeat) for _ in range(args.trials))
+            results.append({
+                'threads': num_threads,
+                'seconds': seconds,
+                'files_per_s': len(paths) * args.repeat / seconds,
+                'mb_per_s': total_bytes / seconds / 1e6,
+            })
+
+    # Speedup is relative to the first (normally single-threaded) measurement
+    base = results[0]
+    print(f"\n{'Threads':>7}  {'Time (s)':>9}  {'Files/s':>9}  {'MB/s':>8}  {'Speedup':>7}  {'Efficiency':>10}")
+    for r in results:
+        r['speedup'] = base['seconds'] / r['seconds']
+        r['efficiency'] = r['speedup'] * base['threads'] / r['threads']
+        print(f"{r['threads']:>7}  {r['seconds']:>9.3f}  {r['files_per_s']:>9.0f}  {r['mb_per_s']:>8.1f}  "
+              f"{r['speedup']:>6.2f}x  {r['efficiency']:>9.0%}")
+
+    if args.output:
+        meta = {
+            'python': platform.python_version(),
+            'gil_enabled': gil_enabled(),
+            'cpu_count': os.cpu_count(),
+            'platform': platform.platform(),
+        }
+        with open(args.output, 'w') as f:
+            json.dump({'meta': meta, 'results': results}, f, indent=2)
+        print(f"\nResults written to {args.output}")
+
+
+if __name__ == '__main__':
+    main()
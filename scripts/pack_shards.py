@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+Pack a directory tree of SPC files into shard files.
+
+Members are named by their path relative to the input directory, so
+``Shard.read("plate1/a01.spc")`` finds the file that lived at
+``<input>/plate1/a01.spc``. Shards are closed when they reach either limit:
+
+    python scripts/pack_shards.py /data/run42 /data/run42-shards --max-shard-mb 1024
+"""
+
+import argparse
+import os
+import sys
+from pathlib import Path
+
+# Add the project root to Python path so we can import specio3
+script_dir = Path(__file__).parent
+project_root = script_dir.parent
+sys.path.insert(0, str(project_root))
+
+import specio3  # noqa: E402
+
+
+def plan_shards(files, max_members, max_bytes):
+    """Split files (in order) into groups within both limits."""
+    group, size = [], 0
+    for path in files:
+        file_size = path.stat().st_size
+        if group and (len(group) >= max_members or size + file_size > max_bytes):
+            yield group
+            group, size = [], 0
+        group.append(path)
+        size += file_size
+    if group:
+        yield group
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help='directory searched recursively for *.spc files')
+    parser.add_argument('output', help='directory to write shard-NNNNN.spcshard files to')
+    parser.add_argument('--max-members', type=int, default=100000, help='members per shard')
+    parser.add_argument('--max-shard-mb', type=float, default=2048, help='approximate shard size limit in MB')
+    parser.add_argument('--num-threads', type=int, default=0, help='threads for header validation (0 = all cores)')
+    args = parser.parse_args()
+
+    root = Path(args.input)
+    files = sorted(p for p in root.rglob('*') if p.suffix.lower() == '.spc' and p.is_file())
+    if not files:
+        print(f"No SPC files found in {root}")
+        return
+    os.makedirs(args.output, exist_ok=True)
+
+    groups = plan_shards(files, args.max_members, args.max_shard_mb * 1024 * 1024)
+    for n, group in enumerate(groups):
+        output = os.path.join(args.output, f'shard-{n:05d}.spcshard')
+        names = [p.relative_to(root).as_posix() for p in group]
+        shard = specio3.pack_shard(group, output, names=names, num_threads=args.num_threads)
+        print(f"{output}: {len(shard)} members, {os.path.getsize(output) / 1e6:.1f} MB")
+
+
+if __name__ == '__main__':
+    main()
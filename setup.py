@@ -15,7 +15,33 @@ if sys.platform == 'darwin':  # macOS
 ext_modules = [
     Pybind11Extension(
         "specio3._specio3",  # Top-level module
-        ["specio3/spc_reader.cpp", "specio3/bindings.cpp"],
+        [
+            "specio3/spc_reader.cpp",
+            "specio3/bindings.cpp",
+            "specio3/mapped_file.cpp",
+            "specio3/spectral_grid.cpp",
+            "specio3/library_search.cpp",
+            "specio3/pca.cpp",
+            "specio3/ann_index.cpp",
+            "specio3/projection.cpp",
+            "specio3/spc_batch.cpp",
+            "specio3/band_integration.cpp",
+            "specio3/trace.cpp",
+            "specio3/spc_matrix.cpp",
+            "specio3/alloc_tracking.cpp",
+            "specio3/virtual_dataset.cpp",
+            "specio3/zarr_export.cpp",
+            "specio3/shard.cpp",
+            "specio3/multifile_edit.cpp",
+            "specio3/spc_ragged.cpp",
+            "specio3/spc_handle.cpp",
+            "specio3/executor.cpp",
+            "specio3/spc_segment.cpp",
+            "specio3/scan.cpp",
+            "specio3/spc_binning.cpp",
+            "specio3/loader.cpp",
+            "specio3/completion_reader.cpp",
+        ],
         # include_dirs = [pybind11.get_include(), pybind11.get_include(user = True)],
         language = "c++",
         extra_compile_args = extra_compile_args,
@@ -1,10 +1,36 @@
 """SPC spectral file reader with type hints."""
-from typing import List, Tuple
+from typing import List, Optional, Tuple, Union
 import numpy as np
-from numpy.typing import NDArray
+from numpy.typing import ArrayLike, NDArray
 from ._specio3 import read_spc as _read_spc
-
-def read_spc(path: str) -> List[Tuple[NDArray[np.float64], NDArray[np.float64]]]:
+from .library import build_library, SpectralLibrary
+from .ann import build_ann_index, AnnIndex
+from .projection import project_spc
+from .bands import integrate_bands
+from .trace import read_trace
+from .matrix import read_spc_matrix, read_spc_ragged, read_spc_binned
+from .memory import allocation_stats, reset_allocation_stats
+from .spectrum import Spectrum, spectra_from_dict
+from .shard import pack_shard, Shard
+from .dataset import VirtualDataset
+from .export import export_zarr
+from .multifile import merge_spc, extract_subfiles, split_spc
+from .handle import SPCHandle
+from .threads import (set_num_threads, get_num_threads, set_thread_affinity, thread_affinity,
+                      executor_stats, reset_executor_stats)
+from .daemon import DaemonClient
+from .quality import QualityFlag
+from .scan import scan, Scan, ScanResult
+from .loader import Loader
+from .streaming import iter_read
+
+def read_spc(
+    path: str,
+    project: Optional[ArrayLike] = None,
+    offset: Optional[ArrayLike] = None,
+    num_threads: int = 0,
+    check_quality: bool = False,
+) -> Union[List[Spectrum], NDArray[np.float64], Tuple[List[Spectrum], NDArray[np.void]]]:
     """
     Read SPC spectral file and return list of (x,y) arrays.
 
@@ -16,11 +42,30 @@ def read_spc(path: str) -> List[Tuple[NDArray[np.float64], NDArray[np.float64]]]
     ----------
     path : str
         Path to the SPC file to read. Must be a valid file path with read permissions.
+        With ``project``, a sequence of paths is also accepted.
+    project : array_like, shape (num_points, k), optional
+        Loadings of a linear model. When given, the spectra are not returned;
+        each subfile is projected during decoding and only the scores are kept
+        (see :func:`project_spc`).
+    offset : array_like, shape (num_points,), optional
+        Subtracted from each spectrum before projecting, e.g. the PCA mean.
+    num_threads : int, default 0
+        Worker threads used with ``project``; 0 uses every core.
+    check_quality : bool, default False
+        Also check every subfile for NaN/Inf, detector saturation, flat lines
+        and negative values in the same pass that decodes it, instead of
+        separate NumPy passes afterwards.
 
     Returns
     -------
-    List[Tuple[NDArray[np.float64], NDArray[np.float64]]]
+    List[Spectrum]
         List of (x_array, y_array) tuples, where each tuple represents one spectrum.
+        With ``project``, an ``(n_subfiles, k)`` float64 array of scores instead.
+        The tuples are :class:`Spectrum` objects, which pickle their arrays
+        out of band with protocol 5.
+        With ``check_quality``, a ``(spectra, quality)`` pair, where
+        ``quality`` is a structured array with one record per subfile (see
+        :class:`QualityFlag`).
 
         - x_array : 1D numpy array of float64 values representing the X-axis (e.g., wavelength, frequency)
         - y_array : 1D numpy array of float64 values representing the Y-axis (e.g., intensity, absorbance)
@@ -88,41 +133,32 @@ def read_spc(path: str) -> List[Tuple[NDArray[np.float64], NDArray[np.float64]]]
     >>> plt.xlabel('Wavelength (nm)')
     >>> plt.ylabel('Intensity')
     >>> plt.show()
-    """
-    result_dict = _read_spc(path)
-
-    # Validate the result structure
-    if not isinstance(result_dict, dict):
-        raise RuntimeError("Expected a dictionary from the SPC file reader.")
-
-    if 'subfiles' not in result_dict:
-        raise RuntimeError("No subfiles found in the SPC file.")
-
-    subfiles = result_dict['subfiles']
-    if not subfiles:
-        raise RuntimeError("No spectra found in the SPC file.")
 
-    # Convert to list of (x, y) tuples with numpy arrays
-    result = []
-    for i, subfile in enumerate(subfiles):
-        if not isinstance(subfile, dict) or 'x' not in subfile or 'y' not in subfile:
-            raise RuntimeError(f"Spectrum {i}: Expected a dictionary with 'x' and 'y' keys.")
+    Compute PCA scores for a batch of files without materializing the spectra:
 
-        x_data = subfile['x']
-        y_data = subfile['y']
-        
-        # Convert to numpy arrays
-        x_arr = np.array(x_data, dtype=np.float64)
-        y_arr = np.array(y_data, dtype=np.float64)
+    >>> scores = specio3.read_spc(paths, project=pca.components_.T, offset=pca.mean_)
 
-        if len(x_arr) != len(y_arr):
-            raise RuntimeError(f"Spectrum {i}: x and y arrays have different lengths ({len(x_arr)} vs {len(y_arr)}).")
+    Screen spectra while reading them:
 
-        if len(x_arr) == 0:
-            raise RuntimeError(f"Spectrum {i}: Empty spectrum data.")
-
-        result.append((x_arr, y_arr))
-
-    return result
-
-__all__ = ['read_spc']
\ No newline at end of file
+    >>> spectra, quality = specio3.read_spc('run.spc', check_quality=True)
+    >>> usable = [s for s, q in zip(spectra, quality) if not q['flags'] & specio3.QualityFlag.NON_FINITE]
+    """
+    if project is not None:
+        if check_quality:
+            raise ValueError("check_quality cannot be combined with project")
+        return project_spc(path, project, offset, num_threads)
+    if offset is not None:
+        raise ValueError("offset is only used together with project")
+
+    data = _read_spc(path, check_quality)
+    if check_quality:
+        return spectra_from_dict(data), data["quality"]
+    return spectra_from_dict(data)
+
+__all__ = ['read_spc', 'build_library', 'SpectralLibrary', 'build_ann_index', 'AnnIndex', 'project_spc', 'integrate_bands', 'read_trace', 'read_spc_matrix', 'read_spc_ragged', 'read_spc_binned',
+           'allocation_stats', 'reset_allocation_stats', 'Spectrum',
+           'VirtualDataset', 'export_zarr', 'pack_shard', 'Shard',
+           'merge_spc', 'extract_subfiles', 'split_spc', 'SPCHandle',
+           'set_num_threads', 'get_num_threads', 'set_thread_affinity', 'thread_affinity',
+           'executor_stats', 'reset_executor_stats', 'DaemonClient', 'QualityFlag',
+           'scan', 'Scan', 'ScanResult', 'Loader', 'iter_read']
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "alloc_tracking.h"
+
+namespace {
+
+thread_local AllocationCounter* t_read_counter = nullptr;
+thread_local AllocationStats t_last_read_stats;
+
+void update_peak(std::atomic<int64_t>& peak, int64_t value) noexcept {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace
+
+void AllocationCounter::on_allocate(size_t bytes) noexcept {
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+    int64_t in_use = bytes_in_use_.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed) +
+                     static_cast<int64_t>(bytes);
+    update_peak(peak_bytes_, in_use);
+}
+
+void AllocationCounter::on_deallocate(size_t bytes) noexcept {
+    deallocations_.fetch_add(1, std::memory_order_relaxed);
+    bytes_in_use_.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+AllocationStats AllocationCounter::snapshot() const noexcept {
+    AllocationStats s;
+    s.allocations = allocations_.load(std::memory_order_relaxed);
+    s.deallocations = deallocations_.load(std::memory_order_relaxed);
+    s.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+    s.bytes_in_use = bytes_in_use_.load(std::memory_order_relaxed);
+    s.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void AllocationCounter::reset() noexcept {
+    allocations_.store(0, std::memory_order_relaxed);
+    deallocations_.store(0, std::memory_order_relaxed);
+    bytes_allocated_.store(0, std::memory_order_relaxed);
+    // Keep live bytes so the counter stays consistent with outstanding memory
+    peak_bytes_.store(bytes_in_use_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+AllocationCounter& global_allocation_counter() noexcept {
+    static AllocationCounter counter;
+    return counter;
+}
+
+AllocationCounter& thread_allocation_counter() noexcept {
+    thread_local AllocationCounter counter;
+    return counter;
+}
+
+AllocationCounter* current_read_counter() noexcept {
+    return t_read_counter;
+}
+
+ReadCounterBinding::ReadCounterBinding(AllocationCounter* counter) noexcept : previous_(t_read_counter) {
+    t_read_counter = counter;
+}
+
+ReadCounterBinding::~ReadCounterBinding() {
+    t_read_counter = previous_;
+}
+
+ReadAllocationScope::ReadAllocationScope() noexcept : binding_(&counter_) {}
+
+ReadAllocationScope::~ReadAllocationScope() {
+    t_last_read_stats = counter_.snapshot();
+}
+
+AllocationStats last_read_allocation_stats() noexcept {
+    return t_last_read_stats;
+}
+
+void track_allocate(size_t bytes) noexcept {
+    global_allocation_counter().on_allocate(bytes);
+    thread_allocation_counter().on_allocate(bytes);
+    if (t_read_counter != nullptr) {
+        t_read_counter->on_allocate(bytes);
+    }
+}
+
+void track_deallocate(size_t bytes) noexcept {
+    global_allocation_counter().on_deallocate(bytes);
+    thread_allocation_counter().on_deallocate(bytes);
+    if (t_read_counter != nullptr) {
+        t_read_counter->on_deallocate(bytes);
+    }
+}
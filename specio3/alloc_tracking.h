@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+/**
+ * Snapshot of allocation counters. bytes_in_use is signed because memory
+ * may be released under a different counter than it was allocated under
+ * (e.g. a read's result array freed later by Python).
+ */
+struct AllocationStats {
+    uint64_t allocations = 0;      ///< Number of allocations
+    uint64_t deallocations = 0;    ///< Number of deallocations
+    uint64_t bytes_allocated = 0;  ///< Total bytes ever allocated
+    int64_t bytes_in_use = 0;      ///< Bytes allocated minus bytes freed
+    int64_t peak_bytes = 0;        ///< High-water mark of bytes_in_use
+};
+
+/**
+ * Thread-safe set of allocation counters.
+ */
+class AllocationCounter {
+public:
+    void on_allocate(size_t bytes) noexcept;
+    void on_deallocate(size_t bytes) noexcept;
+    AllocationStats snapshot() const noexcept;
+    void reset() noexcept;
+
+private:
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> deallocations_{0};
+    std::atomic<uint64_t> bytes_allocated_{0};
+    std::atomic<int64_t> bytes_in_use_{0};
+    std::atomic<int64_t> peak_bytes_{0};
+};
+
+/// Counters over every tracked allocation in the process.
+AllocationCounter& global_allocation_counter() noexcept;
+
+/// Counters over tracked allocations made on the calling thread.
+AllocationCounter& thread_allocation_counter() noexcept;
+
+/// Counter of the read the calling thread is working for, or nullptr.
+AllocationCounter* current_read_counter() noexcept;
+
+/**
+ * Attribute the calling thread's allocations to a read's counter for the
+ * lifetime of this object. Worker threads use it to join the read that
+ * spawned them.
+ */
+class ReadCounterBinding {
+public:
+    explicit ReadCounterBinding(AllocationCounter* counter) noexcept;
+    ~ReadCounterBinding();
+    ReadCounterBinding(const ReadCounterBinding&) = delete;
+    ReadCounterBinding& operator=(const ReadCounterBinding&) = delete;
+
+private:
+    AllocationCounter* previous_;
+};
+
+/**
+ * Track the allocations of one read, across every thread that works on it.
+ * On destruction the result becomes last_read_allocation_stats() of the
+ * calling thread.
+ */
+class ReadAllocationScope {
+public:
+    ReadAllocationScope() noexcept;
+    ~ReadAllocationScope();
+    ReadAllocationScope(const ReadAllocationScope&) = delete;
+    ReadAllocationScope& operator=(const ReadAllocationScope&) = delete;
+
+    AllocationStats stats() const noexcept { return counter_.snapshot(); }
+
+private:
+    AllocationCounter counter_;
+    ReadCounterBinding binding_;
+};
+
+/// Counters of the last ReadAllocationScope that ended on the calling thread.
+AllocationStats last_read_allocation_stats() noexcept;
+
+/// Record an allocation or deallocation in the global, thread and read counters.
+void track_allocate(size_t bytes) noexcept;
+void track_deallocate(size_t bytes) noexcept;
+
+/**
+ * Standard allocator that reports every allocation to the tracking counters.
+ * Used for the buffers of the read pipeline so transient and peak memory of
+ * a read can be measured.
+ */
+template <typename T>
+struct TrackedAllocator {
+    using value_type = T;
+
+    TrackedAllocator() noexcept = default;
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        track_allocate(n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        track_deallocate(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const TrackedAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const TrackedAllocator<U>&) const noexcept { return false; }
+};
+
+template <typename T>
+using tracked_vector = std::vector<T, TrackedAllocator<T>>;
@@ -0,0 +1,157 @@
+"""Approximate nearest-neighbour search over large spectral archives."""
+import os
+from typing import Sequence, Tuple
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+from .library import PathLike, Query, _prepare_queries
+
+
+def build_ann_index(
+    paths: Sequence[PathLike],
+    output: PathLike,
+    x_min: float,
+    x_max: float,
+    num_points: int,
+    metric: str = "cosine",
+    pca_components: int = 0,
+    pca_sample_size: int = 20000,
+    max_neighbors: int = 16,
+    ef_construction: int = 200,
+    seed: int = 42,
+    num_threads: int = 0,
+) -> "AnnIndex":
+    """
+    Build an HNSW nearest-neighbour index from SPC files and open it.
+
+    Every subfile of every input is resampled onto the grid (as in
+    :func:`build_library`) and normalized for ``metric``. With
+    ``pca_components > 0`` a PCA is first fitted on an evenly strided sample
+    of the inputs and every spectrum is projected onto it, which shrinks the
+    index and speeds up queries at some cost in recall.
+
+    Parameters
+    ----------
+    paths : sequence of str or PathLike
+        SPC files to index.
+    output : str or PathLike
+        Index file to write. An existing file is overwritten.
+    x_min, x_max : float
+        First and last grid X values.
+    num_points : int
+        Number of grid points.
+    metric : {"cosine", "pearson"}, default "cosine"
+        Similarity the index approximates.
+    pca_components : int, default 0
+        Dimensions to keep after PCA; 0 disables the reduction.
+    pca_sample_size : int, default 20000
+        Maximum number of spectra used to fit the PCA.
+    max_neighbors : int, default 16
+        HNSW ``M``. Larger values improve recall and grow the index.
+    ef_construction : int, default 200
+        Candidate list size during construction.
+    seed : int, default 42
+        Seed for layer assignment and PCA initialisation.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    AnnIndex
+        The newly written index, memory-mapped.
+
+    Raises
+    ------
+    RuntimeError
+        If an input file cannot be read, the parameters are invalid or the
+        output cannot be written.
+    """
+    _specio3.build_ann_index(
+        [os.fspath(p) for p in paths],
+        os.fspath(output),
+        float(x_min),
+        float(x_max),
+        int(num_points),
+        metric,
+        int(pca_components),
+        int(pca_sample_size),
+        int(max_neighbors),
+        int(ef_construction),
+        int(seed),
+        int(num_threads),
+    )
+    return AnnIndex(output)
+
+
+class AnnIndex:
+    """
+    Memory-mapped HNSW index built by :func:`build_ann_index`.
+
+    Examples
+    --------
+    >>> index = specio3.build_ann_index(paths, "archive.spcann", 400.0, 4000.0, 1024,
+    ...                                 pca_components=64)
+    >>> indices, scores = index.search("measurement.spc", k=10, ef=100)
+    >>> index.entry(indices[0, 0])
+    ('archive/2023/run_0412.spc', 3)
+    """
+
+    def __init__(self, path: PathLike):
+        self._index = _specio3.AnnIndex(os.fspath(path))
+
+    def __len__(self) -> int:
+        return len(self._index)
+
+    @property
+    def metric(self) -> str:
+        """Similarity metric the index approximates."""
+        return self._index.metric
+
+    @property
+    def pca_components(self) -> int:
+        """Number of PCA dimensions, or 0 if spectra are indexed on the full grid."""
+        return self._index.pca_components
+
+    @property
+    def grid(self) -> NDArray[np.float64]:
+        """X values of the index grid."""
+        return np.linspace(self._index.x_min, self._index.x_max, self._index.num_points)
+
+    def entry(self, index: int) -> Tuple[str, int]:
+        """Return the ``(source_path, subfile_index)`` of entry ``index``."""
+        index = int(index)
+        return self._index.name(index), self._index.subfile_index(index)
+
+    def search(
+        self, query: Query, k: int = 10, ef: int = 64, num_threads: int = 0
+    ) -> Tuple[NDArray[np.int64], NDArray[np.float32]]:
+        """
+        Find approximately the ``k`` most similar entries for each query.
+
+        Parameters
+        ----------
+        query : str, PathLike, (x, y) tuple or ndarray
+            A path searches with every subfile of that SPC file. An ``(x, y)``
+            tuple is resampled onto the index grid. A 1-D or 2-D array is
+            taken to be already on the grid (``len(grid)`` columns).
+        k : int, default 10
+            Number of hits per query.
+        ef : int, default 64
+            Search breadth; raise it for better recall at higher latency.
+        num_threads : int, default 0
+            Worker threads for batches of queries; 0 uses every core.
+
+        Returns
+        -------
+        indices : ndarray of int64, shape (n_queries, k)
+            Entries ordered from most to least similar.
+        scores : ndarray of float32, shape (n_queries, k)
+            Similarity of each hit in the (possibly reduced) index space.
+        """
+        queries = _prepare_queries(self._index, query)
+        return self._index.search(queries, int(k), int(ef), int(num_threads))
+
+
+__all__ = ["build_ann_index", "AnnIndex"]
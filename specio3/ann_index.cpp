@@ -0,0 +1,604 @@
+#include "ann_index.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+static constexpr char kAnnMagic[8] = {'S', 'P', 'C', 'A', 'N', 'N', '\0', '\0'};
+static constexpr uint32_t kAnnVersion = 1;
+static constexpr uint64_t kSectionAlignment = 64;
+static constexpr size_t kLockStripes = 1 << 16;
+static constexpr int kMaxGraphLevel = 31;
+
+using Neighbor = std::pair<float, uint32_t>;  // (distance, node)
+
+static uint64_t align_up(uint64_t v) {
+    return (v + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+}
+
+// Vectors are unit length, so 1 - dot is a monotone stand-in for cosine distance.
+static float distance(const float* a, const float* b, uint32_t dim) {
+    return 1.0f - dot_f32(a, b, dim);
+}
+
+/**
+ * Per-search visited marks. Epoch tags make clearing O(1) between searches.
+ */
+class VisitedList {
+public:
+    explicit VisitedList(size_t n) : tags_(n, 0) {}
+
+    void next_search() {
+        if (++epoch_ == 0) {
+            std::fill(tags_.begin(), tags_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    /// Mark a node; returns false if it was already visited in this search.
+    bool visit(uint32_t node) {
+        if (tags_[node] == epoch_) {
+            return false;
+        }
+        tags_[node] = epoch_;
+        return true;
+    }
+
+private:
+    std::vector<uint16_t> tags_;
+    uint16_t epoch_ = 0;
+};
+
+/**
+ * Recycles VisitedLists between searches so each query does not allocate
+ * (and zero) an array the size of the index.
+ */
+class VisitedListPool {
+public:
+    explicit VisitedListPool(size_t n) : n_(n) {}
+
+    std::unique_ptr<VisitedList> acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            return std::make_unique<VisitedList>(n_);
+        }
+        auto list = std::move(free_.back());
+        free_.pop_back();
+        return list;
+    }
+
+    void release(std::unique_ptr<VisitedList> list) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(std::move(list));
+    }
+
+private:
+    size_t n_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<VisitedList>> free_;
+};
+
+// Greedy walk on one layer: move to the closest neighbour until no neighbour improves.
+template <typename Neighbors>
+static uint32_t greedy_closest(const float* query, const float* vectors, uint32_t dim, uint32_t entry,
+                               float* entry_dist, int level, Neighbors& neighbors) {
+    std::vector<uint32_t> nbrs;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        neighbors(entry, level, nbrs);
+        for (uint32_t e : nbrs) {
+            const float d = distance(query, vectors + static_cast<size_t>(e) * dim, dim);
+            if (d < *entry_dist) {
+                *entry_dist = d;
+                entry = e;
+                changed = true;
+            }
+        }
+    }
+    return entry;
+}
+
+// Best-first beam search on one layer. Fills out with up to ef nodes, closest first.
+template <typename Neighbors>
+static void search_layer(const float* query, const float* vectors, uint32_t dim, uint32_t entry,
+                         float entry_dist, size_t ef, int level, Neighbors& neighbors, VisitedList& visited,
+                         std::vector<Neighbor>& out) {
+    visited.next_search();
+    std::priority_queue<Neighbor> top;  // worst result on top
+    std::priority_queue<Neighbor, std::vector<Neighbor>, std::greater<Neighbor>> candidates;
+    top.emplace(entry_dist, entry);
+    candidates.emplace(entry_dist, entry);
+    visited.visit(entry);
+
+    std::vector<uint32_t> nbrs;
+    while (!candidates.empty()) {
+        const Neighbor current = candidates.top();
+        if (current.first > top.top().first && top.size() >= ef) {
+            break;
+        }
+        candidates.pop();
+        neighbors(current.second, level, nbrs);
+        for (uint32_t e : nbrs) {
+            if (!visited.visit(e)) {
+                continue;
+            }
+            const float d = distance(query, vectors + static_cast<size_t>(e) * dim, dim);
+            if (top.size() < ef || d < top.top().first) {
+                candidates.emplace(d, e);
+                top.emplace(d, e);
+                if (top.size() > ef) {
+                    top.pop();
+                }
+            }
+        }
+    }
+
+    out.resize(top.size());
+    for (size_t i = out.size(); i-- > 0;) {
+        out[i] = top.top();
+        top.pop();
+    }
+}
+
+// HNSW neighbour-selection heuristic: keep a candidate only if it is closer
+// to the base node than to every neighbour already kept. Candidates must be
+// sorted by ascending distance.
+static void select_neighbors(const std::vector<Neighbor>& candidates, size_t m, const float* vectors,
+                             uint32_t dim, std::vector<uint32_t>& out) {
+    out.clear();
+    for (const Neighbor& c : candidates) {
+        if (out.size() >= m) {
+            break;
+        }
+        const float* cv = vectors + static_cast<size_t>(c.second) * dim;
+        bool keep = true;
+        for (uint32_t r : out) {
+            if (distance(cv, vectors + static_cast<size_t>(r) * dim, dim) < c.first) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            out.push_back(c.second);
+        }
+    }
+}
+
+/**
+ * In-memory HNSW graph under construction. Link storage uses the same layout
+ * as the file format so it can be written out verbatim.
+ */
+class HnswBuilder {
+public:
+    HnswBuilder(const std::vector<float>& vectors, size_t n, uint32_t dim, uint32_t m,
+                uint32_t ef_construction, uint64_t seed)
+        : vectors_(vectors), n_(n), dim_(dim), m_(m), ef_construction_(ef_construction),
+          locks_(kLockStripes), visited_(n) {
+        levels_.resize(n);
+        upper_index_.assign(n, 0);
+        const double mult = 1.0 / std::log(static_cast<double>(std::max<uint32_t>(m, 2)));
+        for (size_t i = 0; i < n; ++i) {
+            // splitmix64 of (seed, i): the layer of a node does not depend on insertion order.
+            uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (i + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            z ^= z >> 31;
+            const double u = (static_cast<double>(z >> 11) + 1.0) / 9007199254740992.0;
+            const int level = std::min(kMaxGraphLevel, static_cast<int>(-std::log(u) * mult));
+            levels_[i] = static_cast<uint8_t>(level);
+            if (level > 0) {
+                upper_index_[i] = pool_.size();
+                pool_.resize(pool_.size() + static_cast<size_t>(level) * (1 + m));
+            }
+        }
+        level0_.assign(n * level0_stride(), 0);
+    }
+
+    void build(size_t num_threads) {
+        if (n_ == 0) {
+            return;
+        }
+        entry_point_ = 0;
+        max_level_ = levels_[0];
+        parallel_for(n_ - 1, num_threads, [&](size_t i) { insert(static_cast<uint32_t>(i + 1)); });
+    }
+
+    size_t level0_stride() const { return 1 + 2 * static_cast<size_t>(m_); }
+    uint32_t entry_point() const { return entry_point_; }
+    int max_level() const { return max_level_; }
+    const std::vector<uint32_t>& level0() const { return level0_; }
+    const std::vector<uint8_t>& levels() const { return levels_; }
+    const std::vector<uint64_t>& upper_index() const { return upper_index_; }
+    const std::vector<uint32_t>& pool() const { return pool_; }
+
+private:
+    uint32_t* links(uint32_t node, int level) {
+        if (level == 0) {
+            return level0_.data() + node * level0_stride();
+        }
+        return pool_.data() + upper_index_[node] + static_cast<size_t>(level - 1) * (1 + m_);
+    }
+
+    size_t capacity(int level) const { return level == 0 ? 2 * static_cast<size_t>(m_) : m_; }
+    std::mutex& lock_for(uint32_t node) { return locks_[node % kLockStripes]; }
+    const float* vec(uint32_t node) const { return vectors_.data() + static_cast<size_t>(node) * dim_; }
+
+    void read_links(uint32_t node, int level, std::vector<uint32_t>& out) {
+        std::lock_guard<std::mutex> lock(lock_for(node));
+        const uint32_t* l = links(node, level);
+        out.assign(l + 1, l + 1 + l[0]);
+    }
+
+    void insert(uint32_t q) {
+        const int level = levels_[q];
+        std::unique_lock<std::mutex> global(global_mutex_);
+        uint32_t entry = entry_point_;
+        const int top = max_level_;
+        // Only a node that raises the graph's top layer keeps the global lock.
+        if (level <= top) {
+            global.unlock();
+        }
+
+        auto neighbors = [this](uint32_t node, int l, std::vector<uint32_t>& out) { read_links(node, l, out); };
+        const float* qv = vec(q);
+        float entry_dist = distance(qv, vec(entry), dim_);
+        for (int l = top; l > level; --l) {
+            entry = greedy_closest(qv, vectors_.data(), dim_, entry, &entry_dist, l, neighbors);
+        }
+
+        auto visited = visited_.acquire();
+        std::vector<Neighbor> found;
+        std::vector<uint32_t> selected;
+        for (int l = std::min(level, top); l >= 0; --l) {
+            search_layer(qv, vectors_.data(), dim_, entry, entry_dist, ef_construction_, l, neighbors,
+                         *visited, found);
+            select_neighbors(found, m_, vectors_.data(), dim_, selected);
+            {
+                std::lock_guard<std::mutex> lock(lock_for(q));
+                uint32_t* ql = links(q, l);
+                ql[0] = static_cast<uint32_t>(selected.size());
+                std::copy(selected.begin(), selected.end(), ql + 1);
+            }
+            for (uint32_t e : selected) {
+                add_link(e, q, l);
+            }
+            entry = found.front().second;
+            entry_dist = found.front().first;
+        }
+        visited_.release(std::move(visited));
+
+        if (level > top) {
+            entry_point_ = q;
+            max_level_ = level;
+        }
+    }
+
+    // Add a back link e -> q, shrinking e's list with the heuristic when full.
+    void add_link(uint32_t e, uint32_t q, int level) {
+        std::lock_guard<std::mutex> lock(lock_for(e));
+        uint32_t* el = links(e, level);
+        const size_t cap = capacity(level);
+        if (el[0] < cap) {
+            el[1 + el[0]] = q;
+            ++el[0];
+            return;
+        }
+        std::vector<Neighbor> candidates;
+        candidates.reserve(cap + 1);
+        const float* ev = vec(e);
+        for (uint32_t i = 0; i < el[0]; ++i) {
+            candidates.emplace_back(distance(ev, vec(el[1 + i]), dim_), el[1 + i]);
+        }
+        candidates.emplace_back(distance(ev, vec(q), dim_), q);
+        std::sort(candidates.begin(), candidates.end());
+        std::vector<uint32_t> kept;
+        select_neighbors(candidates, cap, vectors_.data(), dim_, kept);
+        el[0] = static_cast<uint32_t>(kept.size());
+        std::copy(kept.begin(), kept.end(), el + 1);
+    }
+
+    const std::vector<float>& vectors_;
+    size_t n_;
+    uint32_t dim_;
+    uint32_t m_;
+    uint32_t ef_construction_;
+    std::vector<uint8_t> levels_;
+    std::vector<uint64_t> upper_index_;
+    std::vector<uint32_t> pool_;
+    std::vector<uint32_t> level0_;
+    std::vector<std::mutex> locks_;
+    std::mutex global_mutex_;
+    uint32_t entry_point_ = 0;
+    int max_level_ = 0;
+    VisitedListPool visited_;
+};
+
+// Reduce a normalized on-grid vector to the index space and rescale to unit length.
+static void to_index_space(const PCAModel* pca, const float* in, uint32_t num_points, float* out) {
+    if (pca == nullptr) {
+        std::copy(in, in + num_points, out);
+        return;
+    }
+    pca->project(in, out);
+    normalize_spectrum(out, pca->num_components, SimilarityMetric::Cosine);
+}
+
+template <typename T>
+static void write_section(std::ofstream& out, uint64_t offset, const T* data, size_t count) {
+    std::streamoff pos = out.tellp();
+    if (static_cast<uint64_t>(pos) < offset) {
+        std::vector<char> pad(static_cast<size_t>(offset - static_cast<uint64_t>(pos)), 0);
+        out.write(pad.data(), static_cast<std::streamsize>(pad.size()));
+    }
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+uint64_t build_ann_index(const std::vector<std::string>& paths, const AnnBuildOptions& options,
+                         const std::string& output_path) {
+    validate_grid(options.grid);
+    if (options.max_neighbors < 2) {
+        throw std::runtime_error("max_neighbors must be at least 2");
+    }
+    if (options.pca_components > options.grid.num_points) {
+        throw std::runtime_error("pca_components cannot exceed the number of grid points");
+    }
+    const uint32_t num_points = options.grid.num_points;
+
+    // Pass 1 (optional): fit the projection on an evenly strided sample of files.
+    std::unique_ptr<PCAModel> pca;
+    if (options.pca_components > 0) {
+        const size_t stride = std::max<size_t>(1, paths.size() / std::max<size_t>(1, options.pca_sample_size));
+        std::vector<std::string> sample_paths;
+        for (size_t i = 0; i < paths.size(); i += stride) {
+            sample_paths.push_back(paths[i]);
+        }
+        std::vector<float> sample;
+        stream_resampled_spectra(sample_paths, options.grid, options.metric, options.num_threads,
+                                 [&](const std::string&, const float* rows, size_t num_rows) {
+            const size_t room = options.pca_sample_size - sample.size() / num_points;
+            const size_t take = std::min(room, num_rows);
+            sample.insert(sample.end(), rows, rows + take * num_points);
+        });
+        const size_t num_samples = sample.size() / num_points;
+        if (num_samples < options.pca_components) {
+            throw std::runtime_error("Not enough spectra (" + std::to_string(num_samples) + ") to fit " +
+                                     std::to_string(options.pca_components) + " PCA components");
+        }
+        pca = std::make_unique<PCAModel>(fit_pca(sample.data(), num_samples, num_points,
+                                                 options.pca_components, options.seed, options.num_threads));
+    }
+    const uint32_t dim = pca ? options.pca_components : num_points;
+
+    // Pass 2: stream every spectrum into index space.
+    std::vector<float> vectors;
+    std::vector<LibraryEntryRaw> entries;
+    std::string names;
+    std::vector<float> reduced(dim);
+    stream_resampled_spectra(paths, options.grid, options.metric, options.num_threads,
+                             [&](const std::string& path, const float* rows, size_t num_rows) {
+        for (size_t r = 0; r < num_rows; ++r) {
+            to_index_space(pca.get(), rows + r * num_points, num_points, reduced.data());
+            vectors.insert(vectors.end(), reduced.begin(), reduced.end());
+            LibraryEntryRaw e = {};
+            e.name_offset = names.size();
+            e.name_length = static_cast<uint32_t>(path.size());
+            e.subfile_index = static_cast<uint32_t>(r);
+            entries.push_back(e);
+        }
+        names += path;
+    });
+    const size_t n = entries.size();
+    if (n > UINT32_MAX) {
+        throw std::runtime_error("Too many spectra for one index (limit is 2^32 - 1)");
+    }
+
+    HnswBuilder graph(vectors, n, dim, options.max_neighbors, options.ef_construction, options.seed);
+    graph.build(options.num_threads);
+
+    AnnFileHeader header = {};
+    std::memcpy(header.magic, kAnnMagic, sizeof(kAnnMagic));
+    header.version = kAnnVersion;
+    header.metric = static_cast<uint32_t>(options.metric);
+    header.num_entries = n;
+    header.num_points = num_points;
+    header.dim = dim;
+    header.x_min = options.grid.x_min;
+    header.x_max = options.grid.x_max;
+    header.max_neighbors = options.max_neighbors;
+    header.max_level = static_cast<uint32_t>(graph.max_level());
+    header.entry_point = graph.entry_point();
+    header.pca_components = pca ? options.pca_components : 0;
+    header.pool_size = graph.pool().size();
+
+    uint64_t offset = align_up(sizeof(AnnFileHeader));
+    header.pca_offset = offset;
+    if (pca) {
+        offset = align_up(offset + (pca->mean.size() + pca->components.size()) * sizeof(float));
+    }
+    header.vectors_offset = offset;
+    offset = align_up(offset + vectors.size() * sizeof(float));
+    header.level0_offset = offset;
+    offset = align_up(offset + graph.level0().size() * sizeof(uint32_t));
+    header.levels_offset = offset;
+    offset = align_up(offset + n);
+    header.upper_index_offset = offset;
+    offset = align_up(offset + n * sizeof(uint64_t));
+    header.pool_offset = offset;
+    offset = align_up(offset + graph.pool().size() * sizeof(uint32_t));
+    header.entries_offset = offset;
+    header.names_offset = offset + n * sizeof(LibraryEntryRaw);
+    header.names_size = names.size();
+
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Unable to create index file: " + output_path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (pca) {
+        write_section(out, header.pca_offset, pca->mean.data(), pca->mean.size());
+        write_section(out, header.pca_offset + pca->mean.size() * sizeof(float), pca->components.data(),
+                      pca->components.size());
+    }
+    write_section(out, header.vectors_offset, vectors.data(), vectors.size());
+    write_section(out, header.level0_offset, graph.level0().data(), graph.level0().size());
+    write_section(out, header.levels_offset, graph.levels().data(), graph.levels().size());
+    write_section(out, header.upper_index_offset, graph.upper_index().data(), graph.upper_index().size());
+    write_section(out, header.pool_offset, graph.pool().data(), graph.pool().size());
+    write_section(out, header.entries_offset, entries.data(), entries.size());
+    write_section(out, header.names_offset, names.data(), names.size());
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Failed writing index file: " + output_path);
+    }
+    return n;
+}
+
+AnnIndex::AnnIndex(const std::string& path) : file_(path) {
+    if (file_.size() < sizeof(AnnFileHeader)) {
+        throw std::runtime_error("Not a spectral ANN index (file too small): " + path);
+    }
+    header_ = reinterpret_cast<const AnnFileHeader*>(file_.data());
+    if (std::memcmp(header_->magic, kAnnMagic, sizeof(kAnnMagic)) != 0) {
+        throw std::runtime_error("Not a spectral ANN index (bad magic): " + path);
+    }
+    if (header_->version != kAnnVersion) {
+        throw std::runtime_error("Unsupported spectral ANN index version " + std::to_string(header_->version) +
+                                 ": " + path);
+    }
+
+    grid_.x_min = header_->x_min;
+    grid_.x_max = header_->x_max;
+    grid_.num_points = header_->num_points;
+    validate_grid(grid_);
+
+    const uint64_t n = header_->num_entries;
+    const uint64_t dim = header_->dim;
+    const uint64_t m = header_->max_neighbors;
+    auto fits = [&](uint64_t off, uint64_t bytes) { return off % 8 == 0 && off + bytes <= file_.size(); };
+    const bool valid =
+        header_->metric <= static_cast<uint32_t>(SimilarityMetric::Pearson) && dim > 0 && m >= 2 &&
+        (header_->pca_components == 0 ? dim == grid_.num_points : dim == header_->pca_components) &&
+        (n == 0 || header_->entry_point < n) && header_->max_level <= static_cast<uint32_t>(kMaxGraphLevel) &&
+        fits(header_->pca_offset, header_->pca_components == 0 ? 0 : (grid_.num_points + dim * grid_.num_points) * 4) &&
+        fits(header_->vectors_offset, n * dim * 4) && fits(header_->level0_offset, n * (1 + 2 * m) * 4) &&
+        fits(header_->levels_offset, n) && fits(header_->upper_index_offset, n * 8) &&
+        fits(header_->pool_offset, header_->pool_size * 4) && fits(header_->entries_offset, n * sizeof(LibraryEntryRaw)) &&
+        header_->names_offset + header_->names_size <= file_.size();
+    if (!valid) {
+        throw std::runtime_error("Spectral ANN index is truncated or corrupt: " + path);
+    }
+
+    if (header_->pca_components > 0) {
+        const float* p = reinterpret_cast<const float*>(file_.data() + header_->pca_offset);
+        pca_.input_dim = grid_.num_points;
+        pca_.num_components = header_->pca_components;
+        pca_.mean.assign(p, p + grid_.num_points);
+        pca_.components.assign(p + grid_.num_points, p + grid_.num_points + dim * grid_.num_points);
+    }
+    vectors_ = reinterpret_cast<const float*>(file_.data() + header_->vectors_offset);
+    level0_ = reinterpret_cast<const uint32_t*>(file_.data() + header_->level0_offset);
+    levels_ = reinterpret_cast<const uint8_t*>(file_.data() + header_->levels_offset);
+    upper_index_ = reinterpret_cast<const uint64_t*>(file_.data() + header_->upper_index_offset);
+    pool_ = reinterpret_cast<const uint32_t*>(file_.data() + header_->pool_offset);
+    entries_ = reinterpret_cast<const LibraryEntryRaw*>(file_.data() + header_->entries_offset);
+    names_ = file_.data() + header_->names_offset;
+    visited_ = std::make_unique<VisitedListPool>(static_cast<size_t>(n));
+}
+
+AnnIndex::~AnnIndex() = default;
+
+std::string AnnIndex::name(size_t i) const {
+    if (i >= size()) {
+        throw std::out_of_range("Index entry out of range: " + std::to_string(i));
+    }
+    const LibraryEntryRaw& e = entries_[i];
+    if (e.name_offset + e.name_length > header_->names_size) {
+        throw std::runtime_error("Spectral ANN index entry " + std::to_string(i) + " has an invalid name");
+    }
+    return std::string(names_ + e.name_offset, e.name_length);
+}
+
+uint32_t AnnIndex::subfile_index(size_t i) const {
+    if (i >= size()) {
+        throw std::out_of_range("Index entry out of range: " + std::to_string(i));
+    }
+    return entries_[i].subfile_index;
+}
+
+SearchResult AnnIndex::search(const float* queries, size_t num_queries, size_t k, size_t ef,
+                              size_t num_threads) const {
+    const size_t n = size();
+    const uint32_t dim = header_->dim;
+    const uint32_t m = header_->max_neighbors;
+    const size_t pool_size = header_->pool_size;
+
+    SearchResult result;
+    result.num_queries = num_queries;
+    result.k = std::min(k, n);
+    if (num_queries == 0 || result.k == 0) {
+        result.k = 0;
+        return result;
+    }
+    k = result.k;
+    ef = std::max(ef, k);
+    result.indices.resize(num_queries * k);
+    result.scores.resize(num_queries * k);
+
+    // Links come straight from the mapping; ids are range-checked instead of
+    // validating the whole graph when the file is opened.
+    auto neighbors = [&](uint32_t node, int level, std::vector<uint32_t>& out) {
+        out.clear();
+        if (level > levels_[node]) {
+            return;
+        }
+        const uint32_t* l;
+        if (level == 0) {
+            l = level0_ + static_cast<size_t>(node) * (1 + 2 * static_cast<size_t>(m));
+        } else {
+            const uint64_t off = upper_index_[node] + static_cast<uint64_t>(level - 1) * (1 + m);
+            if (off + 1 + m > pool_size) {
+                return;
+            }
+            l = pool_ + off;
+        }
+        const uint32_t count = std::min<uint32_t>(l[0], level == 0 ? 2 * m : m);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (l[1 + i] < n) {
+                out.push_back(l[1 + i]);
+            }
+        }
+    };
+
+    const PCAModel* pca = header_->pca_components > 0 ? &pca_ : nullptr;
+    parallel_for(num_queries, num_threads, [&](size_t qi) {
+        std::vector<float> normalized(queries + qi * grid_.num_points, queries + (qi + 1) * grid_.num_points);
+        normalize_spectrum(normalized.data(), normalized.size(), metric());
+        std::vector<float> query(dim);
+        to_index_space(pca, normalized.data(), grid_.num_points, query.data());
+
+        uint32_t entry = header_->entry_point;
+        float entry_dist = distance(query.data(), vectors_ + static_cast<size_t>(entry) * dim, dim);
+        for (int l = static_cast<int>(header_->max_level); l > 0; --l) {
+            entry = greedy_closest(query.data(), vectors_, dim, entry, &entry_dist, l, neighbors);
+        }
+
+        auto visited = visited_->acquire();
+        std::vector<Neighbor> found;
+        search_layer(query.data(), vectors_, dim, entry, entry_dist, ef, 0, neighbors, *visited, found);
+        visited_->release(std::move(visited));
+
+        for (size_t j = 0; j < k; ++j) {
+            const bool have = j < found.size();
+            result.indices[qi * k + j] = have ? static_cast<int64_t>(found[j].second) : -1;
+            result.scores[qi * k + j] = have ? 1.0f - found[j].first : 0.0f;
+        }
+    });
+    return result;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "library_search.h"
+#include "mapped_file.h"
+#include "pca.h"
+#include "spectral_grid.h"
+
+/**
+ * On-disk header of an approximate nearest-neighbour index (.spcann).
+ *
+ * The index is an HNSW graph (Malkov & Yashunin, 2018) over normalized,
+ * optionally PCA-reduced spectra. Sections follow the header, each 64-byte
+ * aligned:
+ * - PCA mean (num_points floats) and components (dim x num_points floats), if pca_components > 0
+ * - vectors: num_entries x dim float32, unit length
+ * - level 0 links: num_entries x (1 + 2*max_neighbors) uint32 (count, then ids)
+ * - levels: num_entries uint8, the top layer of each node
+ * - upper index: num_entries uint64, offset into the link pool (in uint32 units)
+ * - link pool: for each node with level L > 0, L blocks of (1 + max_neighbors) uint32
+ * - entries and names, as in LibraryFileHeader
+ * All integers are little-endian.
+ */
+struct AnnFileHeader {
+    char magic[8];              ///< "SPCANN\0\0"
+    uint32_t version;           ///< Format version (currently 1)
+    uint32_t metric;            ///< SimilarityMetric applied before projection
+    uint64_t num_entries;       ///< Number of indexed spectra
+    uint32_t num_points;        ///< Grid length
+    uint32_t dim;               ///< Indexed vector length (num_points or pca_components)
+    double x_min;               ///< First grid X value
+    double x_max;               ///< Last grid X value
+    uint32_t max_neighbors;     ///< HNSW M: links per node on upper layers (2*M on layer 0)
+    uint32_t max_level;         ///< Top layer of the graph
+    uint32_t entry_point;       ///< Node search starts from
+    uint32_t pca_components;    ///< 0 when vectors are not reduced
+    uint64_t pca_offset;
+    uint64_t vectors_offset;
+    uint64_t level0_offset;
+    uint64_t levels_offset;
+    uint64_t upper_index_offset;
+    uint64_t pool_offset;
+    uint64_t pool_size;         ///< Link pool length in uint32 units
+    uint64_t entries_offset;
+    uint64_t names_offset;
+    uint64_t names_size;
+    char reserved[16];
+};
+static_assert(sizeof(AnnFileHeader) == 160, "AnnFileHeader must be 160 bytes");
+
+class VisitedListPool;
+
+/**
+ * Parameters for build_ann_index().
+ */
+struct AnnBuildOptions {
+    SpectralGrid grid;                                  ///< Common X grid
+    SimilarityMetric metric = SimilarityMetric::Cosine; ///< Normalization before indexing
+    uint32_t pca_components = 0;     ///< Reduce to this many dimensions (0 = no reduction)
+    size_t pca_sample_size = 20000;  ///< Spectra used to fit the PCA
+    uint32_t max_neighbors = 16;     ///< HNSW M
+    uint32_t ef_construction = 200;  ///< Candidate list size while building
+    uint64_t seed = 42;              ///< Seed for layer assignment and PCA
+    size_t num_threads = 0;          ///< Worker threads (0 = all cores)
+};
+
+/**
+ * Build an HNSW index from SPC files and write it to disk.
+ * Spectra are streamed through the reader twice when PCA is enabled (once
+ * over an evenly strided sample of files to fit the projection, once over
+ * everything) and once otherwise. Graph construction is parallel, with
+ * striped locks guarding each node's link lists.
+ *
+ * @param paths SPC files to index; every subfile becomes one entry
+ * @param options Build parameters
+ * @param output_path Index file to write
+ * @return Number of indexed spectra
+ * @throws std::runtime_error if an input cannot be read, the options are
+ *         invalid or the output cannot be written
+ */
+uint64_t build_ann_index(const std::vector<std::string>& paths, const AnnBuildOptions& options,
+                         const std::string& output_path);
+
+/**
+ * Read-only, memory-mapped HNSW index written by build_ann_index().
+ * Searching is thread-safe; concurrent queries share the mapping.
+ */
+class AnnIndex {
+public:
+    /**
+     * Map an index file.
+     *
+     * @param path Index file path
+     * @throws std::runtime_error if the file is missing, truncated or not an index
+     */
+    explicit AnnIndex(const std::string& path);
+    ~AnnIndex();
+
+    AnnIndex(const AnnIndex&) = delete;
+    AnnIndex& operator=(const AnnIndex&) = delete;
+
+    size_t size() const { return static_cast<size_t>(header_->num_entries); }
+    uint32_t num_points() const { return grid_.num_points; }
+    uint32_t dim() const { return header_->dim; }
+    uint32_t pca_components() const { return header_->pca_components; }
+    const SpectralGrid& grid() const { return grid_; }
+    SimilarityMetric metric() const { return static_cast<SimilarityMetric>(header_->metric); }
+
+    /// Source path of entry i.
+    std::string name(size_t i) const;
+
+    /// Subfile index of entry i within its source path.
+    uint32_t subfile_index(size_t i) const;
+
+    /// Resample every subfile of an SPC file onto the index grid (not normalized).
+    std::vector<float> resample_file(const std::string& path) const { return resample_spc_file(path, grid_); }
+
+    /**
+     * Approximate k nearest neighbours for each query.
+     * Queries must be on the index grid; they are normalized and projected
+     * internally. Queries are spread across threads.
+     *
+     * @param queries Row-major (num_queries x num_points) matrix
+     * @param num_queries Number of queries
+     * @param k Hits per query (clamped to the index size)
+     * @param ef Search candidate list size; larger is slower and more accurate (raised to k if smaller)
+     * @param num_threads Worker threads (0 = all cores)
+     * @return Top-k indices and similarities (1 - distance)
+     */
+    SearchResult search(const float* queries, size_t num_queries, size_t k, size_t ef,
+                        size_t num_threads) const;
+
+private:
+    MappedFile file_;
+    const AnnFileHeader* header_ = nullptr;
+    SpectralGrid grid_;
+    PCAModel pca_;
+    const float* vectors_ = nullptr;
+    const uint32_t* level0_ = nullptr;
+    const uint8_t* levels_ = nullptr;
+    const uint64_t* upper_index_ = nullptr;
+    const uint32_t* pool_ = nullptr;
+    const LibraryEntryRaw* entries_ = nullptr;
+    const char* names_ = nullptr;
+    std::unique_ptr<VisitedListPool> visited_;
+};
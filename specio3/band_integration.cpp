@@ -0,0 +1,233 @@
+#include "band_integration.h"
+#include "spc_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Subfiles of one multifile handled by a single task.
+constexpr uint32_t kSubfilesPerTask = 64;
+
+// Points [begin, end) of one band.
+struct IndexRange {
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// First index in [0, n) for which pred is false; pred must be true up to some index, then false.
+template <typename Pred>
+size_t partition_index(size_t n, Pred pred) {
+    size_t lo = 0;
+    size_t hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (pred(mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// As partition_index, walking from a guess that is already close to the answer.
+template <typename Pred>
+size_t partition_index_near(size_t n, size_t guess, Pred pred) {
+    guess = std::min(guess, n);
+    while (guess > 0 && !pred(guess - 1)) {
+        --guess;
+    }
+    while (guess < n && pred(guess)) {
+        ++guess;
+    }
+    return guess;
+}
+
+// Band ranges on the stored, monotonic X axis shared by the subfiles of an XY file.
+std::vector<IndexRange> stored_band_ranges(const tracked_vector<double>& x, const std::vector<Band>& bands) {
+    const size_t n = x.size();
+    const bool ascending = x.back() >= x.front();
+    std::vector<IndexRange> ranges(bands.size());
+    for (size_t b = 0; b < bands.size(); ++b) {
+        const double lo = std::min(bands[b].x_lo, bands[b].x_hi);
+        const double hi = std::max(bands[b].x_lo, bands[b].x_hi);
+        IndexRange& r = ranges[b];
+        if (ascending) {
+            r.begin = partition_index(n, [&](size_t i) { return x[i] < lo; });
+            r.end = partition_index(n, [&](size_t i) { return x[i] <= hi; });
+        } else {
+            r.begin = partition_index(n, [&](size_t i) { return x[i] > hi; });
+            r.end = partition_index(n, [&](size_t i) { return x[i] >= lo; });
+        }
+        r.end = std::max(r.end, r.begin);
+    }
+    return ranges;
+}
+
+// Band ranges of a Y-only file, computed from the affine X axis and corrected
+// against the exact generated values so the edges match read_spc_impl().
+std::vector<IndexRange> generated_band_ranges(const SPCLayout& layout, const std::vector<Band>& bands) {
+    const size_t n = layout.num_points;
+    const bool ascending = layout.last_x >= layout.first_x;
+    const double step = n > 1 ? (layout.last_x - layout.first_x) / static_cast<double>(n - 1) : 0.0;
+    auto guess = [&](double value) -> size_t {
+        if (step == 0.0) {
+            return 0;
+        }
+        double g = std::ceil((value - layout.first_x) / step);
+        if (!(g > 0)) {
+            return 0;
+        }
+        return g >= static_cast<double>(n) ? n : static_cast<size_t>(g);
+    };
+    auto x = [&](size_t i) { return layout.generated_x(static_cast<uint32_t>(i)); };
+
+    std::vector<IndexRange> ranges(bands.size());
+    for (size_t b = 0; b < bands.size(); ++b) {
+        const double lo = std::min(bands[b].x_lo, bands[b].x_hi);
+        const double hi = std::max(bands[b].x_lo, bands[b].x_hi);
+        IndexRange& r = ranges[b];
+        if (ascending) {
+            r.begin = partition_index_near(n, guess(lo), [&](size_t i) { return x(i) < lo; });
+            r.end = partition_index_near(n, guess(hi), [&](size_t i) { return x(i) <= hi; });
+        } else {
+            r.begin = partition_index_near(n, guess(hi), [&](size_t i) { return x(i) > hi; });
+            r.end = partition_index_near(n, guess(lo), [&](size_t i) { return x(i) >= lo; });
+        }
+        r.end = std::max(r.end, r.begin);
+    }
+    return ranges;
+}
+
+// Smallest range covering every non-empty band.
+IndexRange band_span(const std::vector<IndexRange>& ranges) {
+    IndexRange span{std::numeric_limits<size_t>::max(), 0};
+    for (const IndexRange& r : ranges) {
+        if (r.begin < r.end) {
+            span.begin = std::min(span.begin, r.begin);
+            span.end = std::max(span.end, r.end);
+        }
+    }
+    if (span.end == 0) {
+        span.begin = 0;
+    }
+    return span;
+}
+
+// Area and height of every band for one subfile; y holds the points of span.
+void integrate_subfile(const std::vector<IndexRange>& ranges, const IndexRange& span,
+                       const tracked_vector<double>& x, const tracked_vector<double>& y, double* areas,
+                       double* heights) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t b = 0; b < ranges.size(); ++b) {
+        const IndexRange& r = ranges[b];
+        if (r.begin >= r.end) {
+            areas[b] = nan;
+            heights[b] = nan;
+            continue;
+        }
+        const double* yb = y.data() + (r.begin - span.begin);
+        const size_t count = r.end - r.begin;
+        double height = yb[0];
+        double area = 0.0;
+        for (size_t i = 1; i < count; ++i) {
+            height = std::max(height, yb[i]);
+            area += 0.5 * (yb[i - 1] + yb[i]) * std::fabs(x[r.begin + i] - x[r.begin + i - 1]);
+        }
+        areas[b] = area;
+        heights[b] = height;
+    }
+}
+
+// Area and height of every band for one XYXY subfile, whose X may be unsorted
+// or non-finite. The points inside each band are found with a linear scan and
+// integrated in ascending X order; NaN X never falls inside a band.
+void integrate_scattered(const std::vector<Band>& bands, const tracked_vector<double>& x,
+                         const tracked_vector<double>& y, std::vector<std::pair<double, double>>& points,
+                         double* areas, double* heights) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t b = 0; b < bands.size(); ++b) {
+        const double lo = std::min(bands[b].x_lo, bands[b].x_hi);
+        const double hi = std::max(bands[b].x_lo, bands[b].x_hi);
+        points.clear();
+        for (size_t i = 0; i < x.size(); ++i) {
+            if (x[i] >= lo && x[i] <= hi) {
+                points.emplace_back(x[i], y[i]);
+            }
+        }
+        if (points.empty()) {
+            areas[b] = nan;
+            heights[b] = nan;
+            continue;
+        }
+        std::stable_sort(points.begin(), points.end(),
+                         [](const auto& a, const auto& c) { return a.first < c.first; });
+        double height = points[0].second;
+        double area = 0.0;
+        for (size_t i = 1; i < points.size(); ++i) {
+            height = std::max(height, points[i].second);
+            area += 0.5 * (points[i - 1].second + points[i].second) * (points[i].first - points[i - 1].first);
+        }
+        areas[b] = area;
+        heights[b] = height;
+    }
+}
+
+}  // namespace
+
+BandTable integrate_bands(const std::vector<std::string>& paths, const std::vector<Band>& bands,
+                          size_t num_threads) {
+    if (bands.empty()) {
+        throw std::runtime_error("At least one band is required");
+    }
+
+    SPCBatch batch = read_spc_batch(paths, num_threads);
+    BandTable table;
+    table.num_spectra = batch.num_rows();
+    table.num_bands = bands.size();
+    table.areas.resize(table.num_spectra * table.num_bands);
+    table.heights.resize(table.num_spectra * table.num_bands);
+
+    for_each_subfile_chunk(batch, kSubfilesPerTask, num_threads,
+                           [&](std::ifstream& f, size_t file, uint32_t first_subfile, uint32_t end_subfile) {
+        const SPCLayout& layout = batch.layouts[file];
+        tracked_vector<double> x;
+        tracked_vector<double> y;
+        tracked_vector<char> raw;
+        std::vector<IndexRange> ranges;
+        std::vector<std::pair<double, double>> points;
+
+        // Y-only and XY files share one X axis, so the band ranges are found once
+        if (!layout.is_xyxy) {
+            x.resize(layout.num_points);
+            read_subfile_x(f, layout, layout.subfiles[first_subfile], x.data());
+            ranges = layout.is_xy ? stored_band_ranges(x, bands) : generated_band_ranges(layout, bands);
+        }
+
+        for (uint32_t s = first_subfile; s < end_subfile; ++s) {
+            const SubfileLayout& sub = layout.subfiles[s];
+            const size_t row = (batch.first_row[file] + s) * table.num_bands;
+            if (layout.is_xyxy) {
+                x.resize(sub.num_points);
+                y.resize(sub.num_points);
+                read_subfile_x(f, layout, sub, x.data());
+                if (!y.empty()) {
+                    read_subfile_y(f, layout, sub, 0, y.size(), raw, y.data());
+                }
+                integrate_scattered(bands, x, y, points, table.areas.data() + row, table.heights.data() + row);
+                continue;
+            }
+            const IndexRange span = band_span(ranges);
+            y.resize(span.end - span.begin);
+            if (!y.empty()) {
+                read_subfile_y(f, layout, sub, span.begin, y.size(), raw, y.data());
+            }
+            integrate_subfile(ranges, span, x, y, table.areas.data() + row, table.heights.data() + row);
+        }
+    });
+    return table;
+}
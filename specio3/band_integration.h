@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "alloc_tracking.h"
+
+/**
+ * An X window [x_lo, x_hi]; the bounds may be given in either order.
+ */
+struct Band {
+    double x_lo = 0;
+    double x_hi = 0;
+};
+
+/**
+ * Band areas and peak heights for a batch of spectra, stored row-major
+ * (num_spectra x num_bands), one row per subfile in file then subfile order.
+ */
+struct BandTable {
+    size_t num_spectra = 0;
+    size_t num_bands = 0;
+    tracked_vector<double> areas;    ///< Trapezoidal area over the points inside each band
+    tracked_vector<double> heights;  ///< Largest Y inside each band
+};
+
+/**
+ * Integrate fixed X windows over every subfile of a batch of SPC files.
+ *
+ * Each band is mapped to the range of points whose X lies inside it (an
+ * affine computation for Y-only files, a binary search over the shared X axis
+ * of XY files) and only the Y values spanned by the bands are read and
+ * decoded. XYXY peak lists may be unsorted or hold non-finite X, so their
+ * points are found with a linear scan and integrated in ascending X order.
+ * Areas use |dx|, so they do not depend on the direction of the X axis.
+ * A band containing no points yields NaN for both area and height.
+ *
+ * @param paths SPC files
+ * @param bands X windows
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Area and height tables
+ * @throws std::runtime_error if a file cannot be read
+ */
+BandTable integrate_bands(const std::vector<std::string>& paths, const std::vector<Band>& bands,
+                          size_t num_threads);
@@ -2,6 +2,27 @@
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 #include "spc_reader.h"
+#include "library_search.h"
+#include "ann_index.h"
+#include "projection.h"
+#include "band_integration.h"
+#include "trace.h"
+#include "spc_matrix.h"
+#include "spc_ragged.h"
+#include "spc_binning.h"
+#include "spc_handle.h"
+#include "spc_segment.h"
+#include "scan.h"
+#include "virtual_dataset.h"
+#include "loader.h"
+#include "completion_reader.h"
+#include "zarr_export.h"
+#include "shard.h"
+#include "multifile_edit.h"
+#include "alloc_tracking.h"
+#include "executor.h"
+
+#include <cmath>
 
 // Windows compatibility: MSVC doesn't have ssize_t
 #ifdef _WIN32
@@ -11,18 +32,666 @@ typedef SSIZE_T ssize_t;
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(_specio3, m) {
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+/**
+ * Hand a vector's buffer to NumPy without copying.
+ * The vector is moved to the heap and freed when the array is collected.
+ */
+template <typename T, typename Alloc>
+static py::array_t<T> vector_to_array(std::vector<T, Alloc>&& values, std::vector<py::ssize_t> shape) {
+    using Vector = std::vector<T, Alloc>;
+    auto* owned = new Vector(std::move(values));
+    py::capsule free_when_done(owned, [](void* p) { delete static_cast<Vector*>(p); });
+    return py::array_t<T>(shape, owned->data(), free_when_done);
+}
+
+/**
+ * Hand a pooled buffer to NumPy without copying.
+ * The buffer goes back to its pool when the array is collected.
+ */
+static py::array_t<float> pooled_to_array(const std::shared_ptr<FloatBufferPool>& pool,
+                                          tracked_vector<float>&& values, std::vector<py::ssize_t> shape) {
+    struct Pooled {
+        std::shared_ptr<FloatBufferPool> pool;
+        tracked_vector<float> values;
+    };
+    auto* owned = new Pooled{pool, std::move(values)};
+    py::capsule release_when_done(owned, [](void* p) {
+        auto* pooled = static_cast<Pooled*>(p);
+        pooled->pool->release(std::move(pooled->values));
+        delete pooled;
+    });
+    return py::array_t<float>(shape, owned->values.data(), release_when_done);
+}
+
+/**
+ * Resample one (x, y) spectrum onto a search grid.
+ */
+static py::array_t<float> resample_to_array(const SpectralGrid& grid, const DoubleArray& x, const DoubleArray& y) {
+    if (x.ndim() != 1 || y.ndim() != 1 || x.size() != y.size() || x.size() == 0) {
+        throw std::runtime_error("x and y must be non-empty 1-D arrays of equal length");
+    }
+    std::vector<float> out(grid.num_points);
+    resample_to_grid(x.data(), y.data(), static_cast<size_t>(x.size()), grid, out.data());
+    return vector_to_array(std::move(out), {static_cast<py::ssize_t>(grid.num_points)});
+}
+
+/**
+ * Resample every subfile of an SPC file onto a search grid as a 2-D array.
+ */
+template <typename Index>
+static py::array_t<float> resample_file_to_array(const Index& index, const std::string& path) {
+    std::vector<float> rows;
+    {
+        py::gil_scoped_release release;
+        rows = index.resample_file(path);
+    }
+    const auto num_rows = static_cast<py::ssize_t>(rows.size() / index.num_points());
+    return vector_to_array(std::move(rows), {num_rows, static_cast<py::ssize_t>(index.num_points())});
+}
+
+/**
+ * Check that a query matrix has one column per grid point.
+ */
+static void check_queries(const FloatArray& queries, uint32_t num_points) {
+    if (queries.ndim() != 2 || queries.shape(1) != static_cast<py::ssize_t>(num_points)) {
+        throw std::runtime_error("queries must be a 2-D array with " + std::to_string(num_points) + " columns");
+    }
+}
+
+/**
+ * Convert top-k results to an (indices, scores) tuple of arrays.
+ */
+static py::tuple search_result_to_tuple(SearchResult&& result) {
+    std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(result.num_queries),
+                                      static_cast<py::ssize_t>(result.k)};
+    return py::make_tuple(vector_to_array(std::move(result.indices), shape),
+                          vector_to_array(std::move(result.scores), shape));
+}
+
+// Every binding works on its own arguments, on read-only native objects
+// (SpectralLibrary, AnnIndex, VirtualDataset, SPCHandle, SPCShard) or on
+// objects that lock their own state (BatchLoader, CompletionReader, the
+// executor); shared counters are atomic. The module therefore does not need
+// the GIL on free-threaded (3.13t) interpreters.
+PYBIND11_MODULE(_specio3, m, py::mod_gil_not_used()) {
     m.doc() = "SPC file reader with corrected subheader and exponent handling";
 
-    m.def("read_spc", [](const std::string& filename) {
+    // Quality records are returned as structured arrays, one record per subfile
+    PYBIND11_NUMPY_DTYPE(SubfileQuality, flags, nan_count, inf_count, negative_count, saturated_count, saturated_run,
+                         y_min, y_max);
+
+    m.def("read_spc", [](const std::string& filename, bool check_quality) {
+        ReadAllocationScope allocation_scope;
         SPCFile spc;
         try {
-            spc = read_spc_impl(filename);
+            py::gil_scoped_release release;
+            spc = read_spc_impl(filename, check_quality);
         } catch (const std::exception& e) {
             std::ostringstream msg;
             msg << "Error in read_spc_impl: " << e.what();
             throw std::runtime_error(msg.str());
         }
-        return to_pydict(spc);
-    }, py::arg("filename"), "Read an SPC file and return its contents as a Python dict");
+        py::dict d = to_pydict(spc);
+        if (check_quality) {
+            const auto n = static_cast<py::ssize_t>(spc.quality.size());
+            d["quality"] = vector_to_array(std::move(spc.quality), {n});
+        }
+        return d;
+    }, py::arg("filename"), py::arg("check_quality") = false,
+       "Read an SPC file and return its contents as a Python dict (with per-subfile 'quality' records if requested)");
+
+    m.def("project_spc", [](const std::vector<std::string>& paths, const DoubleArray& loadings,
+                            const py::object& offset, size_t num_threads) {
+        if (loadings.ndim() != 2) {
+            throw std::runtime_error("loadings must be a 2-D (num_points, k) array");
+        }
+        ReadAllocationScope allocation_scope;
+        LinearProjection model;
+        model.loadings = loadings.data();
+        model.num_points = static_cast<uint32_t>(loadings.shape(0));
+        model.num_outputs = static_cast<uint32_t>(loadings.shape(1));
+        DoubleArray offset_array;
+        if (!offset.is_none()) {
+            offset_array = offset.cast<DoubleArray>();
+            if (offset_array.ndim() != 1 || offset_array.shape(0) != loadings.shape(0)) {
+                throw std::runtime_error("offset must be a 1-D array with one value per loadings row");
+            }
+            model.offset = offset_array.data();
+        }
+        tracked_vector<double> scores;
+        {
+            py::gil_scoped_release release;
+            scores = project_spc_files(paths, model, num_threads);
+        }
+        const auto num_rows = static_cast<py::ssize_t>(scores.size() / model.num_outputs);
+        return vector_to_array(std::move(scores), {num_rows, static_cast<py::ssize_t>(model.num_outputs)});
+    }, py::arg("paths"), py::arg("loadings"), py::arg("offset") = py::none(), py::arg("num_threads") = 0,
+       "Project every subfile of SPC files onto (num_points, k) loadings during decode; returns (n_subfiles, k)");
+
+    m.def("integrate_bands", [](const std::vector<std::string>& paths,
+                                const std::vector<std::pair<double, double>>& windows, size_t num_threads) {
+        ReadAllocationScope allocation_scope;
+        std::vector<Band> bands;
+        bands.reserve(windows.size());
+        for (const auto& w : windows) {
+            bands.push_back({w.first, w.second});
+        }
+        BandTable table;
+        {
+            py::gil_scoped_release release;
+            table = integrate_bands(paths, bands, num_threads);
+        }
+        std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(table.num_spectra),
+                                          static_cast<py::ssize_t>(table.num_bands)};
+        return py::make_tuple(vector_to_array(std::move(table.areas), shape),
+                              vector_to_array(std::move(table.heights), shape));
+    }, py::arg("paths"), py::arg("bands"), py::arg("num_threads") = 0,
+       "Trapezoidal area and peak height of X windows for every subfile; returns (areas, heights)");
+
+    m.def("read_trace", [](const std::string& path, const std::vector<double>& x_positions, size_t num_threads) {
+        ReadAllocationScope allocation_scope;
+        SpectralTrace trace;
+        {
+            py::gil_scoped_release release;
+            trace = read_trace(path, x_positions, num_threads);
+        }
+        const auto num_subfiles = static_cast<py::ssize_t>(trace.num_subfiles);
+        return py::make_tuple(
+            vector_to_array(std::move(trace.values), {num_subfiles, static_cast<py::ssize_t>(trace.num_positions)}),
+            vector_to_array(std::move(trace.z), {num_subfiles}));
+    }, py::arg("path"), py::arg("x_positions"), py::arg("num_threads") = 0,
+       "Y at the points nearest the given X values for every subfile; returns (values, z)");
+
+    m.def("read_spc_matrix", [](const std::string& path, bool transposed, size_t num_threads, bool check_quality) {
+        ReadAllocationScope allocation_scope;
+        SpectraMatrix matrix;
+        {
+            py::gil_scoped_release release;
+            matrix = read_spc_matrix(path, transposed, num_threads, check_quality);
+        }
+        const auto num_subfiles = static_cast<py::ssize_t>(matrix.num_subfiles);
+        auto rows = num_subfiles;
+        auto cols = static_cast<py::ssize_t>(matrix.num_points);
+        if (matrix.transposed) {
+            std::swap(rows, cols);
+        }
+        py::tuple result = py::make_tuple(
+            vector_to_array(std::move(matrix.x), {static_cast<py::ssize_t>(matrix.num_points)}),
+            vector_to_array(std::move(matrix.values), {rows, cols}),
+            vector_to_array(std::move(matrix.z), {num_subfiles}));
+        if (check_quality) {
+            return py::make_tuple(result[0], result[1], result[2],
+                                  vector_to_array(std::move(matrix.quality), {num_subfiles}));
+        }
+        return result;
+    }, py::arg("path"), py::arg("transposed") = false, py::arg("num_threads") = 0, py::arg("check_quality") = false,
+       "Decode all subfiles into one matrix, optionally (points x subfiles); returns (x, values, z[, quality])");
+
+    m.def("read_spc_ragged", [](const std::string& path, size_t num_threads) {
+        ReadAllocationScope allocation_scope;
+        RaggedSpectra ragged;
+        {
+            py::gil_scoped_release release;
+            ragged = read_spc_ragged(path, num_threads);
+        }
+        const auto total = static_cast<py::ssize_t>(ragged.x.size());
+        const auto num_subfiles = static_cast<py::ssize_t>(ragged.num_subfiles);
+        return py::make_tuple(vector_to_array(std::move(ragged.x), {total}),
+                              vector_to_array(std::move(ragged.y), {total}),
+                              vector_to_array(std::move(ragged.offsets), {num_subfiles + 1}),
+                              vector_to_array(std::move(ragged.z), {num_subfiles}));
+    }, py::arg("path"), py::arg("num_threads") = 0,
+       "Decode all subfiles into concatenated x and y arrays; returns (x, y, offsets, z)");
+
+    m.def("read_spc_binned", [](const std::string& path, const std::vector<double>& edges, double width, double lo,
+                                double hi, size_t num_threads) {
+        ReadAllocationScope allocation_scope;
+        BinnedSpectra binned;
+        {
+            py::gil_scoped_release release;
+            binned = edges.empty() ? read_spc_binned(path, width, lo, hi, num_threads)
+                                   : read_spc_binned(path, edges, num_threads);
+        }
+        const auto num_subfiles = static_cast<py::ssize_t>(binned.num_subfiles);
+        const auto num_bins = static_cast<py::ssize_t>(binned.num_bins);
+        return py::make_tuple(vector_to_array(std::move(binned.values), {num_subfiles, num_bins}),
+                              vector_to_array(std::move(binned.edges), {num_bins + 1}),
+                              vector_to_array(std::move(binned.z), {num_subfiles}));
+    }, py::arg("path"), py::arg("edges"), py::arg("width") = 0.0, py::arg("lo") = std::nan(""),
+       py::arg("hi") = std::nan(""), py::arg("num_threads") = 0,
+       "Sum every subfile's Y values into X bins, given edges or a width; returns (values, edges, z)");
+
+    m.def("scan_collect", [](const std::vector<std::string>& paths, double z_min, double z_max, double x_min,
+                             double x_max, size_t max_points, bool float32, size_t num_threads) {
+        ReadAllocationScope allocation_scope;
+        const ScanPlan plan{z_min, z_max, x_min, x_max, max_points};
+        auto to_tuple = [](auto scanned) {
+            const auto total = static_cast<py::ssize_t>(scanned.x.size());
+            const auto num_rows = static_cast<py::ssize_t>(scanned.num_rows);
+            return py::make_tuple(vector_to_array(std::move(scanned.x), {total}),
+                                  vector_to_array(std::move(scanned.y), {total}),
+                                  vector_to_array(std::move(scanned.offsets), {num_rows + 1}),
+                                  vector_to_array(std::move(scanned.z), {num_rows}),
+                                  vector_to_array(std::move(scanned.source), {num_rows, py::ssize_t{2}}));
+        };
+        if (float32) {
+            ScannedSpectra<float> scanned;
+            {
+                py::gil_scoped_release release;
+                scanned = scan_collect<float>(paths, plan, num_threads);
+            }
+            return to_tuple(std::move(scanned));
+        }
+        ScannedSpectra<double> scanned;
+        {
+            py::gil_scoped_release release;
+            scanned = scan_collect<double>(paths, plan, num_threads);
+        }
+        return to_tuple(std::move(scanned));
+    }, py::arg("paths"), py::arg("z_min"), py::arg("z_max"), py::arg("x_min"), py::arg("x_max"),
+       py::arg("max_points") = 0, py::arg("float32") = false, py::arg("num_threads") = 0,
+       "Decode the selected points of the selected subfiles of files; returns (x, y, offsets, z, source)");
+
+    m.def("scan_stats", [](const std::vector<std::string>& paths, double z_min, double z_max, double x_min,
+                           double x_max, size_t max_points, size_t num_threads) {
+        ReadAllocationScope allocation_scope;
+        const ScanPlan plan{z_min, z_max, x_min, x_max, max_points};
+        ScanStats stats;
+        {
+            py::gil_scoped_release release;
+            stats = scan_stats(paths, plan, num_threads);
+        }
+        const auto num_rows = static_cast<py::ssize_t>(stats.num_rows);
+        py::dict d;
+        d["count"] = vector_to_array(std::move(stats.count), {num_rows});
+        d["min"] = vector_to_array(std::move(stats.min), {num_rows});
+        d["max"] = vector_to_array(std::move(stats.max), {num_rows});
+        d["mean"] = vector_to_array(std::move(stats.mean), {num_rows});
+        d["std"] = vector_to_array(std::move(stats.std), {num_rows});
+        d["z"] = vector_to_array(std::move(stats.z), {num_rows});
+        d["source"] = vector_to_array(std::move(stats.source), {num_rows, py::ssize_t{2}});
+        return d;
+    }, py::arg("paths"), py::arg("z_min"), py::arg("z_max"), py::arg("x_min"), py::arg("x_max"),
+       py::arg("max_points") = 0, py::arg("num_threads") = 0,
+       "Count, min, max, mean and std of the selected points of the selected subfiles of files");
+
+    // Every method only reads the handle's mapping, so Python threads can
+    // share one SPCHandle and decode from it in parallel with the GIL released.
+    py::class_<SPCHandle>(m, "SPCHandle")
+        .def(py::init<const std::string&>(), py::arg("path"), py::call_guard<py::gil_scoped_release>())
+        .def("__len__", &SPCHandle::size)
+        .def_property_readonly("path", &SPCHandle::path)
+        .def("num_points", &SPCHandle::num_points, py::arg("subfile"))
+        .def_property_readonly("z", [](const SPCHandle& handle) {
+            tracked_vector<double> z(handle.size());
+            for (size_t s = 0; s < z.size(); ++s) {
+                z[s] = handle.layout().subfiles[s].z_start;
+            }
+            const auto n = static_cast<py::ssize_t>(z.size());
+            return vector_to_array(std::move(z), {n});
+        })
+        .def("read", [](const SPCHandle& handle, uint32_t subfile) {
+            ReadAllocationScope allocation_scope;
+            Subfile sub;
+            {
+                py::gil_scoped_release release;
+                sub = handle.read_subfile(subfile);
+            }
+            const auto n = static_cast<py::ssize_t>(sub.x.size());
+            return py::make_tuple(vector_to_array(std::move(sub.x), {n}), vector_to_array(std::move(sub.y), {n}));
+        }, py::arg("subfile"), "Decode one subfile; returns (x, y)")
+        .def("read_y", [](const SPCHandle& handle, uint32_t subfile, size_t first, size_t count) {
+            // Validated before the output is allocated, so a bad count raises instead of exhausting memory
+            handle.check_point_range(subfile, first, count);
+            ReadAllocationScope allocation_scope;
+            tracked_vector<double> y(count);
+            {
+                py::gil_scoped_release release;
+                handle.read_y(subfile, first, count, y.data());
+            }
+            return vector_to_array(std::move(y), {static_cast<py::ssize_t>(count)});
+        }, py::arg("subfile"), py::arg("first"), py::arg("count"),
+           "Decode Y values [first, first + count) of one subfile");
+
+    m.def("decode_to_segment", [](const SPCHandle& handle, uint32_t first, uint32_t count, double x_min,
+                                  double x_max, size_t step, size_t num_threads) {
+        PointSelection selection;
+        selection.x_min = x_min;
+        selection.x_max = x_max;
+        selection.step = step;
+        SpectraSegment segment;
+        {
+            py::gil_scoped_release release;
+            segment = decode_to_segment(handle, first, count, selection, num_threads);
+        }
+        py::dict d;
+        d["fd"] = segment.fd;
+        d["num_subfiles"] = segment.num_subfiles;
+        d["num_values"] = segment.num_values;
+        d["size"] = segment.size;
+        return d;
+    }, py::arg("handle"), py::arg("first"), py::arg("count"), py::arg("x_min"), py::arg("x_max"),
+       py::arg("step") = 1, py::arg("num_threads") = 0,
+       "Decode subfiles into a sealed shared-memory file; returns its fd (owned by the caller) and layout");
+
+    py::class_<VirtualDataset>(m, "VirtualDataset")
+        .def(py::init<const std::vector<std::string>&, size_t>(), py::arg("paths"), py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("__len__", &VirtualDataset::num_rows)
+        .def_property_readonly("num_points", &VirtualDataset::num_points)
+        .def_property_readonly("x", [](const VirtualDataset& ds) {
+            tracked_vector<double> x = ds.x();
+            const auto n = static_cast<py::ssize_t>(x.size());
+            return vector_to_array(std::move(x), {n});
+        })
+        .def("location", [](const VirtualDataset& ds, size_t row) {
+            auto [file, subfile] = ds.locate(row);
+            return py::make_tuple(ds.path(file), subfile);
+        }, py::arg("row"), "(path, subfile_index) of a row")
+        .def("read", [](const VirtualDataset& ds, const std::vector<size_t>& rows, size_t first_point, size_t count,
+                        size_t num_threads) {
+            ReadAllocationScope allocation_scope;
+            tracked_vector<double> values;
+            {
+                py::gil_scoped_release release;
+                values = ds.read_block(rows, first_point, count, num_threads);
+            }
+            return vector_to_array(std::move(values), {static_cast<py::ssize_t>(rows.size()),
+                                                       static_cast<py::ssize_t>(count)});
+        }, py::arg("rows"), py::arg("first_point"), py::arg("count"), py::arg("num_threads") = 0,
+           "Decode points [first_point, first_point + count) of the given rows; returns (len(rows), count)");
+
+    m.def("export_zarr", [](const std::vector<std::string>& paths, const std::string& output, int zarr_format,
+                            size_t chunk_rows, size_t chunk_points, size_t num_threads) {
+        ZarrExportOptions options;
+        options.zarr_format = zarr_format;
+        options.chunk_rows = chunk_rows;
+        options.chunk_points = chunk_points;
+        options.num_threads = num_threads;
+        ReadAllocationScope allocation_scope;
+        py::gil_scoped_release release;
+        return export_zarr(paths, output, options);
+    }, py::arg("paths"), py::arg("output"), py::arg("zarr_format") = 2, py::arg("chunk_rows") = 1024,
+       py::arg("chunk_points") = 0, py::arg("num_threads") = 0,
+       "Write SPC files as an uncompressed Zarr directory store with y, x and z arrays; returns the spectrum count");
+
+    m.def("pack_shard", [](const std::vector<std::string>& paths, const std::vector<std::string>& names,
+                           const std::string& output, size_t num_threads) {
+        py::gil_scoped_release release;
+        return pack_shard(paths, names, output, num_threads);
+    }, py::arg("paths"), py::arg("names"), py::arg("output"), py::arg("num_threads") = 0,
+       "Pack SPC files byte-for-byte into a shard with a trailing index; returns the member count");
+
+    m.def("merge_spc", [](const std::vector<std::string>& inputs, const std::string& output) {
+        py::gil_scoped_release release;
+        return merge_spc_files(inputs, output);
+    }, py::arg("inputs"), py::arg("output"),
+       "Concatenate the subfiles of compatible SPC files into one multifile without decoding; returns the subfile count");
+
+    m.def("extract_subfiles", [](const std::string& input, const std::vector<uint32_t>& subfiles,
+                                 const std::string& output) {
+        py::gil_scoped_release release;
+        extract_subfiles(input, subfiles, output);
+    }, py::arg("input"), py::arg("subfiles"), py::arg("output"),
+       "Copy selected subfiles of an SPC file into a new multifile without decoding");
+
+    m.def("subfile_count", [](const std::string& path) {
+        return read_spc_layout(path).num_subfiles;
+    }, py::arg("path"), "Number of subfiles in an SPC file, read from its headers");
+
+    m.def("split_spc", [](const std::string& input, const std::vector<std::string>& outputs, size_t num_threads) {
+        py::gil_scoped_release release;
+        split_spc_file(input, outputs, num_threads);
+    }, py::arg("input"), py::arg("outputs"), py::arg("num_threads") = 0,
+       "Copy each subfile of an SPC file into its own file without decoding");
+
+    py::class_<BatchLoader>(m, "BatchLoader")
+        .def(py::init<const std::vector<std::string>&, size_t, bool, uint64_t, bool, size_t, size_t>(),
+             py::arg("paths"), py::arg("batch_size"), py::arg("shuffle") = false, py::arg("seed") = 0,
+             py::arg("drop_last") = false, py::arg("prefetch") = 2, py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("__len__", &BatchLoader::num_batches)
+        .def_property_readonly("num_rows", [](const BatchLoader& loader) { return loader.dataset().num_rows(); })
+        .def_property_readonly("num_points", [](const BatchLoader& loader) { return loader.dataset().num_points(); })
+        .def_property_readonly("x", [](const BatchLoader& loader) {
+            tracked_vector<double> x = loader.dataset().x();
+            const auto n = static_cast<py::ssize_t>(x.size());
+            return vector_to_array(std::move(x), {n});
+        })
+        .def("start_epoch", &BatchLoader::start_epoch, py::arg("epoch"), py::call_guard<py::gil_scoped_release>(),
+             "Start an epoch and begin prefetching its batches")
+        .def("next", [](BatchLoader& loader) -> py::object {
+            LoaderBatch batch;
+            bool more;
+            {
+                py::gil_scoped_release release;
+                more = loader.next(batch);
+            }
+            if (!more) {
+                return py::none();
+            }
+            const auto num_rows = static_cast<py::ssize_t>(batch.num_rows);
+            return py::make_tuple(
+                pooled_to_array(loader.pool(), std::move(batch.values),
+                                {num_rows, static_cast<py::ssize_t>(loader.dataset().num_points())}),
+                vector_to_array(std::move(batch.rows), {num_rows}));
+        }, "Next batch of the epoch as (values, rows), or None at its end");
+
+    py::class_<CompletionReader>(m, "CompletionReader")
+        .def(py::init<std::vector<std::string>, size_t>(), py::arg("paths"), py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("__len__", &CompletionReader::size)
+        .def("next", [](CompletionReader& reader) -> py::object {
+            CompletionReader::Completed done;
+            bool more;
+            {
+                py::gil_scoped_release release;
+                more = reader.next(done);
+            }
+            if (!more) {
+                return py::none();
+            }
+            if (done.error) {
+                try {
+                    std::rethrow_exception(done.error);
+                } catch (const std::exception& e) {
+                    throw std::runtime_error(reader.path(done.index) + ": " + e.what());
+                }
+            }
+            return py::make_tuple(done.index, to_pydict(done.file));
+        }, "Next file to finish as (index, read_spc dict), or None when all have been returned");
+
+    py::class_<SPCShard>(m, "SPCShard")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def("__len__", &SPCShard::size)
+        .def("name", [](const SPCShard& shard, size_t index) { return shard.member(index).name; }, py::arg("index"))
+        .def("index", &SPCShard::find, py::arg("name"), "Index of the member with this name")
+        .def("info", [](const SPCShard& shard, size_t index) {
+            const ShardMember& m = shard.member(index);
+            py::dict d;
+            d["name"] = m.name;
+            d["offset"] = m.offset;
+            d["length"] = m.length;
+            d["num_points"] = m.num_points;
+            d["num_subfiles"] = m.num_subfiles;
+            d["first_x"] = m.first_x;
+            d["last_x"] = m.last_x;
+            d["is_multifile"] = m.is_multifile;
+            d["is_xy"] = m.is_xy;
+            d["is_xyxy"] = m.is_xyxy;
+            d["y_in_16bit"] = m.y_in_16bit;
+            d["is_old_format"] = m.is_old_format;
+            return d;
+        }, py::arg("index"), "Index entry of a member")
+        .def("read_bytes", [](const SPCShard& shard, size_t index) {
+            return py::bytes(shard.member_data(index), shard.member(index).length);
+        }, py::arg("index"), "Original file contents of a member")
+        .def("read", [](const SPCShard& shard, size_t index) {
+            ReadAllocationScope allocation_scope;
+            SPCFile spc;
+            {
+                py::gil_scoped_release release;
+                spc = shard.read(index);
+            }
+            return to_pydict(spc);
+        }, py::arg("index"), "Decode one member; returns the same dict as read_spc")
+        .def("read_range", [](const SPCShard& shard, size_t first, size_t count, size_t num_threads) {
+            ReadAllocationScope allocation_scope;
+            std::vector<SPCFile> files;
+            {
+                py::gil_scoped_release release;
+                files = shard.read_range(first, count, num_threads);
+            }
+            py::list out;
+            for (const SPCFile& spc : files) {
+                out.append(to_pydict(spc));
+            }
+            return out;
+        }, py::arg("first"), py::arg("count"), py::arg("num_threads") = 0,
+           "Decode members [first, first + count) in parallel; returns a list of read_spc dicts");
+
+    m.def("allocation_stats", [](const std::string& scope) {
+        AllocationStats stats;
+        if (scope == "global") {
+            stats = global_allocation_counter().snapshot();
+        } else if (scope == "thread") {
+            stats = thread_allocation_counter().snapshot();
+        } else if (scope == "last_read") {
+            stats = last_read_allocation_stats();
+        } else {
+            throw std::runtime_error("Unknown allocation scope '" + scope + "' (expected global, thread or last_read)");
+        }
+        py::dict d;
+        d["allocations"] = stats.allocations;
+        d["deallocations"] = stats.deallocations;
+        d["bytes_allocated"] = stats.bytes_allocated;
+        d["bytes_in_use"] = stats.bytes_in_use;
+        d["peak_bytes"] = stats.peak_bytes;
+        return d;
+    }, py::arg("scope") = "global", "Counters of tracked native allocations for a scope");
+
+    m.def("reset_allocation_stats", []() {
+        global_allocation_counter().reset();
+        thread_allocation_counter().reset();
+    }, "Reset the global and calling-thread allocation counters (bytes in use are kept)");
+
+    m.def("set_num_threads", [](size_t num_threads) {
+        py::gil_scoped_release release;
+        global_executor().set_num_threads(num_threads);
+    }, py::arg("num_threads"), "Resize the shared native thread pool (0 = SPECIO3_NUM_THREADS or all cores)");
+
+    m.def("get_num_threads", []() { return global_executor().num_threads(); },
+          "Threads used by native parallel operations");
+
+    m.def("set_thread_affinity", [](const std::vector<int>& cpus) { global_executor().set_affinity(cpus); },
+          py::arg("cpus"), "Pin the native worker threads to these CPUs (empty list = no pinning)");
+
+    m.def("thread_affinity", []() { return global_executor().affinity(); }, "CPUs the native workers are pinned to");
+
+    m.def("executor_stats", []() {
+        const ExecutorStats stats = global_executor().stats();
+        py::dict d;
+        d["num_threads"] = stats.num_threads;
+        d["jobs"] = stats.jobs;
+        d["tasks"] = stats.tasks;
+        d["busy_seconds"] = stats.busy_seconds;
+        d["capacity_seconds"] = stats.capacity_seconds;
+        d["utilization"] = stats.capacity_seconds > 0 ? stats.busy_seconds / stats.capacity_seconds : 0.0;
+        return d;
+    }, "Utilization counters of the shared native thread pool");
+
+    m.def("reset_executor_stats", []() { global_executor().reset_stats(); },
+          "Reset the native thread pool counters");
+
+    m.def("build_library", [](const std::vector<std::string>& paths, const std::string& output_path,
+                              double x_min, double x_max, uint32_t num_points,
+                              const std::string& metric, size_t num_threads) {
+        SpectralGrid grid{x_min, x_max, num_points};
+        SimilarityMetric parsed_metric = parse_similarity_metric(metric);
+        py::gil_scoped_release release;
+        return build_spectral_library(paths, grid, parsed_metric, output_path, num_threads);
+    }, py::arg("paths"), py::arg("output_path"), py::arg("x_min"), py::arg("x_max"), py::arg("num_points"),
+       py::arg("metric") = "pearson", py::arg("num_threads") = 0,
+       "Resample and normalize SPC files into a memory-mappable library file; returns the row count");
+
+    py::class_<SpectralLibrary>(m, "SpectralLibrary")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def("__len__", &SpectralLibrary::size)
+        .def_property_readonly("num_points", &SpectralLibrary::num_points)
+        .def_property_readonly("x_min", [](const SpectralLibrary& lib) { return lib.grid().x_min; })
+        .def_property_readonly("x_max", [](const SpectralLibrary& lib) { return lib.grid().x_max; })
+        .def_property_readonly("metric", [](const SpectralLibrary& lib) {
+            return std::string(similarity_metric_name(lib.metric()));
+        })
+        .def("name", &SpectralLibrary::name, py::arg("index"))
+        .def("subfile_index", &SpectralLibrary::subfile_index, py::arg("index"))
+        .def("resample", [](const SpectralLibrary& lib, const DoubleArray& x, const DoubleArray& y) {
+            return resample_to_array(lib.grid(), x, y);
+        }, py::arg("x"), py::arg("y"), "Resample one spectrum onto the library grid")
+        .def("resample_file", &resample_file_to_array<SpectralLibrary>, py::arg("path"),
+             "Resample every subfile of an SPC file onto the library grid")
+        .def("search", [](const SpectralLibrary& lib, const FloatArray& queries, size_t k, size_t num_threads) {
+            check_queries(queries, lib.num_points());
+            SearchResult result;
+            {
+                py::gil_scoped_release release;
+                result = lib.search(queries.data(), static_cast<size_t>(queries.shape(0)), k, num_threads);
+            }
+            return search_result_to_tuple(std::move(result));
+        }, py::arg("queries"), py::arg("k") = 10, py::arg("num_threads") = 0,
+           "Top-k most similar library rows for each on-grid query; returns (indices, scores)");
+
+    m.def("build_ann_index", [](const std::vector<std::string>& paths, const std::string& output_path,
+                                double x_min, double x_max, uint32_t num_points, const std::string& metric,
+                                uint32_t pca_components, size_t pca_sample_size, uint32_t max_neighbors,
+                                uint32_t ef_construction, uint64_t seed, size_t num_threads) {
+        AnnBuildOptions options;
+        options.grid = SpectralGrid{x_min, x_max, num_points};
+        options.metric = parse_similarity_metric(metric);
+        options.pca_components = pca_components;
+        options.pca_sample_size = pca_sample_size;
+        options.max_neighbors = max_neighbors;
+        options.ef_construction = ef_construction;
+        options.seed = seed;
+        options.num_threads = num_threads;
+        py::gil_scoped_release release;
+        return build_ann_index(paths, options, output_path);
+    }, py::arg("paths"), py::arg("output_path"), py::arg("x_min"), py::arg("x_max"), py::arg("num_points"),
+       py::arg("metric") = "cosine", py::arg("pca_components") = 0, py::arg("pca_sample_size") = 20000,
+       py::arg("max_neighbors") = 16, py::arg("ef_construction") = 200, py::arg("seed") = 42,
+       py::arg("num_threads") = 0,
+       "Build an HNSW index over SPC files, optionally PCA-reduced; returns the entry count");
+
+    py::class_<AnnIndex>(m, "AnnIndex")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def("__len__", &AnnIndex::size)
+        .def_property_readonly("num_points", &AnnIndex::num_points)
+        .def_property_readonly("dim", &AnnIndex::dim)
+        .def_property_readonly("pca_components", &AnnIndex::pca_components)
+        .def_property_readonly("x_min", [](const AnnIndex& index) { return index.grid().x_min; })
+        .def_property_readonly("x_max", [](const AnnIndex& index) { return index.grid().x_max; })
+        .def_property_readonly("metric", [](const AnnIndex& index) {
+            return std::string(similarity_metric_name(index.metric()));
+        })
+        .def("name", &AnnIndex::name, py::arg("index"))
+        .def("subfile_index", &AnnIndex::subfile_index, py::arg("index"))
+        .def("resample", [](const AnnIndex& index, const DoubleArray& x, const DoubleArray& y) {
+            return resample_to_array(index.grid(), x, y);
+        }, py::arg("x"), py::arg("y"), "Resample one spectrum onto the index grid")
+        .def("resample_file", &resample_file_to_array<AnnIndex>, py::arg("path"),
+             "Resample every subfile of an SPC file onto the index grid")
+        .def("search", [](const AnnIndex& index, const FloatArray& queries, size_t k, size_t ef,
+                          size_t num_threads) {
+            check_queries(queries, index.num_points());
+            SearchResult result;
+            {
+                py::gil_scoped_release release;
+                result = index.search(queries.data(), static_cast<size_t>(queries.shape(0)), k, ef, num_threads);
+            }
+            return search_result_to_tuple(std::move(result));
+        }, py::arg("queries"), py::arg("k") = 10, py::arg("ef") = 64, py::arg("num_threads") = 0,
+           "Approximate top-k neighbours for each on-grid query; returns (indices, scores)");
 }
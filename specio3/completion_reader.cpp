@@ -0,0 +1,58 @@
+#include "completion_reader.h"
+#include "parallel.h"
+
+CompletionReader::CompletionReader(std::vector<std::string> paths, size_t num_threads)
+    : paths_(std::move(paths)) {
+    driver_ = std::thread([this, num_threads] {
+        // Every task catches its own errors, so all files are accounted for
+        parallel_for(paths_.size(), num_threads, [&](size_t i) {
+            if (cancelled_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            Completed done;
+            done.index = i;
+            try {
+                done.file = read_spc_impl(paths_[i]);
+            } catch (...) {
+                done.error = std::current_exception();
+            }
+            queue_.push(std::move(done));
+            wake();
+        });
+    });
+}
+
+CompletionReader::~CompletionReader() {
+    cancelled_.store(true, std::memory_order_relaxed);
+    if (driver_.joinable()) {
+        driver_.join();
+    }
+}
+
+void CompletionReader::wake() {
+    // Pairs with the fence in next(): either the consumer sees the pushed
+    // item before sleeping, or this thread sees it waiting and notifies
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_one();
+    }
+}
+
+bool CompletionReader::next(Completed& out) {
+    std::lock_guard<std::mutex> consumer(consumer_mutex_);
+    if (delivered_ == paths_.size()) {
+        return false;
+    }
+    while (!queue_.try_pop(out)) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.empty()) {
+            cv_.wait(lock);
+        }
+        waiting_.store(false, std::memory_order_relaxed);
+    }
+    ++delivered_;
+    return true;
+}
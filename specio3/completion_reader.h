@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.h"
+#include "spc_reader.h"
+
+/**
+ * Decodes a batch of SPC files in the background and hands them out in the
+ * order they finish, so a consumer never waits on a slow file while faster
+ * ones are ready.
+ *
+ * A driver thread runs one task per file on the process-wide executor.
+ * Workers push finished files onto a lock-free MPSCQueue and only touch the
+ * consumer's mutex to wake it when it is actually asleep waiting.
+ */
+class CompletionReader {
+public:
+    /** One finished file: its decoded contents or the error that stopped it. */
+    struct Completed {
+        size_t index = 0;  ///< Position of the file in paths
+        SPCFile file;
+        std::exception_ptr error;
+    };
+
+    /**
+     * Start decoding every file.
+     *
+     * @param paths SPC files
+     * @param num_threads Worker threads (0 = all cores)
+     */
+    CompletionReader(std::vector<std::string> paths, size_t num_threads);
+
+    /** Skip files not yet started and wait for the ones in progress. */
+    ~CompletionReader();
+
+    CompletionReader(const CompletionReader&) = delete;
+    CompletionReader& operator=(const CompletionReader&) = delete;
+
+    size_t size() const { return paths_.size(); }
+    const std::string& path(size_t index) const { return paths_[index]; }
+
+    /**
+     * Take the next file to finish, waiting if none has yet. Safe to call
+     * from several threads; each file is handed out once.
+     *
+     * @param out Receives the file (check out.error)
+     * @return false once every file has been handed out
+     */
+    bool next(Completed& out);
+
+private:
+    void wake();
+
+    std::vector<std::string> paths_;
+    std::mutex consumer_mutex_;  ///< Makes next() the queue's single consumer
+    MPSCQueue<Completed> queue_;
+    std::atomic<bool> cancelled_{false};
+    size_t delivered_ = 0;  ///< Guarded by consumer_mutex_
+
+    // Sleep/wake for the consumer; workers lock only if it is waiting
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> waiting_{false};
+
+    std::thread driver_;
+};
@@ -0,0 +1,344 @@
+"""
+specio3d: serve decoded spectra to processes on the same host.
+
+The daemon decodes SPC files with the native reader into sealed
+shared-memory files and keeps the most recent ones in an LRU cache. Clients
+connect over a Unix domain socket, send a request (path, subfile range, X
+range, decimation) and receive the shared-memory file descriptor, which they
+map read-only: every process on the host shares one decoded copy and pays
+the parsing cost once. Linux only (memfd and descriptor passing).
+
+Run it with ``specio3d`` or ``python -m specio3.daemon``; connect with
+:class:`DaemonClient`.
+"""
+import argparse
+import json
+import math
+import mmap
+import os
+import socket
+import socketserver
+import struct
+import threading
+from collections import OrderedDict
+from typing import Any, Dict, Optional, Tuple
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+from .library import PathLike
+
+_HEADER = struct.Struct("!I")
+_MAX_MESSAGE = 1 << 20
+
+
+def default_socket_path() -> str:
+    """``$XDG_RUNTIME_DIR/specio3d.sock``, else ``/tmp/specio3d-<uid>.sock``."""
+    runtime_dir = os.environ.get("XDG_RUNTIME_DIR")
+    if runtime_dir:
+        return os.path.join(runtime_dir, "specio3d.sock")
+    return f"/tmp/specio3d-{os.getuid()}.sock"
+
+
+def _send_message(sock: socket.socket, message: Dict[str, Any], fd: Optional[int] = None) -> None:
+    body = json.dumps(message).encode()
+    data = _HEADER.pack(len(body)) + body
+    if fd is None:
+        sock.sendall(data)
+    else:
+        sent = socket.send_fds(sock, [data], [fd])
+        if sent < len(data):
+            sock.sendall(data[sent:])
+
+
+def _recv_exact(sock: socket.socket, size: int, data: bytes = b"") -> bytes:
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("specio3d connection closed")
+        data += chunk
+    return data
+
+
+def _recv_message(sock: socket.socket, with_fds: bool = False) -> Tuple[Optional[Dict[str, Any]], list]:
+    """Read one message; returns (None, []) if the peer closed the connection."""
+    if with_fds:
+        data, fds, _, _ = socket.recv_fds(sock, _MAX_MESSAGE, 1)
+    else:
+        data, fds = sock.recv(_MAX_MESSAGE), []
+    if not data:
+        return None, fds
+    data = _recv_exact(sock, _HEADER.size, data)
+    (size,) = _HEADER.unpack_from(data)
+    if size > _MAX_MESSAGE:
+        raise ConnectionError("specio3d message too large")
+    data = _recv_exact(sock, _HEADER.size + size, data)
+    return json.loads(data[_HEADER.size:]), fds
+
+
+class _Segment:
+    __slots__ = ("fd", "info")
+
+    def __init__(self, fd: int, info: Dict[str, Any]):
+        self.fd = fd
+        self.info = info
+
+
+class SpectrumServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    """
+    Unix-socket server behind ``specio3d``.
+
+    Parameters
+    ----------
+    socket_path : str
+        Socket to listen on; a stale socket file is replaced. The socket is
+        created with mode 0600, so only the owning user can connect (the
+        daemon reads any file that user can read).
+    cache_bytes : int
+        Size limit of the decoded-segment cache. Evicted segments stay valid
+        for clients that already mapped them.
+    num_threads : int
+        Native decode threads per request; 0 uses the shared pool's size.
+    """
+
+    daemon_threads = True
+
+    def __init__(self, socket_path: str, cache_bytes: int = 1 << 30, num_threads: int = 0):
+        if os.path.exists(socket_path):
+            os.unlink(socket_path)
+        self.cache_bytes = int(cache_bytes)
+        self.num_threads = int(num_threads)
+        self._lock = threading.Lock()
+        self._handles: "OrderedDict[str, Tuple[Tuple[int, int], Any]]" = OrderedDict()
+        self._segments: "OrderedDict[tuple, _Segment]" = OrderedDict()
+        self._cached_bytes = 0
+        self._stats = {"requests": 0, "hits": 0, "misses": 0, "evictions": 0}
+        old_umask = os.umask(0o177)
+        try:
+            super().__init__(socket_path, _RequestHandler)
+        finally:
+            os.umask(old_umask)
+
+    def _handle(self, path: str, version: Tuple[int, int]):
+        # One open SPCHandle per file, reopened when the file changes
+        with self._lock:
+            entry = self._handles.get(path)
+            if entry is not None and entry[0] == version:
+                self._handles.move_to_end(path)
+                return entry[1]
+        handle = _specio3.SPCHandle(path)
+        with self._lock:
+            self._handles[path] = (version, handle)
+            self._handles.move_to_end(path)
+            while len(self._handles) > 256:
+                self._handles.popitem(last=False)
+        return handle
+
+    def lookup(self, request: Dict[str, Any]) -> Tuple[Dict[str, Any], int]:
+        """
+        Return ``(info, fd)`` of the cached segment for a read request,
+        decoding it on a miss. ``fd`` is a duplicate taken under the lock, so
+        an eviction cannot close it (and let the number be reused) before it
+        is sent; the caller must close it.
+        """
+        path = os.path.realpath(str(request["path"]))
+        st = os.stat(path)
+        version = (st.st_mtime_ns, st.st_size)
+        first = int(request.get("first", 0))
+        count = request.get("count")
+        x_min = float(request.get("x_min", -math.inf))
+        x_max = float(request.get("x_max", math.inf))
+        step = int(request.get("step", 1))
+        key = (path, version, first, count, x_min, x_max, step)
+
+        with self._lock:
+            self._stats["requests"] += 1
+            segment = self._segments.get(key)
+            if segment is not None:
+                self._segments.move_to_end(key)
+                self._stats["hits"] += 1
+                return segment.info, os.dup(segment.fd)
+            self._stats["misses"] += 1
+
+        handle = self._handle(path, version)
+        if count is None:
+            count = max(len(handle) - first, 0)
+        info = _specio3.decode_to_segment(handle, first, int(count), x_min, x_max, step, self.num_threads)
+        segment = _Segment(info.pop("fd"), info)
+
+        with self._lock:
+            if key in self._segments:  # decoded concurrently by another client
+                os.close(segment.fd)
+                segment = self._segments[key]
+                return segment.info, os.dup(segment.fd)
+            self._segments[key] = segment
+            self._cached_bytes += info["size"]
+            fd = os.dup(segment.fd)
+            while self._cached_bytes > self.cache_bytes and len(self._segments) > 1:
+                _, old = self._segments.popitem(last=False)
+                self._cached_bytes -= old.info["size"]
+                self._stats["evictions"] += 1
+                os.close(old.fd)
+            return segment.info, fd
+
+    def stats(self) -> Dict[str, Any]:
+        with self._lock:
+            return dict(self._stats, segments=len(self._segments), cached_bytes=self._cached_bytes)
+
+    def server_close(self) -> None:
+        super().server_close()
+        with self._lock:
+            for segment in self._segments.values():
+                os.close(segment.fd)
+            self._segments.clear()
+            self._cached_bytes = 0
+        if os.path.exists(self.server_address):
+            os.unlink(self.server_address)
+
+
+class _RequestHandler(socketserver.BaseRequestHandler):
+    def handle(self) -> None:
+        while True:
+            try:
+                request, _ = _recv_message(self.request)
+            except (ConnectionError, ValueError):
+                return
+            if request is None:
+                return
+            try:
+                if request.get("op") == "stats":
+                    _send_message(self.request, {"ok": True, "stats": self.server.stats()})
+                    continue
+                info, fd = self.server.lookup(request)
+                try:
+                    _send_message(self.request, dict(info, ok=True), fd)
+                finally:
+                    os.close(fd)
+            except Exception as e:  # reported to the client, the connection stays usable
+                _send_message(self.request, {"ok": False, "error": f"{type(e).__name__}: {e}"})
+
+
+class DaemonClient:
+    """
+    Connection to a running ``specio3d``.
+
+    Results are NumPy views of a read-only shared-memory mapping: no data is
+    copied into this process, and every client reading the same request
+    shares the daemon's decoded copy. Safe to use from several threads.
+
+    Parameters
+    ----------
+    socket_path : str, optional
+        Daemon socket; defaults to :func:`default_socket_path`.
+
+    Examples
+    --------
+    >>> client = specio3.DaemonClient()
+    >>> x, y, offsets, z = client.read("run.spc", subfiles=(0, 100), x_range=(1000, 1800), step=2)
+    >>> first = y[offsets[0]:offsets[1]]
+    """
+
+    def __init__(self, socket_path: Optional[str] = None):
+        self._socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self._socket.connect(socket_path or default_socket_path())
+        self._lock = threading.Lock()
+
+    def close(self) -> None:
+        self._socket.close()
+
+    def __enter__(self) -> "DaemonClient":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
+
+    def _call(self, request: Dict[str, Any]) -> Tuple[Dict[str, Any], list]:
+        with self._lock:
+            _send_message(self._socket, request)
+            reply, fds = _recv_message(self._socket, with_fds=True)
+        if reply is None:
+            raise ConnectionError("specio3d connection closed")
+        if not reply.get("ok"):
+            for fd in fds:
+                os.close(fd)
+            raise RuntimeError(reply.get("error", "specio3d request failed"))
+        return reply, fds
+
+    def read(
+        self,
+        path: PathLike,
+        subfiles: Optional[Tuple[int, int]] = None,
+        x_range: Optional[Tuple[float, float]] = None,
+        step: int = 1,
+    ) -> Tuple[NDArray[np.float64], NDArray[np.float64], NDArray[np.int64], NDArray[np.float64]]:
+        """
+        Read spectra through the daemon.
+
+        Parameters
+        ----------
+        path : str or PathLike
+            SPC file, as seen by the daemon.
+        subfiles : (start, stop), optional
+            Subfile range; all subfiles by default.
+        x_range : (x_min, x_max), optional
+            Keep only points with ``x_min <= x <= x_max``.
+        step : int, default 1
+            Keep every ``step``-th of the remaining points.
+
+        Returns
+        -------
+        x, y, offsets, z
+            Read-only arrays in the layout of :func:`read_spc_ragged`.
+
+        Raises
+        ------
+        RuntimeError
+            If the daemon could not read the file or the request is invalid.
+        """
+        request: Dict[str, Any] = {"path": os.path.abspath(os.fspath(path)), "step": int(step)}
+        if subfiles is not None:
+            start, stop = (int(v) for v in subfiles)
+            request["first"] = start
+            request["count"] = max(stop - start, 0)
+        if x_range is not None:
+            request["x_min"], request["x_max"] = (float(v) for v in x_range)
+        reply, fds = self._call(request)
+        try:
+            buffer = mmap.mmap(fds[0], reply["size"], prot=mmap.PROT_READ)
+        finally:
+            for fd in fds:
+                os.close(fd)
+        n, total = reply["num_subfiles"], reply["num_values"]
+        offsets = np.frombuffer(buffer, dtype=np.int64, count=n + 1)
+        z = np.frombuffer(buffer, dtype=np.float64, count=n, offset=offsets.nbytes)
+        x = np.frombuffer(buffer, dtype=np.float64, count=total, offset=offsets.nbytes + z.nbytes)
+        y = np.frombuffer(buffer, dtype=np.float64, count=total, offset=offsets.nbytes + z.nbytes + x.nbytes)
+        return x, y, offsets, z
+
+    def stats(self) -> Dict[str, Any]:
+        """Cache counters of the daemon: requests, hits, misses, evictions, segments, cached_bytes."""
+        reply, _ = self._call({"op": "stats"})
+        return reply["stats"]
+
+
+def main(argv=None) -> None:
+    parser = argparse.ArgumentParser(prog="specio3d", description="Serve decoded SPC spectra over a Unix socket.")
+    parser.add_argument("--socket", default=default_socket_path(), help="socket path (default: %(default)s)")
+    parser.add_argument("--cache-mb", type=float, default=1024, help="decoded cache size in MB")
+    parser.add_argument("--num-threads", type=int, default=0, help="decode threads per request (0 = all cores)")
+    args = parser.parse_args(argv)
+
+    with SpectrumServer(args.socket, int(args.cache_mb * 1024 * 1024), args.num_threads) as server:
+        print(f"specio3d listening on {args.socket}")
+        try:
+            server.serve_forever()
+        except KeyboardInterrupt:
+            pass
+
+
+if __name__ == "__main__":
+    main()
+
+
+__all__ = ["SpectrumServer", "DaemonClient", "default_socket_path", "main"]
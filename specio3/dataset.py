@@ -0,0 +1,226 @@
+"""Lazy 2-D view over many SPC files that share an X axis."""
+import os
+import threading
+from collections import OrderedDict
+from typing import Sequence, Tuple
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+from .library import PathLike
+
+
+def _normalize_index(key, length: int, axis: str):
+    """
+    Turn one axis of an index into ``(positions, scalar)``.
+
+    ``positions`` is a slice (with non-negative start/stop) or an int64 array
+    of positions; ``scalar`` is True when the axis is dropped from the result.
+    """
+    if isinstance(key, slice):
+        return slice(*key.indices(length)), False
+    if isinstance(key, (int, np.integer)):
+        index = int(key)
+        if index < -length or index >= length:
+            raise IndexError(f"{axis} index {index} out of range for {length} {axis}s")
+        return np.array([index % length], dtype=np.int64), True
+    positions = np.asarray(key)
+    if positions.ndim == 1 and positions.size == 0:
+        return np.empty(0, dtype=np.int64), False
+    if positions.dtype == bool:
+        if positions.shape != (length,):
+            raise IndexError(f"boolean {axis} mask must have length {length}")
+        return np.flatnonzero(positions), False
+    if positions.ndim != 1 or not np.issubdtype(positions.dtype, np.integer):
+        raise IndexError(f"{axis} index must be an int, slice, 1-D integer array or boolean mask")
+    if positions.size and (positions.min() < -length or positions.max() >= length):
+        raise IndexError(f"{axis} index out of range for {length} {axis}s")
+    return positions.astype(np.int64) % length, False
+
+
+class VirtualDataset:
+    """
+    Many same-shape SPC files presented as one lazy ``(rows, points)`` array.
+
+    Rows are the subfiles of ``paths`` in order (one per file for
+    single-spectrum files). Opening the dataset only probes the headers, in
+    parallel; indexing decodes just the files and the range of points that
+    are touched, in parallel, and returns a NumPy array. Whole rows are kept
+    in an LRU cache so repeatedly used spectra are decoded once.
+
+    Parameters
+    ----------
+    paths : sequence of str or PathLike
+        Y-only or XY SPC files with the same number of points and the same X
+        axis (Y-only files are compared by X range, XY files point by
+        point). The X axis is taken from the first.
+    cache_rows : int, default 1024
+        Maximum number of full rows held in the LRU cache; 0 disables it.
+    num_threads : int, default 0
+        Worker threads for probing and decoding; 0 uses every core.
+
+    Raises
+    ------
+    RuntimeError
+        If a header cannot be read or the files do not share an X axis.
+
+    Examples
+    --------
+    >>> ds = specio3.VirtualDataset(sorted(glob.glob("run/*.spc")))
+    >>> ds.shape
+    (100000, 1024)
+    >>> block = ds[5000:5100]          # decodes 100 files
+    >>> band = ds[:, 200:260]          # reads only 60 points of every file
+    >>> arr = ds.to_dask(rows_per_chunk=4096).mean(axis=0).compute()
+    """
+
+    def __init__(self, paths: Sequence[PathLike], cache_rows: int = 1024, num_threads: int = 0):
+        self._paths = [os.fspath(p) for p in paths]
+        self._cache_rows = int(cache_rows)
+        self._num_threads = int(num_threads)
+        self._native = _specio3.VirtualDataset(self._paths, self._num_threads)
+        self._cache = OrderedDict()
+        self._lock = threading.Lock()
+
+    def __reduce__(self):
+        # Reopen from the paths (e.g. in a Dask worker) instead of pickling the cache
+        return VirtualDataset, (self._paths, self._cache_rows, self._num_threads)
+
+    @property
+    def shape(self) -> Tuple[int, int]:
+        """``(num_rows, num_points)``."""
+        return len(self._native), self._native.num_points
+
+    @property
+    def dtype(self) -> np.dtype:
+        return np.dtype(np.float64)
+
+    @property
+    def ndim(self) -> int:
+        return 2
+
+    @property
+    def size(self) -> int:
+        return self.shape[0] * self.shape[1]
+
+    @property
+    def x(self) -> NDArray[np.float64]:
+        """Common X axis."""
+        return self._native.x
+
+    def __len__(self) -> int:
+        return len(self._native)
+
+    def __repr__(self) -> str:
+        return f"VirtualDataset(shape={self.shape}, files={len(self._paths)})"
+
+    def location(self, row: int) -> Tuple[str, int]:
+        """Return the ``(path, subfile_index)`` a row is read from."""
+        return self._native.location(int(row))
+
+    def __array__(self, dtype=None, copy=None):
+        values = self[:, :]
+        return values if dtype is None else values.astype(dtype, copy=False)
+
+    def __getitem__(self, key) -> NDArray[np.float64]:
+        if not isinstance(key, tuple):
+            key = (key,)
+        if any(k is Ellipsis for k in key):
+            i = next(i for i, k in enumerate(key) if k is Ellipsis)
+            key = key[:i] + (slice(None),) * (3 - len(key)) + key[i + 1:]
+        if len(key) == 1:
+            key = key + (slice(None),)
+        if len(key) != 2:
+            raise IndexError("VirtualDataset is 2-D")
+
+        num_rows, num_points = self.shape
+        rows, row_scalar = _normalize_index(key[0], num_rows, "row")
+        cols, col_scalar = _normalize_index(key[1], num_points, "point")
+        if isinstance(rows, slice):
+            rows = np.arange(rows.start, rows.stop, rows.step, dtype=np.int64)
+
+        # Decode the contiguous span of points covering the column selection
+        if isinstance(cols, slice) and cols.step == 1:
+            first, count, local = cols.start, max(cols.stop - cols.start, 0), slice(None)
+        else:
+            if isinstance(cols, slice):
+                cols = np.arange(cols.start, cols.stop, cols.step, dtype=np.int64)
+            first = int(cols.min()) if cols.size else 0
+            count = int(cols.max()) - first + 1 if cols.size else 0
+            local = cols - first
+
+        values = self._read_rows(rows, first, count)[:, local]
+        if col_scalar:
+            values = values[:, 0]
+        if row_scalar:
+            values = values[0]
+        return values
+
+    def _read_rows(self, rows: NDArray[np.int64], first: int, count: int) -> NDArray[np.float64]:
+        """Points ``[first, first + count)`` of ``rows``, using and filling the row cache."""
+        out = np.empty((len(rows), count), dtype=np.float64)
+        if len(rows) == 0 or count == 0:
+            return out
+
+        full = first == 0 and count == self.shape[1]
+        missing = []
+        with self._lock:
+            for i, row in enumerate(rows.tolist()):
+                cached = self._cache.get(row)
+                if cached is None:
+                    missing.append(i)
+                else:
+                    self._cache.move_to_end(row)
+                    out[i] = cached[first:first + count]
+        if not missing:
+            return out
+
+        wanted, inverse = np.unique(rows[missing], return_inverse=True)
+        block = self._native.read(wanted.tolist(), first, count, self._num_threads)
+        out[missing] = block[inverse.ravel()]
+
+        if full and self._cache_rows > 0:
+            with self._lock:
+                # Rows beyond the cache size would be evicted straight away
+                for j in range(max(len(wanted) - self._cache_rows, 0), len(wanted)):
+                    cached = block[j].copy()
+                    cached.flags.writeable = False
+                    self._cache[int(wanted[j])] = cached
+                    self._cache.move_to_end(int(wanted[j]))
+                while len(self._cache) > self._cache_rows:
+                    self._cache.popitem(last=False)
+        return out
+
+    def to_dask(self, rows_per_chunk: int = 1024, points_per_chunk: int = -1):
+        """
+        Wrap the dataset in a chunked ``dask.array.Array``.
+
+        Each chunk is read with one :meth:`__getitem__` call, so a chunk is
+        decoded in parallel and only the chunks a computation needs are read.
+        The dataset pickles by path, so the graph also runs on distributed
+        workers that can see the files.
+
+        Parameters
+        ----------
+        rows_per_chunk : int, default 1024
+            Rows per chunk.
+        points_per_chunk : int, default -1
+            Points per chunk; -1 keeps whole rows together.
+
+        Returns
+        -------
+        dask.array.Array
+            Lazy array with the dataset's shape and dtype.
+        """
+        try:
+            import dask.array as da
+            from dask.base import tokenize
+        except ImportError as e:
+            raise ImportError("VirtualDataset.to_dask requires dask (pip install 'dask[array]')") from e
+        name = "specio3-virtual-dataset-" + tokenize(self._paths, self.shape)
+        return da.from_array(self, chunks=(rows_per_chunk, points_per_chunk), name=name, asarray=False,
+                             fancy=False, lock=False)
+
+
+__all__ = ["VirtualDataset"]
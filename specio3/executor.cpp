@@ -0,0 +1,332 @@
+#include "executor.h"
+#include "alloc_tracking.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#elif !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+struct Executor::Job {
+    size_t count = 0;
+    TaskFn fn = nullptr;
+    void* context = nullptr;
+    AllocationCounter* read_counter = nullptr;
+    size_t max_helpers = 0;
+    size_t helpers = 0;         ///< Workers that have joined (guarded by mutex_)
+    size_t active_helpers = 0;  ///< Workers still inside participate() (guarded by mutex_)
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    bool wants_helper() const {
+        return helpers < max_helpers && next.load(std::memory_order_relaxed) < count &&
+               !failed.load(std::memory_order_relaxed);
+    }
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t elapsed_ns(Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+#ifdef __linux__
+cpu_set_t to_cpu_set(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return set;
+}
+#endif
+
+/** CPUs the process may run on, as inherited from its parent (e.g. taskset or a cgroup). */
+std::vector<int> inherited_cpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+size_t default_pool_size() {
+    if (const char* env = std::getenv("SPECIO3_NUM_THREADS")) {
+        char* end = nullptr;
+        const long n = std::strtol(env, &end, 10);
+        if (end != env && *end == '\0' && n > 0) {
+            return static_cast<size_t>(n);
+        }
+    }
+    // hardware_concurrency() counts every CPU in the machine, even under taskset or a cgroup
+    const size_t allowed = inherited_cpus().size();
+    if (allowed != 0) {
+        return allowed;
+    }
+    const unsigned hc = std::thread::hardware_concurrency();
+    return hc == 0 ? 1 : static_cast<size_t>(hc);
+}
+
+}  // namespace
+
+Executor::Executor()
+    : num_threads_(default_pool_size()), workers_(new std::vector<std::thread>()), inherited_affinity_(inherited_cpus()) {}
+
+Executor& global_executor() {
+    static Executor* executor = [] {
+        auto* e = new Executor();
+#ifndef _WIN32
+        pthread_atfork(&Executor::prepare_fork, &Executor::parent_after_fork, &Executor::child_after_fork);
+#endif
+        return e;
+    }();
+    return *executor;
+}
+
+void Executor::prepare_fork() {
+    Executor& e = global_executor();
+    e.config_mutex_.lock();
+    e.mutex_.lock();
+}
+
+void Executor::parent_after_fork() {
+    Executor& e = global_executor();
+    e.mutex_.unlock();
+    e.config_mutex_.unlock();
+}
+
+void Executor::child_after_fork() {
+    // Only the forking thread exists in the child. The workers (and any jobs
+    // other threads were running) are gone; their std::thread objects cannot
+    // be joined, so they are leaked and a fresh pool starts on first use.
+    Executor& e = global_executor();
+    e.workers_ = new std::vector<std::thread>();
+    e.jobs_.clear();
+    e.started_ = false;
+    e.stopping_ = false;
+    new (&e.work_cv_) std::condition_variable();
+    new (&e.done_cv_) std::condition_variable();
+    e.mutex_.unlock();
+    e.config_mutex_.unlock();
+}
+
+void Executor::set_num_threads(size_t num_threads) {
+    std::lock_guard<std::mutex> config(config_mutex_);
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_threads_.store(num_threads == 0 ? default_pool_size() : num_threads, std::memory_order_relaxed);
+        stopping_ = true;
+        workers.swap(*workers_);
+    }
+    // Jobs running meanwhile lose their helpers and are finished by their callers
+    work_cv_.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+    started_ = false;
+}
+
+void Executor::set_affinity(const std::vector<int>& cpus) {
+#ifdef __linux__
+    for (int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            throw std::runtime_error("Invalid CPU index " + std::to_string(cpu));
+        }
+        // Offline CPUs and CPUs outside the process's cpuset are missing from the inherited mask
+        if (!inherited_affinity_.empty() &&
+            std::find(inherited_affinity_.begin(), inherited_affinity_.end(), cpu) == inherited_affinity_.end()) {
+            throw std::runtime_error("CPU " + std::to_string(cpu) + " is not available to this process");
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::vector<int> previous = affinity_;
+    affinity_ = cpus;
+    for (std::thread& worker : *workers_) {
+        const int err = apply_affinity(worker);
+        if (err != 0) {
+            affinity_ = previous;
+            for (std::thread& w : *workers_) {
+                apply_affinity(w);
+            }
+            throw std::runtime_error("Unable to set thread affinity: " + std::string(std::strerror(err)));
+        }
+    }
+#else
+    if (!cpus.empty()) {
+        throw std::runtime_error("Thread affinity is only supported on Linux");
+    }
+#endif
+}
+
+std::vector<int> Executor::affinity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return affinity_;
+}
+
+int Executor::apply_affinity(std::thread& thread) const {
+#ifdef __linux__
+    // No pinning means the mask the process started with, not every CPU
+    cpu_set_t set = to_cpu_set(affinity_.empty() ? inherited_affinity_ : affinity_);
+    if (CPU_COUNT(&set) == 0) {  // the inherited mask could not be read
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    return 0;
+#endif
+}
+
+void Executor::start_workers(size_t count) {
+    // Called with mutex_ held. Unpinned workers inherit the process's mask
+    for (size_t i = 0; i < count; ++i) {
+        workers_->emplace_back([this]() { worker_loop(); });
+        if (!affinity_.empty()) {
+            apply_affinity(workers_->back());
+        }
+    }
+    started_ = true;
+}
+
+Executor::Job* Executor::find_job() const {
+    for (Job* job : jobs_) {
+        if (job->wants_helper()) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void Executor::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        Job* job = nullptr;
+        work_cv_.wait(lock, [&]() { return stopping_ || (job = find_job()) != nullptr; });
+        if (stopping_) {
+            return;
+        }
+        ++job->helpers;
+        ++job->active_helpers;
+        lock.unlock();
+        {
+            ReadCounterBinding binding(job->read_counter);
+            participate(*job);
+        }
+        lock.lock();
+        if (--job->active_helpers == 0) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void Executor::participate(Job& job) {
+    const Clock::time_point start = Clock::now();
+    uint64_t tasks = 0;
+    while (!job.failed.load(std::memory_order_relaxed)) {
+        const size_t i = job.next.fetch_add(1, std::memory_order_relaxed);
+        if (i >= job.count) {
+            break;
+        }
+        try {
+            job.fn(job.context, i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.error_mutex);
+            if (!job.error) {
+                job.error = std::current_exception();
+            }
+            job.failed.store(true, std::memory_order_relaxed);
+        }
+        ++tasks;
+    }
+    tasks_done_.fetch_add(tasks, std::memory_order_relaxed);
+    busy_ns_.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+}
+
+void Executor::run(size_t count, size_t max_threads, TaskFn fn, void* context) {
+    if (count == 0) {
+        return;
+    }
+    const size_t pool = num_threads();
+    const size_t threads = std::min({max_threads == 0 ? pool : max_threads, pool, count});
+    const Clock::time_point start = Clock::now();
+
+    Job job;
+    job.count = count;
+    job.fn = fn;
+    job.context = context;
+    job.read_counter = current_read_counter();
+    job.max_helpers = threads - 1;
+
+    if (job.max_helpers != 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!started_) {
+                start_workers(num_threads() - 1);
+            }
+            jobs_.push_back(&job);
+        }
+        if (job.max_helpers == 1) {
+            work_cv_.notify_one();
+        } else {
+            work_cv_.notify_all();
+        }
+    }
+
+    participate(job);
+
+    if (job.max_helpers != 0) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+        done_cv_.wait(lock, [&]() { return job.active_helpers == 0; });
+    }
+
+    jobs_done_.fetch_add(1, std::memory_order_relaxed);
+    capacity_ns_.fetch_add(elapsed_ns(start) * threads, std::memory_order_relaxed);
+    if (job.error) {
+        std::rethrow_exception(job.error);
+    }
+}
+
+ExecutorStats Executor::stats() const {
+    ExecutorStats out;
+    out.num_threads = num_threads();
+    out.jobs = jobs_done_.load(std::memory_order_relaxed);
+    out.tasks = tasks_done_.load(std::memory_order_relaxed);
+    out.busy_seconds = static_cast<double>(busy_ns_.load(std::memory_order_relaxed)) * 1e-9;
+    out.capacity_seconds = static_cast<double>(capacity_ns_.load(std::memory_order_relaxed)) * 1e-9;
+    return out;
+}
+
+void Executor::reset_stats() {
+    jobs_done_.store(0, std::memory_order_relaxed);
+    tasks_done_.store(0, std::memory_order_relaxed);
+    busy_ns_.store(0, std::memory_order_relaxed);
+    capacity_ns_.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Utilization counters of the process-wide executor.
+ */
+struct ExecutorStats {
+    size_t num_threads = 0;       ///< Configured thread count (workers + calling thread)
+    uint64_t jobs = 0;            ///< parallel_for calls completed
+    uint64_t tasks = 0;           ///< Task indices executed
+    double busy_seconds = 0;      ///< Thread time spent running tasks
+    double capacity_seconds = 0;  ///< Sum over jobs of wall time x threads granted to the job
+};
+
+/**
+ * Process-wide pool of worker threads behind every parallel_for in specio3.
+ *
+ * One pool is shared by all parallel code paths, so concurrent or nested
+ * parallel calls share num_threads() threads instead of each spawning its
+ * own. A job's calling thread always works on it too, so a job completes
+ * even when every worker is busy elsewhere (which also makes nested calls
+ * from inside a task safe).
+ *
+ * Workers start on first use. The default size is the SPECIO3_NUM_THREADS
+ * environment variable if set, else the number of CPUs the process may run
+ * on (its inherited affinity mask, falling back to hardware threads). The pool
+ * is fork-safe: a child process starts with no workers and restarts them
+ * lazily.
+ */
+class Executor {
+public:
+    using TaskFn = void (*)(void* context, size_t index);
+
+    Executor();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /** Threads a job may use, counting the calling thread. */
+    size_t num_threads() const { return num_threads_.load(std::memory_order_relaxed); }
+
+    /**
+     * Resize the pool. Waits for workers to finish their current tasks.
+     *
+     * @param num_threads Threads including the caller (0 restores the default)
+     */
+    void set_num_threads(size_t num_threads);
+
+    /**
+     * Pin the workers to a set of CPUs (Linux only). The calling threads of
+     * jobs are not pinned.
+     *
+     * @param cpus CPU indices; empty restores the affinity the process started with
+     * @throws std::runtime_error if a CPU is invalid, offline or outside the
+     *         process's affinity mask, or pinning is unsupported
+     */
+    void set_affinity(const std::vector<int>& cpus);
+
+    std::vector<int> affinity() const;
+
+    /**
+     * Run fn(context, i) for every i in [0, count) on the calling thread and
+     * up to max_threads - 1 idle workers. Workers attribute their allocations
+     * to the caller's read (see ReadAllocationScope).
+     *
+     * @param max_threads Thread limit for this job (0 = num_threads()); never exceeds num_threads()
+     * @throws The first exception raised by any task, after all helpers have left the job
+     */
+    void run(size_t count, size_t max_threads, TaskFn fn, void* context);
+
+    ExecutorStats stats() const;
+    void reset_stats();
+
+private:
+    friend Executor& global_executor();
+    struct Job;
+
+    void start_workers(size_t count);
+    void worker_loop();
+    void participate(Job& job);
+    Job* find_job() const;
+    int apply_affinity(std::thread& thread) const;  ///< Returns 0 or an errno value
+
+    static void prepare_fork();
+    static void parent_after_fork();
+    static void child_after_fork();
+
+    std::atomic<size_t> num_threads_{1};
+    std::mutex config_mutex_;  ///< Serializes resizing and fork
+
+    mutable std::mutex mutex_;  ///< Guards everything below
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::vector<Job*> jobs_;
+    std::vector<std::thread>* workers_;
+    std::vector<int> affinity_;
+    std::vector<int> inherited_affinity_;  ///< Process mask at construction (empty off Linux)
+    bool started_ = false;
+    bool stopping_ = false;
+
+    std::atomic<uint64_t> jobs_done_{0};
+    std::atomic<uint64_t> tasks_done_{0};
+    std::atomic<uint64_t> busy_ns_{0};
+    std::atomic<uint64_t> capacity_ns_{0};
+};
+
+/**
+ * The process-wide executor. Never destroyed, so workers cannot be torn
+ * down underneath a late caller during interpreter shutdown.
+ */
+Executor& global_executor();
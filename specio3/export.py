@@ -0,0 +1,73 @@
+"""Export of SPC collections to chunked array stores."""
+import os
+from typing import Optional, Sequence, Tuple
+
+from . import _specio3
+from .library import PathLike
+
+
+def export_zarr(
+    paths: Sequence[PathLike],
+    output: PathLike,
+    chunks: Tuple[int, Optional[int]] = (1024, None),
+    zarr_format: int = 2,
+    num_threads: int = 0,
+) -> int:
+    """
+    Write SPC files as a chunked Zarr directory store.
+
+    The files are decoded and the chunks written in parallel by the native
+    reader, without going through NumPy or the zarr package. The store is a
+    group with three float64 arrays, readable with ``zarr.open`` or
+    ``xarray.open_zarr``:
+
+    - ``y``, shape ``(n_spectra, n_points)``: every subfile of every file, in order
+    - ``x``, shape ``(n_points,)``: the common X axis
+    - ``z``, shape ``(n_spectra,)``: the Z (start) value of each subfile
+
+    The group attributes list every source file with its first row, subfile
+    count and header fields. Chunks are stored uncompressed (raw
+    little-endian bytes), so any Zarr reader can open them without codecs.
+
+    Parameters
+    ----------
+    paths : sequence of str or PathLike
+        Y-only or XY SPC files with the same number of points.
+    output : str or PathLike
+        Directory to create. Existing chunk files are overwritten.
+    chunks : (int, int or None), default (1024, None)
+        Spectra and points per chunk of ``y``; None keeps whole spectra.
+    zarr_format : {2, 3}, default 2
+        Zarr specification version to write.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    int
+        Number of spectra written.
+
+    Raises
+    ------
+    RuntimeError
+        If an input cannot be read, the files do not share an X axis or the
+        store cannot be written.
+
+    Examples
+    --------
+    >>> specio3.export_zarr(sorted(glob.glob("run/*.spc")), "run.zarr", chunks=(4096, None))
+    100000
+    >>> y = zarr.open("run.zarr")["y"]
+    """
+    rows, points = chunks
+    return _specio3.export_zarr(
+        [os.fspath(p) for p in paths],
+        os.fspath(output),
+        int(zarr_format),
+        int(rows),
+        0 if points is None else int(points),
+        int(num_threads),
+    )
+
+
+__all__ = ["export_zarr"]
@@ -0,0 +1,92 @@
+"""Open SPC file handle shared between threads."""
+import os
+from typing import Iterator, Optional
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+from .library import PathLike
+from .spectrum import Spectrum
+
+
+class SPCHandle:
+    """
+    Memory-mapped SPC file whose subfiles can be decoded from many threads at once.
+
+    The headers are parsed once when the handle is opened. Reads only touch
+    the mapping at precomputed offsets -- there is no shared file position --
+    and release the GIL, so threads sharing one handle decode different (or
+    the same) subfiles in parallel without any locking.
+
+    Parameters
+    ----------
+    path : str or PathLike
+        SPC file to open.
+
+    Raises
+    ------
+    RuntimeError
+        If the file cannot be mapped, its header is invalid or a subfile
+        extends past the end of the file.
+
+    Examples
+    --------
+    >>> from concurrent.futures import ThreadPoolExecutor
+    >>> handle = specio3.SPCHandle("kinetics.spc")
+    >>> with ThreadPoolExecutor(8) as pool:
+    ...     peaks = list(pool.map(lambda i: handle.read(i).y.max(), range(len(handle))))
+    """
+
+    def __init__(self, path: PathLike):
+        self._handle = _specio3.SPCHandle(os.fspath(path))
+
+    def __len__(self) -> int:
+        return len(self._handle)
+
+    def __iter__(self) -> Iterator[Spectrum]:
+        return (self.read(i) for i in range(len(self)))
+
+    @property
+    def path(self) -> str:
+        """Path the handle was opened with."""
+        return self._handle.path
+
+    @property
+    def z(self) -> NDArray[np.float64]:
+        """Z (start) value of each subfile."""
+        return self._handle.z
+
+    def _index(self, index: int) -> int:
+        index = int(index)
+        if index < 0:
+            index += len(self)
+        if not 0 <= index < len(self):
+            raise IndexError(f"subfile index {index} out of range for {len(self)} subfiles")
+        return index
+
+    def num_points(self, index: int) -> int:
+        """Number of points in a subfile."""
+        return self._handle.num_points(self._index(index))
+
+    def read(self, index: int) -> Spectrum:
+        """Decode one subfile; the same values :func:`read_spc` returns for it."""
+        return Spectrum(*self._handle.read(self._index(index)))
+
+    def read_y(self, index: int, start: int = 0, stop: Optional[int] = None) -> NDArray[np.float64]:
+        """
+        Decode Y values ``[start, stop)`` of one subfile without touching the rest.
+
+        Parameters
+        ----------
+        index : int
+            Subfile index.
+        start, stop : int, optional
+            Point range, as in slicing (negative values count from the end).
+        """
+        index = self._index(index)
+        start, stop, _ = slice(start, stop).indices(self._handle.num_points(index))
+        return self._handle.read_y(index, start, max(stop - start, 0))
+
+
+__all__ = ["SPCHandle"]
@@ -0,0 +1,144 @@
+"""Exact similarity search against a memory-mapped spectral library."""
+import os
+from typing import Sequence, Tuple, Union
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+
+PathLike = Union[str, os.PathLike]
+Query = Union[PathLike, Tuple[NDArray, NDArray], NDArray]
+
+
+def _prepare_queries(native, query: Query) -> NDArray[np.float32]:
+    """Turn a path, (x, y) pair or on-grid array into a 2-D query matrix for ``native``."""
+    if isinstance(query, (str, os.PathLike)):
+        return native.resample_file(os.fspath(query))
+    if isinstance(query, tuple):
+        x, y = query
+        return native.resample(x, y)[np.newaxis, :]
+    return np.atleast_2d(np.asarray(query, dtype=np.float32))
+
+
+def build_library(
+    paths: Sequence[PathLike],
+    output: PathLike,
+    x_min: float,
+    x_max: float,
+    num_points: int,
+    metric: str = "pearson",
+    num_threads: int = 0,
+) -> "SpectralLibrary":
+    """
+    Build a spectral library file from SPC files and open it.
+
+    Every subfile of every input becomes one library row. Rows are linearly
+    resampled onto ``num_points`` evenly spaced X values between ``x_min`` and
+    ``x_max`` (edge values are held outside a spectrum's range, as in
+    ``numpy.interp``), normalized for ``metric`` and stored as float32.
+    Files are decoded in parallel and streamed to disk, so libraries larger
+    than RAM can be built.
+
+    Parameters
+    ----------
+    paths : sequence of str or PathLike
+        SPC files to include.
+    output : str or PathLike
+        Library file to write. An existing file is overwritten.
+    x_min, x_max : float
+        First and last grid X values.
+    num_points : int
+        Number of grid points.
+    metric : {"pearson", "cosine"}, default "pearson"
+        Similarity the library will be searched with.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    SpectralLibrary
+        The newly written library, memory-mapped.
+
+    Raises
+    ------
+    RuntimeError
+        If an input file cannot be read or the output cannot be written.
+    """
+    _specio3.build_library(
+        [os.fspath(p) for p in paths],
+        os.fspath(output),
+        float(x_min),
+        float(x_max),
+        int(num_points),
+        metric,
+        int(num_threads),
+    )
+    return SpectralLibrary(output)
+
+
+class SpectralLibrary:
+    """
+    Memory-mapped spectral library built by :func:`build_library`.
+
+    Opening a library is cheap; pages are loaded on demand by the OS and
+    shared between processes that open the same file.
+
+    Examples
+    --------
+    >>> lib = specio3.build_library(paths, "ref.spclib", 400.0, 4000.0, 2048)
+    >>> indices, scores = lib.search("unknown.spc", k=5)
+    >>> lib.entry(indices[0, 0])
+    ('ref/sample_017.spc', 0)
+    """
+
+    def __init__(self, path: PathLike):
+        self._lib = _specio3.SpectralLibrary(os.fspath(path))
+
+    def __len__(self) -> int:
+        return len(self._lib)
+
+    @property
+    def metric(self) -> str:
+        """Similarity metric the library was built for."""
+        return self._lib.metric
+
+    @property
+    def grid(self) -> NDArray[np.float64]:
+        """X values of the library grid."""
+        return np.linspace(self._lib.x_min, self._lib.x_max, self._lib.num_points)
+
+    def entry(self, index: int) -> Tuple[str, int]:
+        """Return the ``(source_path, subfile_index)`` of library row ``index``."""
+        index = int(index)
+        return self._lib.name(index), self._lib.subfile_index(index)
+
+    def search(
+        self, query: Query, k: int = 10, num_threads: int = 0
+    ) -> Tuple[NDArray[np.int64], NDArray[np.float32]]:
+        """
+        Find the ``k`` most similar library rows for each query spectrum.
+
+        Parameters
+        ----------
+        query : str, PathLike, (x, y) tuple or ndarray
+            A path searches with every subfile of that SPC file. An ``(x, y)``
+            tuple is resampled onto the library grid. A 1-D or 2-D array is
+            taken to be already on the grid (``len(grid)`` columns).
+        k : int, default 10
+            Number of hits per query.
+        num_threads : int, default 0
+            Worker threads; 0 uses every core.
+
+        Returns
+        -------
+        indices : ndarray of int64, shape (n_queries, k)
+            Library rows ordered from most to least similar.
+        scores : ndarray of float32, shape (n_queries, k)
+            Cosine similarity or Pearson correlation of each hit.
+        """
+        queries = _prepare_queries(self._lib, query)
+        return self._lib.search(queries, int(k), int(num_threads))
+
+
+__all__ = ["build_library", "SpectralLibrary"]
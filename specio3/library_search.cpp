@@ -0,0 +1,253 @@
+#include "library_search.h"
+#include "parallel.h"
+#include "spc_reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+static constexpr char kLibraryMagic[8] = {'S', 'P', 'C', 'L', 'I', 'B', '\0', '\0'};
+static constexpr uint32_t kLibraryVersion = 1;
+static constexpr uint64_t kMatrixAlignment = 64;
+
+// Queries scored together against each library row; sized so a block of
+// typical (a few thousand point) queries stays resident in L2.
+static constexpr size_t kQueryBlock = 16;
+
+std::vector<float> resample_spc_file(const std::string& path, const SpectralGrid& grid) {
+    SPCFile spc = read_spc_impl(path);
+    std::vector<float> rows(spc.subfiles.size() * grid.num_points);
+    for (size_t si = 0; si < spc.subfiles.size(); ++si) {
+        const Subfile& s = spc.subfiles[si];
+        resample_to_grid(s.x.data(), s.y.data(), std::min(s.x.size(), s.y.size()), grid,
+                         rows.data() + si * grid.num_points);
+    }
+    return rows;
+}
+
+void stream_resampled_spectra(const std::vector<std::string>& paths, const SpectralGrid& grid,
+                              SimilarityMetric metric, size_t num_threads, const ResampledSink& sink) {
+    validate_grid(grid);
+    if (num_threads == 0) {
+        num_threads = default_num_threads();
+    }
+
+    // Decode a batch in parallel, then hand it over in input order.
+    const size_t batch_size = std::max<size_t>(64, num_threads * 4);
+    std::vector<std::vector<float>> batch_rows;
+    for (size_t start = 0; start < paths.size(); start += batch_size) {
+        const size_t count = std::min(batch_size, paths.size() - start);
+        batch_rows.assign(count, {});
+
+        parallel_for(count, num_threads, [&](size_t i) {
+            const std::string& path = paths[start + i];
+            try {
+                batch_rows[i] = resample_spc_file(path, grid);
+            } catch (const std::exception& e) {
+                throw std::runtime_error("Failed to read '" + path + "': " + e.what());
+            }
+            const size_t num_rows = batch_rows[i].size() / grid.num_points;
+            for (size_t r = 0; r < num_rows; ++r) {
+                normalize_spectrum(batch_rows[i].data() + r * grid.num_points, grid.num_points, metric);
+            }
+        });
+
+        for (size_t i = 0; i < count; ++i) {
+            sink(paths[start + i], batch_rows[i].data(), batch_rows[i].size() / grid.num_points);
+            batch_rows[i].clear();
+            batch_rows[i].shrink_to_fit();
+        }
+    }
+}
+
+uint64_t build_spectral_library(const std::vector<std::string>& paths, const SpectralGrid& grid,
+                                SimilarityMetric metric, const std::string& output_path,
+                                size_t num_threads) {
+    validate_grid(grid);
+
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Unable to create library file: " + output_path);
+    }
+
+    LibraryFileHeader header = {};
+    std::memcpy(header.magic, kLibraryMagic, sizeof(kLibraryMagic));
+    header.version = kLibraryVersion;
+    header.metric = static_cast<uint32_t>(metric);
+    header.num_points = grid.num_points;
+    header.x_min = grid.x_min;
+    header.x_max = grid.x_max;
+    header.matrix_offset = (sizeof(LibraryFileHeader) + kMatrixAlignment - 1) / kMatrixAlignment * kMatrixAlignment;
+
+    // Placeholder header; rewritten once the counts are known.
+    std::vector<char> pad(header.matrix_offset, 0);
+    out.write(pad.data(), static_cast<std::streamsize>(pad.size()));
+
+    std::vector<LibraryEntryRaw> entries;
+    std::string names;
+    stream_resampled_spectra(paths, grid, metric, num_threads,
+                             [&](const std::string& path, const float* rows, size_t num_rows) {
+        out.write(reinterpret_cast<const char*>(rows),
+                  static_cast<std::streamsize>(num_rows * grid.num_points * sizeof(float)));
+        for (size_t r = 0; r < num_rows; ++r) {
+            LibraryEntryRaw e = {};
+            e.name_offset = names.size();
+            e.name_length = static_cast<uint32_t>(path.size());
+            e.subfile_index = static_cast<uint32_t>(r);
+            entries.push_back(e);
+        }
+        names += path;
+    });
+
+    header.num_entries = entries.size();
+    header.entries_offset = header.matrix_offset + header.num_entries * grid.num_points * sizeof(float);
+    header.names_offset = header.entries_offset + header.num_entries * sizeof(LibraryEntryRaw);
+    header.names_size = names.size();
+
+    out.write(reinterpret_cast<const char*>(entries.data()),
+              static_cast<std::streamsize>(entries.size() * sizeof(LibraryEntryRaw)));
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+    out.seekp(0, std::ios::beg);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Failed writing library file: " + output_path);
+    }
+    return header.num_entries;
+}
+
+SpectralLibrary::SpectralLibrary(const std::string& path) : file_(path) {
+    if (file_.size() < sizeof(LibraryFileHeader)) {
+        throw std::runtime_error("Not a spectral library (file too small): " + path);
+    }
+    header_ = reinterpret_cast<const LibraryFileHeader*>(file_.data());
+    if (std::memcmp(header_->magic, kLibraryMagic, sizeof(kLibraryMagic)) != 0) {
+        throw std::runtime_error("Not a spectral library (bad magic): " + path);
+    }
+    if (header_->version != kLibraryVersion) {
+        throw std::runtime_error("Unsupported spectral library version " + std::to_string(header_->version) +
+                                 ": " + path);
+    }
+    if (header_->metric > static_cast<uint32_t>(SimilarityMetric::Pearson)) {
+        throw std::runtime_error("Spectral library has an unknown metric: " + path);
+    }
+
+    grid_.x_min = header_->x_min;
+    grid_.x_max = header_->x_max;
+    grid_.num_points = header_->num_points;
+    validate_grid(grid_);
+
+    const uint64_t matrix_bytes = header_->num_entries * grid_.num_points * sizeof(float);
+    if (header_->matrix_offset % alignof(float) != 0 ||
+        header_->entries_offset != header_->matrix_offset + matrix_bytes ||
+        header_->names_offset != header_->entries_offset + header_->num_entries * sizeof(LibraryEntryRaw) ||
+        header_->names_offset + header_->names_size > file_.size()) {
+        throw std::runtime_error("Spectral library is truncated or corrupt: " + path);
+    }
+
+    matrix_ = reinterpret_cast<const float*>(file_.data() + header_->matrix_offset);
+    entries_ = reinterpret_cast<const LibraryEntryRaw*>(file_.data() + header_->entries_offset);
+    names_ = file_.data() + header_->names_offset;
+}
+
+std::string SpectralLibrary::name(size_t i) const {
+    if (i >= size()) {
+        throw std::out_of_range("Library index out of range: " + std::to_string(i));
+    }
+    const LibraryEntryRaw& e = entries_[i];
+    if (e.name_offset + e.name_length > header_->names_size) {
+        throw std::runtime_error("Spectral library entry " + std::to_string(i) + " has an invalid name");
+    }
+    return std::string(names_ + e.name_offset, e.name_length);
+}
+
+uint32_t SpectralLibrary::subfile_index(size_t i) const {
+    if (i >= size()) {
+        throw std::out_of_range("Library index out of range: " + std::to_string(i));
+    }
+    return entries_[i].subfile_index;
+}
+
+std::vector<float> SpectralLibrary::resample_file(const std::string& path) const {
+    return resample_spc_file(path, grid_);
+}
+
+SearchResult SpectralLibrary::search(const float* queries, size_t num_queries, size_t k,
+                                     size_t num_threads) const {
+    const size_t n = size();
+    const size_t dim = grid_.num_points;
+
+    SearchResult result;
+    result.num_queries = num_queries;
+    result.k = std::min(k, n);
+    if (num_queries == 0 || result.k == 0) {
+        result.k = 0;
+        return result;
+    }
+    k = result.k;
+
+    std::vector<float> normalized(queries, queries + num_queries * dim);
+    for (size_t q = 0; q < num_queries; ++q) {
+        normalize_spectrum(normalized.data() + q * dim, dim, metric());
+    }
+
+    if (num_threads == 0) {
+        num_threads = default_num_threads();
+    }
+    // Each task owns a contiguous row range and its own min-heaps, so the
+    // scoring loop needs no synchronization.
+    const size_t num_tasks = std::max<size_t>(1, std::min(num_threads, n / 256 + 1));
+    using Hit = std::pair<float, int64_t>;
+    std::vector<std::vector<std::vector<Hit>>> heaps(num_tasks, std::vector<std::vector<Hit>>(num_queries));
+    const auto worse = std::greater<Hit>();
+
+    parallel_for(num_tasks, num_threads, [&](size_t task) {
+        const size_t row_begin = n * task / num_tasks;
+        const size_t row_end = n * (task + 1) / num_tasks;
+        auto& task_heaps = heaps[task];
+        for (auto& h : task_heaps) {
+            h.reserve(k);
+        }
+
+        for (size_t qb = 0; qb < num_queries; qb += kQueryBlock) {
+            const size_t qe = std::min(num_queries, qb + kQueryBlock);
+            for (size_t r = row_begin; r < row_end; ++r) {
+                const float* lib_row = row(r);
+                for (size_t q = qb; q < qe; ++q) {
+                    const float score = dot_f32(lib_row, normalized.data() + q * dim, dim);
+                    auto& h = task_heaps[q];
+                    if (h.size() < k) {
+                        h.emplace_back(score, static_cast<int64_t>(r));
+                        std::push_heap(h.begin(), h.end(), worse);
+                    } else if (score > h.front().first) {
+                        std::pop_heap(h.begin(), h.end(), worse);
+                        h.back() = Hit(score, static_cast<int64_t>(r));
+                        std::push_heap(h.begin(), h.end(), worse);
+                    }
+                }
+            }
+        }
+    });
+
+    result.indices.resize(num_queries * k);
+    result.scores.resize(num_queries * k);
+    std::vector<Hit> merged;
+    for (size_t q = 0; q < num_queries; ++q) {
+        merged.clear();
+        for (size_t t = 0; t < num_tasks; ++t) {
+            merged.insert(merged.end(), heaps[t][q].begin(), heaps[t][q].end());
+        }
+        std::partial_sort(merged.begin(), merged.begin() + static_cast<std::ptrdiff_t>(k), merged.end(),
+                          [](const Hit& a, const Hit& b) {
+                              return a.first > b.first || (a.first == b.first && a.second < b.second);
+                          });
+        for (size_t j = 0; j < k; ++j) {
+            result.scores[q * k + j] = merged[j].first;
+            result.indices[q * k + j] = merged[j].second;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mapped_file.h"
+#include "spectral_grid.h"
+
+/**
+ * On-disk header of a spectral library file (.spclib).
+ *
+ * Layout: this 128-byte header, then a row-major float32 matrix of
+ * num_entries x num_points normalized spectra starting at matrix_offset
+ * (64-byte aligned), then num_entries LibraryEntryRaw records at
+ * entries_offset, then the UTF-8 name blob they point into.
+ * All integers are little-endian.
+ */
+struct LibraryFileHeader {
+    char magic[8];            ///< "SPCLIB\0\0"
+    uint32_t version;         ///< Format version (currently 1)
+    uint32_t metric;          ///< SimilarityMetric the rows were normalized for
+    uint64_t num_entries;     ///< Number of rows (one per subfile)
+    uint32_t num_points;      ///< Grid length (columns)
+    uint32_t reserved0;
+    double x_min;             ///< First grid X value
+    double x_max;             ///< Last grid X value
+    uint64_t matrix_offset;   ///< Byte offset of the float32 matrix
+    uint64_t entries_offset;  ///< Byte offset of the entry table
+    uint64_t names_offset;    ///< Byte offset of the name blob
+    uint64_t names_size;      ///< Size of the name blob in bytes
+    char reserved[48];
+};
+static_assert(sizeof(LibraryFileHeader) == 128, "LibraryFileHeader must be 128 bytes");
+
+/**
+ * On-disk record describing where a library row came from.
+ */
+struct LibraryEntryRaw {
+    uint64_t name_offset;    ///< Offset of the source path within the name blob
+    uint32_t name_length;    ///< Length of the source path in bytes
+    uint32_t subfile_index;  ///< Subfile index within the source file
+};
+static_assert(sizeof(LibraryEntryRaw) == 16, "LibraryEntryRaw must be 16 bytes");
+
+/**
+ * Top-k search results for a batch of queries, stored row-major
+ * (num_queries x k). Rows are sorted by descending score.
+ */
+struct SearchResult {
+    size_t num_queries = 0;
+    size_t k = 0;
+    std::vector<int64_t> indices;  ///< Library row of each hit
+    std::vector<float> scores;     ///< Similarity of each hit
+};
+
+/**
+ * Decode one SPC file and resample every subfile onto a grid.
+ *
+ * @param path SPC file
+ * @param grid Target grid
+ * @return Row-major (num_subfiles x grid.num_points) matrix, not yet normalized
+ */
+std::vector<float> resample_spc_file(const std::string& path, const SpectralGrid& grid);
+
+/// Receives one decoded file: its path, its normalized rows and the row count.
+using ResampledSink = std::function<void(const std::string& path, const float* rows, size_t num_rows)>;
+
+/**
+ * Decode, resample and normalize SPC files in parallel batches and pass each
+ * file's rows to a sink in input order. Memory use is bounded by one batch
+ * regardless of how many files are streamed.
+ *
+ * @param paths SPC files to decode
+ * @param grid Common X grid
+ * @param metric Normalization to apply to each row
+ * @param num_threads Worker threads (0 = all cores)
+ * @param sink Called on the calling thread, once per file, in input order
+ * @throws std::runtime_error naming the file if any input cannot be read
+ */
+void stream_resampled_spectra(const std::vector<std::string>& paths, const SpectralGrid& grid,
+                              SimilarityMetric metric, size_t num_threads, const ResampledSink& sink);
+
+/**
+ * Build a library file from SPC files.
+ * Every subfile of every input becomes one row: it is resampled onto the
+ * grid, normalized for the metric and stored as float32. Files are streamed
+ * through stream_resampled_spectra(), so libraries larger than RAM can be built.
+ *
+ * @param paths SPC files to include
+ * @param grid Common X grid
+ * @param metric Similarity metric the library will be searched with
+ * @param output_path Path of the library file to write
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Number of rows written
+ * @throws std::runtime_error if an input cannot be read or the output cannot be written
+ */
+uint64_t build_spectral_library(const std::vector<std::string>& paths, const SpectralGrid& grid,
+                                SimilarityMetric metric, const std::string& output_path,
+                                size_t num_threads);
+
+/**
+ * Read-only, memory-mapped spectral library.
+ * Opening is O(1): the matrix is paged in by the OS as searches touch it,
+ * and several processes opening the same file share the page cache.
+ */
+class SpectralLibrary {
+public:
+    /**
+     * Map a library file written by build_spectral_library().
+     *
+     * @param path Library file path
+     * @throws std::runtime_error if the file is missing, truncated or not a library
+     */
+    explicit SpectralLibrary(const std::string& path);
+
+    size_t size() const { return static_cast<size_t>(header_->num_entries); }
+    uint32_t num_points() const { return grid_.num_points; }
+    const SpectralGrid& grid() const { return grid_; }
+    SimilarityMetric metric() const { return static_cast<SimilarityMetric>(header_->metric); }
+
+    /// Normalized row i (num_points floats).
+    const float* row(size_t i) const { return matrix_ + i * grid_.num_points; }
+
+    /// Source path of row i.
+    std::string name(size_t i) const;
+
+    /// Subfile index of row i within its source path.
+    uint32_t subfile_index(size_t i) const;
+
+    /**
+     * Resample every subfile of an SPC file onto the library grid.
+     *
+     * @param path SPC file
+     * @return Row-major (num_subfiles x num_points) matrix, not yet normalized
+     */
+    std::vector<float> resample_file(const std::string& path) const;
+
+    /**
+     * Find the k most similar rows for each query.
+     * Queries must already be on the library grid; they are normalized
+     * internally. Rows are split across threads, and each thread scores a
+     * block of queries against every row it owns so each library row is
+     * streamed from memory once per query block.
+     *
+     * @param queries Row-major (num_queries x num_points) matrix
+     * @param num_queries Number of queries
+     * @param k Hits per query (clamped to the library size)
+     * @param num_threads Worker threads (0 = all cores)
+     * @return Top-k indices and scores
+     */
+    SearchResult search(const float* queries, size_t num_queries, size_t k, size_t num_threads) const;
+
+private:
+    MappedFile file_;
+    const LibraryFileHeader* header_ = nullptr;
+    const float* matrix_ = nullptr;
+    const LibraryEntryRaw* entries_ = nullptr;
+    const char* names_ = nullptr;
+    SpectralGrid grid_;
+};
@@ -0,0 +1,193 @@
+#include "loader.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+// Rows decoded per task. Shuffled rows rarely share a file, so each row
+// opens its own; small tasks keep the threads of a small batch busy.
+constexpr size_t kRowsPerTask = 4;
+
+}  // namespace
+
+tracked_vector<float> FloatBufferPool::acquire(size_t size) {
+    tracked_vector<float> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            buffer = std::move(free_.back());
+            free_.pop_back();
+        }
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+void FloatBufferPool::release(tracked_vector<float>&& buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.size() < max_buffers_) {
+        free_.push_back(std::move(buffer));
+    }
+}
+
+size_t FloatBufferPool::num_free() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_.size();
+}
+
+BatchLoader::BatchLoader(const std::vector<std::string>& paths, size_t batch_size, bool shuffle, uint64_t seed,
+                         bool drop_last, size_t prefetch, size_t num_threads)
+    : dataset_(paths, num_threads), batch_size_(batch_size), shuffle_(shuffle), seed_(seed),
+      drop_last_(drop_last), prefetch_(prefetch), num_threads_(num_threads),
+      // The prefetched batches, the one being decoded and the one the consumer holds
+      pool_(std::make_shared<FloatBufferPool>(prefetch + 2)) {
+    if (batch_size == 0) {
+        throw std::runtime_error("batch_size must be at least 1");
+    }
+}
+
+BatchLoader::~BatchLoader() {
+    stop_producer();
+}
+
+size_t BatchLoader::num_batches() const {
+    const size_t rows = dataset_.num_rows();
+    return drop_last_ ? rows / batch_size_ : (rows + batch_size_ - 1) / batch_size_;
+}
+
+void BatchLoader::start_epoch(uint64_t epoch) {
+    std::lock_guard<std::mutex> consumer(consumer_mutex_);
+    stop_producer();
+
+    order_.resize(dataset_.num_rows());
+    std::iota(order_.begin(), order_.end(), size_t{0});
+    if (shuffle_) {
+        // Fisher-Yates on raw engine output: std::shuffle and the standard
+        // distributions are implementation-defined, mt19937_64 is not
+        std::mt19937_64 rng(seed_ ^ (epoch * 0x9E3779B97F4A7C15ULL));
+        for (size_t i = order_.size(); i > 1; --i) {
+            std::swap(order_[i - 1], order_[static_cast<size_t>(rng() % i)]);
+        }
+    }
+    epoch_batches_ = num_batches();
+    consumed_ = 0;
+
+    if (prefetch_ > 0) {
+        producer_ = std::thread([this] { produce(); });
+    }
+}
+
+bool BatchLoader::next(LoaderBatch& batch) {
+    std::lock_guard<std::mutex> consumer(consumer_mutex_);
+    if (consumed_ >= epoch_batches_) {
+        return false;
+    }
+    if (prefetch_ == 0) {
+        batch = decode(consumed_++);
+        return true;
+    }
+    Ready item;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return !ready_.empty(); });
+        item = std::move(ready_.front());
+        ready_.pop_front();
+    }
+    cv_.notify_all();
+    ++consumed_;
+    if (item.error) {
+        consumed_ = epoch_batches_;
+        std::rethrow_exception(item.error);
+    }
+    batch = std::move(item.batch);
+    return true;
+}
+
+LoaderBatch BatchLoader::decode(size_t index) const {
+    const size_t first = index * batch_size_;
+    const size_t count = std::min(batch_size_, order_.size() - first);
+    const size_t num_points = dataset_.num_points();
+    const SPCBatch& files = dataset_.batch();
+
+    LoaderBatch batch;
+    batch.num_rows = count;
+    batch.rows.assign(order_.begin() + first, order_.begin() + first + count);
+    batch.values = pool_->acquire(count * num_points);
+
+    const size_t num_tasks = (count + kRowsPerTask - 1) / kRowsPerTask;
+    parallel_for(num_tasks, num_threads_, [&](size_t t) {
+        const size_t end = std::min(count, (t + 1) * kRowsPerTask);
+        std::ifstream f;
+        tracked_vector<char> raw;
+        tracked_vector<double> values(num_points);
+        for (size_t r = t * kRowsPerTask; r < end; ++r) {
+            const auto [file, subfile] = dataset_.locate(static_cast<size_t>(batch.rows[r]));
+            const std::string& path = files.paths[file];
+            f.close();
+            f.clear();
+            f.open(path, std::ios::binary);
+            if (!f) {
+                throw std::runtime_error("Unable to open file: " + path);
+            }
+            const SPCLayout& layout = files.layouts[file];
+            try {
+                read_subfile_y(f, layout, layout.subfiles[subfile], 0, num_points, raw, values.data());
+            } catch (const std::exception& e) {
+                throw std::runtime_error(path + ": " + e.what());
+            }
+            std::copy(values.begin(), values.end(), batch.values.data() + r * num_points);
+        }
+    });
+    return batch;
+}
+
+void BatchLoader::produce() {
+    for (size_t index = 0; index < epoch_batches_; ++index) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return stop_ || ready_.size() < prefetch_; });
+            if (stop_) {
+                return;
+            }
+        }
+        Ready item;
+        try {
+            item.batch = decode(index);
+        } catch (...) {
+            item.error = std::current_exception();
+        }
+        const bool failed = static_cast<bool>(item.error);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(std::move(item));
+        }
+        cv_.notify_all();
+        if (failed) {
+            return;
+        }
+    }
+}
+
+void BatchLoader::stop_producer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (producer_.joinable()) {
+        producer_.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Ready& item : ready_) {
+        if (!item.error) {
+            pool_->release(std::move(item.batch.values));
+        }
+    }
+    ready_.clear();
+    stop_ = false;
+}
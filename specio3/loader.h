@@ -0,0 +1,137 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "alloc_tracking.h"
+#include "virtual_dataset.h"
+
+/**
+ * Free list of float buffers, shared by a BatchLoader and the arrays it
+ * hands out. A buffer comes back when the consumer drops its batch, so a
+ * steady training loop cycles through the same few allocations.
+ */
+class FloatBufferPool {
+public:
+    /** @param max_buffers Free buffers kept; extra returned buffers are freed */
+    explicit FloatBufferPool(size_t max_buffers) : max_buffers_(max_buffers) {}
+
+    /** A buffer of size floats (contents unspecified), reused if one is free. */
+    tracked_vector<float> acquire(size_t size);
+
+    /** Return a buffer to the pool. Thread-safe. */
+    void release(tracked_vector<float>&& buffer);
+
+    /** Buffers currently free. */
+    size_t num_free() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<tracked_vector<float>> free_;
+    size_t max_buffers_;
+};
+
+/** One decoded batch of a BatchLoader. */
+struct LoaderBatch {
+    size_t num_rows = 0;
+    tracked_vector<float> values;  ///< num_rows x num_points, row-major, from the loader's pool
+    tracked_vector<int64_t> rows;  ///< Dataset row of each batch row
+};
+
+/**
+ * Iterates the rows (subfiles) of a set of same-shape SPC files in
+ * batches, decoding ahead in the background.
+ *
+ * For each epoch a producer thread decodes up to `prefetch` batches ahead of
+ * the consumer, each one in parallel on the process-wide executor, into
+ * float32 buffers drawn from a FloatBufferPool. Shuffled epochs use a
+ * Fisher-Yates permutation driven by std::mt19937_64 seeded from the seed
+ * and the epoch number, so the order is the same on every platform.
+ *
+ * next() and start_epoch() may be called from several threads (the module
+ * does not hold the GIL on free-threaded Python); each call takes the
+ * consumer mutex, so concurrent callers receive distinct batches.
+ */
+class BatchLoader {
+public:
+    /**
+     * Probe the headers of every file (see VirtualDataset).
+     *
+     * @param paths SPC files sharing one X axis
+     * @param batch_size Rows per batch (> 0)
+     * @param shuffle Visit the rows in a seeded random order
+     * @param seed Shuffle seed
+     * @param drop_last Skip a final batch smaller than batch_size
+     * @param prefetch Batches decoded ahead in the background; 0 decodes in next()
+     * @param num_threads Worker threads per batch (0 = all cores)
+     * @throws std::runtime_error if a header cannot be read, the files do not
+     *         share an X axis or batch_size is 0
+     */
+    BatchLoader(const std::vector<std::string>& paths, size_t batch_size, bool shuffle, uint64_t seed,
+                bool drop_last, size_t prefetch, size_t num_threads);
+    ~BatchLoader();
+
+    BatchLoader(const BatchLoader&) = delete;
+    BatchLoader& operator=(const BatchLoader&) = delete;
+
+    const VirtualDataset& dataset() const { return dataset_; }
+    size_t batch_size() const { return batch_size_; }
+    size_t num_batches() const;
+    const std::shared_ptr<FloatBufferPool>& pool() const { return pool_; }
+
+    /**
+     * Start an epoch, abandoning any batches left from the previous one, and
+     * begin decoding its first batches in the background.
+     *
+     * @param epoch Epoch number; with shuffle, selects the row order
+     */
+    void start_epoch(uint64_t epoch);
+
+    /**
+     * Take the next batch of the current epoch, waiting for it if needed.
+     *
+     * @param batch Receives the batch
+     * @return false once the epoch is exhausted (or before the first start_epoch())
+     * @throws std::runtime_error naming the file if a row could not be read;
+     *         the epoch then ends
+     */
+    bool next(LoaderBatch& batch);
+
+private:
+    struct Ready {
+        LoaderBatch batch;
+        std::exception_ptr error;
+    };
+
+    LoaderBatch decode(size_t index) const;
+    void produce();
+    void stop_producer();
+
+    VirtualDataset dataset_;
+    size_t batch_size_;
+    bool shuffle_;
+    uint64_t seed_;
+    bool drop_last_;
+    size_t prefetch_;
+    size_t num_threads_;
+    std::shared_ptr<FloatBufferPool> pool_;
+
+    std::mutex consumer_mutex_;  ///< Serializes next() and start_epoch(); guards the three below
+    std::vector<size_t> order_;  ///< Row order of the current epoch
+    size_t epoch_batches_ = 0;
+    size_t consumed_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Ready> ready_;
+    bool stop_ = false;
+    std::thread producer_;
+};
@@ -0,0 +1,135 @@
+"""Batched, prefetching iteration over many SPC files for training loops."""
+import os
+from typing import Iterator, NamedTuple, Sequence
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+from .library import PathLike
+
+
+class LoaderBatch(NamedTuple):
+    """One batch of a :class:`Loader`."""
+
+    y: NDArray[np.float32]  # (batch_rows, num_points)
+    rows: NDArray[np.int64]  # dataset row of each batch row, e.g. to look up labels
+
+
+class Loader:
+    """
+    Iterate the spectra of many same-shape SPC files in batches, decoding
+    the next batches in the background while the current one is used.
+
+    Rows are the subfiles of ``paths`` in order, as in
+    :class:`VirtualDataset`. For every epoch a native thread decodes up to
+    ``prefetch`` batches ahead, each one in parallel on specio3's thread pool,
+    into float32 matrices drawn from a pool of reusable buffers. The loop only
+    waits when decoding is slower than the work done per batch.
+
+    Each ``iter()`` starts the next epoch (0, 1, 2, ...), abandoning any
+    iteration still in progress; :meth:`set_epoch` selects it explicitly. With
+    ``shuffle`` the row order depends only on ``seed`` and the epoch number,
+    and is the same on every platform.
+
+    Parameters
+    ----------
+    paths : sequence of str or PathLike
+        Y-only or XY SPC files with the same number of points (and, for
+        Y-only files, the same X range).
+    batch_size : int
+        Rows per batch.
+    shuffle : bool, default False
+        Visit the rows in a seeded random order.
+    prefetch : int, default 2
+        Batches decoded ahead; 0 decodes each batch when it is requested.
+    seed : int, default 0
+        Shuffle seed.
+    drop_last : bool, default False
+        Skip a final batch with fewer than ``batch_size`` rows.
+    num_threads : int, default 0
+        Worker threads for probing and decoding; 0 uses every core.
+
+    Raises
+    ------
+    ValueError
+        If ``batch_size`` is less than 1 or ``prefetch`` is negative.
+    RuntimeError
+        If a header cannot be read or the files do not share an X axis.
+        Errors decoding a row are raised by the iteration that reaches it.
+
+    Examples
+    --------
+    >>> loader = specio3.Loader(paths, batch_size=256, shuffle=True, prefetch=4, seed=1)
+    >>> for epoch in range(10):
+    ...     for y, rows in loader:
+    ...         loss = step(torch.from_numpy(y), labels[rows])
+    """
+
+    def __init__(self, paths: Sequence[PathLike], batch_size: int, shuffle: bool = False, prefetch: int = 2,
+                 seed: int = 0, drop_last: bool = False, num_threads: int = 0):
+        if int(batch_size) < 1:
+            raise ValueError("batch_size must be at least 1")
+        if int(prefetch) < 0:
+            raise ValueError("prefetch must not be negative")
+        self._args = ([os.fspath(p) for p in paths], int(batch_size), bool(shuffle), int(prefetch), int(seed),
+                      bool(drop_last), int(num_threads))
+        paths, batch_size, shuffle, prefetch, seed, drop_last, num_threads = self._args
+        self._native = _specio3.BatchLoader(paths, batch_size, shuffle, seed % 2**64, drop_last, prefetch,
+                                            num_threads)
+        self._epoch = 0
+        self._generation = 0
+
+    def __reduce__(self):
+        # Reopen from the paths (e.g. in a worker process); the epoch carries over
+        return _restore, (self._args, self._epoch)
+
+    @property
+    def num_rows(self) -> int:
+        """Spectra per epoch, before ``drop_last``."""
+        return self._native.num_rows
+
+    @property
+    def num_points(self) -> int:
+        return self._native.num_points
+
+    @property
+    def x(self) -> NDArray[np.float64]:
+        """Common X axis."""
+        return self._native.x
+
+    def __len__(self) -> int:
+        """Batches per epoch."""
+        return len(self._native)
+
+    def __repr__(self) -> str:
+        return (f"Loader(rows={self.num_rows}, points={self.num_points}, batch_size={self._args[1]}, "
+                f"batches={len(self)})")
+
+    def set_epoch(self, epoch: int) -> None:
+        """Make the next ``iter()`` run ``epoch`` (and later ones follow it)."""
+        self._epoch = int(epoch)
+
+    def __iter__(self) -> Iterator[LoaderBatch]:
+        # Start decoding now rather than at the first next()
+        self._native.start_epoch(self._epoch)
+        self._epoch += 1
+        self._generation += 1
+        return self._batches(self._generation)
+
+    def _batches(self, generation: int) -> Iterator[LoaderBatch]:
+        while generation == self._generation:
+            batch = self._native.next()
+            if batch is None:
+                return
+            yield LoaderBatch(*batch)
+
+
+def _restore(args, epoch: int) -> Loader:
+    paths, batch_size, shuffle, prefetch, seed, drop_last, num_threads = args
+    loader = Loader(paths, batch_size, shuffle, prefetch, seed, drop_last, num_threads)
+    loader.set_epoch(epoch)
+    return loader
+
+
+__all__ = ["Loader", "LoaderBatch"]
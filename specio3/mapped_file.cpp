@@ -0,0 +1,123 @@
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filename) {
+#ifdef _WIN32
+    HANDLE fh = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fh == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(fh, &file_size)) {
+        CloseHandle(fh);
+        throw std::runtime_error("Unable to stat file: " + filename);
+    }
+    file_handle_ = fh;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+    HANDLE mh = CreateFileMappingA(fh, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mh == nullptr) {
+        release();
+        throw std::runtime_error("Unable to map file: " + filename);
+    }
+    mapping_handle_ = mh;
+    data_ = static_cast<const char*>(MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+        release();
+        throw std::runtime_error("Unable to map file: " + filename);
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Unable to stat file: " + filename);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        ::close(fd);
+        return;
+    }
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        size_ = 0;
+        throw std::runtime_error("Unable to map file: " + filename);
+    }
+    data_ = static_cast<const char*>(p);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        file_handle_ = std::exchange(other.file_handle_, nullptr);
+        mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    if (data_ == nullptr || offset >= size_) {
+        return;
+    }
+    length = std::min(length, size_ - offset);
+#ifndef _WIN32
+    // posix_madvise needs a page-aligned start
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t start = offset / page * page;
+    ::posix_madvise(const_cast<char*>(data_) + start, length + (offset - start), POSIX_MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::release() noexcept {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    }
+    if (file_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+    }
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+#else
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
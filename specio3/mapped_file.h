@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <streambuf>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file.
+ * The mapping is released when the object is destroyed. Objects are movable
+ * but not copyable, so a mapping always has exactly one owner.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * Map an existing file read-only.
+     *
+     * @param filename Path of the file to map
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& filename);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool is_open() const { return data_ != nullptr; }
+
+    /**
+     * Ask the OS to start reading a byte range into the page cache, so a
+     * following sequential pass over it runs at disk bandwidth. A no-op
+     * where the hint is not supported.
+     */
+    void prefetch(size_t offset, size_t length) const;
+
+private:
+    void release() noexcept;
+
+    const char* data_ = nullptr;  ///< Start of the mapping (nullptr for empty files)
+    size_t size_ = 0;             ///< Mapped length in bytes
+#ifdef _WIN32
+    void* file_handle_ = nullptr;     ///< HANDLE from CreateFile
+    void* mapping_handle_ = nullptr;  ///< HANDLE from CreateFileMapping
+#endif
+};
+
+/**
+ * Read-only std::istream over a block of memory, e.g. one member of a
+ * MappedFile. Lets the stream-based SPC parser decode data that is already
+ * mapped without copying it into a buffer first.
+ */
+class MemoryInputStream : public std::istream {
+public:
+    MemoryInputStream(const char* data, size_t size) : std::istream(nullptr), buffer_(data, size) {
+        rdbuf(&buffer_);
+    }
+
+private:
+    class Buffer : public std::streambuf {
+    public:
+        Buffer(const char* data, size_t size) {
+            char* p = const_cast<char*>(data);
+            setg(p, p, p + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+            if (!(which & std::ios_base::in)) {
+                return pos_type(off_type(-1));
+            }
+            off_type base = dir == std::ios_base::beg ? 0 : dir == std::ios_base::cur ? gptr() - eback()
+                                                                                      : egptr() - eback();
+            off_type pos = base + off;
+            if (pos < 0 || pos > egptr() - eback()) {
+                return pos_type(off_type(-1));
+            }
+            setg(eback(), eback() + pos, egptr());
+            return pos_type(pos);
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
+    Buffer buffer_;
+};
@@ -0,0 +1,175 @@
+"""Dense-matrix, ragged-array and binned reading of multifile SPC files."""
+import os
+from typing import Optional, Sequence, Tuple, Union
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+from .library import PathLike
+
+
+def read_spc_matrix(
+    path: PathLike, transpose: bool = False, num_threads: int = 0, check_quality: bool = False
+) -> Union[Tuple[NDArray[np.float64], NDArray[np.float64], NDArray[np.float64]],
+           Tuple[NDArray[np.float64], NDArray[np.float64], NDArray[np.float64], NDArray[np.void]]]:
+    """
+    Read every subfile of an SPC file into one C-contiguous matrix.
+
+    Parameters
+    ----------
+    path : str or PathLike
+        SPC file with a common X axis (Y-only, XY or XYY; not XYXY).
+    transpose : bool, default False
+        If False the matrix is ``(n_subfiles, n_points)``. If True it is
+        ``(n_points, n_subfiles)``, so each X position is a contiguous time
+        series. The transposed layout is decoded directly in cache-sized
+        tiles, avoiding the extra copy of ``np.ascontiguousarray(y.T)``.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+    check_quality : bool, default False
+        Also check every subfile for NaN/Inf, saturation, flat lines and
+        negative values while it is decoded, and return the results.
+
+    Returns
+    -------
+    x : NDArray[np.float64], shape (n_points,)
+        Common X axis.
+    y : NDArray[np.float64]
+        Y values in the layout selected by ``transpose``.
+    z : NDArray[np.float64], shape (n_subfiles,)
+        Z (start) value of each subfile.
+    quality : structured NDArray, shape (n_subfiles,)
+        Only with ``check_quality``; one record per subfile (see
+        :class:`QualityFlag` for the fields).
+
+    Raises
+    ------
+    RuntimeError
+        If the file cannot be read or is an XYXY file.
+
+    Examples
+    --------
+    >>> x, series, t = specio3.read_spc_matrix("kinetics.spc", transpose=True)
+    >>> series[np.searchsorted(x, 1715.0)]  # one wavenumber over time
+    """
+    return _specio3.read_spc_matrix(os.fspath(path), bool(transpose), int(num_threads), bool(check_quality))
+
+
+def read_spc_ragged(
+    path: PathLike, num_threads: int = 0
+) -> Tuple[NDArray[np.float64], NDArray[np.float64], NDArray[np.int64], NDArray[np.float64]]:
+    """
+    Read every subfile of an SPC file into flat ragged arrays.
+
+    Subfile ``i`` is ``x[offsets[i]:offsets[i + 1]]`` and
+    ``y[offsets[i]:offsets[i + 1]]``, the list layout used by Arrow and
+    Awkward Array. This suits XYXY files, whose subfiles have different
+    lengths: all of them come back in four arrays instead of one tuple per
+    subfile, and are decoded in parallel into buffers allocated once.
+
+    Parameters
+    ----------
+    path : str or PathLike
+        SPC file of any type.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    x : NDArray[np.float64], shape (n_values,)
+        X values of all subfiles, concatenated.
+    y : NDArray[np.float64], shape (n_values,)
+        Y values of all subfiles, concatenated.
+    offsets : NDArray[np.int64], shape (n_subfiles + 1,)
+        Start of each subfile in ``x`` and ``y``; ``offsets[-1] == n_values``.
+    z : NDArray[np.float64], shape (n_subfiles,)
+        Z (start) value of each subfile.
+
+    Raises
+    ------
+    RuntimeError
+        If the file cannot be read.
+
+    Examples
+    --------
+    >>> x, y, offsets, z = specio3.read_spc_ragged("ms_scans.spc")
+    >>> lengths = np.diff(offsets)
+    >>> base_peaks = np.maximum.reduceat(y, offsets[:-1])  # requires non-empty subfiles
+    """
+    return _specio3.read_spc_ragged(os.fspath(path), int(num_threads))
+
+
+def read_spc_binned(
+    path: PathLike,
+    edges: Optional[Sequence[float]] = None,
+    width: Optional[float] = None,
+    x_range: Optional[Tuple[Optional[float], Optional[float]]] = None,
+    num_threads: int = 0,
+) -> Tuple[NDArray[np.float64], NDArray[np.float64], NDArray[np.float64]]:
+    """
+    Bin every subfile of an SPC file onto one X grid, summing Y in each bin.
+
+    Centroided mass spectra stored as XYXY subfiles (peak lists of different
+    lengths) become one dense ``(n_subfiles, n_bins)`` matrix. The matrix is
+    allocated once and each subfile's points are scattered into its row while
+    it is decoded, in parallel across subfiles. Any file type is accepted.
+
+    Bins follow :func:`numpy.histogram`: each is closed on the left and open
+    on the right, except the last, which includes its upper edge. Points
+    outside the grid are dropped.
+
+    Parameters
+    ----------
+    path : str or PathLike
+        SPC file.
+    edges : sequence of float, optional
+        Strictly increasing bin edges. Give either ``edges`` or ``width``.
+    width : float, optional
+        Width of equal bins starting at the lower end of ``x_range``; the
+        last bin reaches at least its upper end.
+    x_range : (float or None, float or None), optional
+        Range covered by ``width`` bins. Missing bounds default to the
+        smallest and largest X in the file. Ignored with ``edges``.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    values : NDArray[np.float64], shape (n_subfiles, n_bins)
+        Summed Y values of each subfile in each bin.
+    edges : NDArray[np.float64], shape (n_bins + 1,)
+        Bin edges used.
+    z : NDArray[np.float64], shape (n_subfiles,)
+        Z (start) value of each subfile.
+
+    Raises
+    ------
+    ValueError
+        If neither or both of ``edges`` and ``width`` are given, or
+        ``edges`` has fewer than two values.
+    RuntimeError
+        If the file cannot be read or the grid is invalid.
+
+    Examples
+    --------
+    >>> counts, edges, t = specio3.read_spc_binned("gcms.spc", width=1.0, x_range=(49.5, 500.5))
+    >>> tic = counts.sum(axis=1)
+    """
+    if (edges is None) == (width is None):
+        raise ValueError("give exactly one of edges and width")
+    edges = [] if edges is None else [float(e) for e in edges]
+    if width is None and len(edges) < 2:
+        raise ValueError("edges must contain at least two values")
+    lo, hi = x_range if x_range is not None else (None, None)
+    return _specio3.read_spc_binned(
+        os.fspath(path),
+        edges,
+        0.0 if width is None else float(width),
+        float("nan") if lo is None else float(lo),
+        float("nan") if hi is None else float(hi),
+        int(num_threads),
+    )
+
+
+__all__ = ["read_spc_matrix", "read_spc_ragged", "read_spc_binned"]
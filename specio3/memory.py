@@ -0,0 +1,43 @@
+"""Counters for memory allocated by the native reader."""
+from typing import Dict
+
+from . import _specio3
+
+
+def allocation_stats(scope: str = "last_read") -> Dict[str, int]:
+    """
+    Return allocation counters of the native read pipeline.
+
+    Buffers used while decoding (spectra, scratch space, result arrays) are
+    allocated through a tracking allocator, so the transient memory of a read
+    can be compared with the size of what it returns.
+
+    Parameters
+    ----------
+    scope : {"last_read", "thread", "global"}, default "last_read"
+        ``"last_read"`` covers the most recent read call made from this
+        thread, including the worker threads it used. ``"thread"`` covers
+        allocations made on the calling thread, ``"global"`` the whole process.
+
+    Returns
+    -------
+    dict
+        ``allocations``, ``deallocations``, ``bytes_allocated``,
+        ``bytes_in_use`` (still held, e.g. by returned arrays) and
+        ``peak_bytes`` (high-water mark of ``bytes_in_use``).
+
+    Examples
+    --------
+    >>> x, y, z = specio3.read_spc_matrix("run.spc")
+    >>> stats = specio3.allocation_stats()
+    >>> transient = stats["peak_bytes"] - stats["bytes_in_use"]
+    """
+    return _specio3.allocation_stats(scope)
+
+
+def reset_allocation_stats() -> None:
+    """Reset the global and calling-thread counters; bytes still in use are kept."""
+    _specio3.reset_allocation_stats()
+
+
+__all__ = ["allocation_stats", "reset_allocation_stats"]
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+/**
+ * Unbounded lock-free multi-producer single-consumer queue (Vyukov's
+ * intrusive design with a stub node).
+ *
+ * push() is wait-free: one atomic exchange and one store, so worker threads
+ * never block each other or the consumer. try_pop() may only be called by
+ * one thread at a time. A push that is still linking its node can make the
+ * queue look empty for a moment; the item becomes visible once push()
+ * returns.
+ */
+template <typename T>
+class MPSCQueue {
+public:
+    MPSCQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+    ~MPSCQueue() {
+        T discarded;
+        while (try_pop(discarded)) {
+        }
+        delete tail_;
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    /** Append a value. Safe to call from any number of threads. */
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /**
+     * Remove the oldest value, if any. Consumer thread only.
+     *
+     * @return false if the queue is (momentarily) empty
+     */
+    bool try_pop(T& out) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return false;
+        }
+        // next becomes the new stub once its value is moved out
+        out = std::move(next->value);
+        tail_ = next;
+        delete tail;
+        return true;
+    }
+
+    /** Whether try_pop() would fail right now. Consumer thread only. */
+    bool empty() const {
+        return tail_->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        explicit Node(T v) : value(std::move(v)) {}
+
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node*> head_;  ///< Most recently pushed node (producers)
+    Node* tail_;               ///< Stub node before the oldest value (consumer)
+};
@@ -0,0 +1,108 @@
+"""Merging and splitting SPC multifiles without decoding spectra."""
+import os
+from pathlib import Path
+from typing import List, Sequence
+
+from . import _specio3
+from .library import PathLike
+
+
+def merge_spc(inputs: Sequence[PathLike], output: PathLike) -> int:
+    """
+    Concatenate the subfiles of several SPC files into one multifile.
+
+    Subheaders and data blocks are copied byte for byte; only the header's
+    subfile count, log offset and subfile indices are rewritten, so no value
+    is decoded or rescaled.
+
+    Parameters
+    ----------
+    inputs : sequence of str or PathLike
+        SPC files (single files or multifiles), in output order. They must
+        share format version, Y precision, X storage and, unless every file
+        stores its own X values (XYXY), the X axis. Each subfile keeps its
+        own exponent.
+    output : str or PathLike
+        File to write. Its header and log come from the first input.
+
+    Returns
+    -------
+    int
+        Number of subfiles written.
+
+    Raises
+    ------
+    RuntimeError
+        If an input is unreadable or incompatible with the first input, or
+        the output would have more than 65535 subfiles (the subheader index
+        is 16-bit).
+    """
+    return _specio3.merge_spc([os.fspath(p) for p in inputs], os.fspath(output))
+
+
+def extract_subfiles(path: PathLike, indices: Sequence[int], output: PathLike) -> None:
+    """
+    Copy selected subfiles of an SPC file, in the given order, into a new multifile.
+
+    Parameters
+    ----------
+    path : str or PathLike
+        SPC file to read.
+    indices : sequence of int
+        Subfile indices; may repeat or reorder subfiles.
+    output : str or PathLike
+        File to write.
+
+    Raises
+    ------
+    RuntimeError
+        If the input is unreadable, an index is out of range or more than
+        65535 subfiles are selected.
+    """
+    _specio3.extract_subfiles(os.fspath(path), [int(i) for i in indices], os.fspath(output))
+
+
+def split_spc(
+    path: PathLike,
+    output_dir: PathLike,
+    name_format: str = "{stem}_{index:05d}.spc",
+    num_threads: int = 0,
+) -> List[str]:
+    """
+    Write every subfile of an SPC file to its own file.
+
+    Outputs are one-subfile multifiles, so each keeps its z values,
+    exponent and the log of the input.
+
+    Parameters
+    ----------
+    path : str or PathLike
+        SPC file to split.
+    output_dir : str or PathLike
+        Directory for the outputs; created if missing.
+    name_format : str, default "{stem}_{index:05d}.spc"
+        Output file name, formatted with ``stem`` (input name without
+        suffix) and ``index`` (subfile index).
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    list of str
+        Output paths in subfile order.
+
+    Examples
+    --------
+    >>> parts = specio3.split_spc("run.spc", "run_parts")
+    >>> specio3.merge_spc(parts[::2], "run_even.spc")
+    """
+    path = os.fspath(path)
+    stem = Path(path).stem
+    os.makedirs(output_dir, exist_ok=True)
+    count = _specio3.subfile_count(path)
+    outputs = [os.path.join(os.fspath(output_dir), name_format.format(stem=stem, index=i)) for i in range(count)]
+    _specio3.split_spc(path, outputs, int(num_threads))
+    return outputs
+
+
+__all__ = ["merge_spc", "extract_subfiles", "split_spc"]
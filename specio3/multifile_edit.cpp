@@ -0,0 +1,238 @@
+#include "multifile_edit.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "spc_reader.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint8_t kMultifileFlag = 0x10;
+constexpr size_t kSubheaderSize = 32;
+constexpr size_t kSubfileCountOffset = 22;
+constexpr size_t kLogOffsetOffset = 244;
+// Subheaders number their subfile in 16 bits
+constexpr size_t kMaxSubfiles = std::numeric_limits<uint16_t>::max();
+
+// A mapped input file and its parsed layout.
+struct SourceFile {
+    std::string path;
+    MappedFile map;
+    SPCLayout layout;
+
+    size_t header_size() const { return layout.is_old_format ? 256 : 512; }
+
+    // Global Y exponent as read_spc_layout() interprets it; -128 marks float Y.
+    int8_t global_exponent() const {
+        return layout.is_old_format ? static_cast<int8_t>(read_le<int16_t>(map.data() + 2))
+                                    : static_cast<int8_t>(map.data()[1]);
+    }
+
+    // Raw X values shared by every subfile (XY files only).
+    const char* shared_x() const { return map.data() + layout.shared_x_offset; }
+    size_t shared_x_size() const {
+        return layout.is_xy && !layout.is_xyxy ? size_t{layout.num_points} * sizeof(float) : 0;
+    }
+
+    // Subfile data as stored: per-subfile X (XYXY) followed by Y.
+    const char* block(uint32_t s) const {
+        const SubfileLayout& sub = layout.subfiles[s];
+        return map.data() + (layout.is_xyxy ? sub.x_offset : sub.y_offset);
+    }
+    size_t block_size(uint32_t s) const {
+        const SubfileLayout& sub = layout.subfiles[s];
+        return static_cast<size_t>(sub.y_offset + uint64_t{sub.num_points} * layout.y_value_size(sub) -
+                                   (layout.is_xyxy ? sub.x_offset : sub.y_offset));
+    }
+
+    // Subheader of a subfile renumbered to index; single files get one built from the main header.
+    std::array<char, kSubheaderSize> subheader(uint32_t s, uint16_t index) const {
+        std::array<char, kSubheaderSize> out{};
+        if (layout.is_multifile) {
+            std::memcpy(out.data(), map.data() + header_size() + shared_x_size() + size_t{s} * kSubheaderSize,
+                        kSubheaderSize);
+        } else {
+            out[1] = static_cast<char>(global_exponent());
+            std::memcpy(out.data() + 16, &layout.num_points, sizeof(uint32_t));
+        }
+        std::memcpy(out.data() + 2, &index, sizeof(uint16_t));
+        return out;
+    }
+
+    // Log block as stored (empty if there is none).
+    std::pair<const char*, size_t> log_block() const {
+        const uint64_t offset = layout.log_block_offset;
+        if (offset == 0 || offset + sizeof(uint32_t) > map.size()) {
+            return {nullptr, 0};
+        }
+        const uint64_t size = std::min<uint64_t>(read_le<uint32_t>(map.data() + offset), map.size() - offset);
+        return {map.data() + offset, static_cast<size_t>(size)};
+    }
+};
+
+std::unique_ptr<SourceFile> open_source(const std::string& path) {
+    auto src = std::make_unique<SourceFile>();
+    src->path = path;
+    src->map = MappedFile(path);
+    MemoryInputStream stream(src->map.data(), src->map.size());
+    try {
+        src->layout = read_spc_layout(stream, src->map.size());
+    } catch (const std::exception& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+    const SPCLayout& l = src->layout;
+    if (!l.is_old_format && !l.is_xy) {
+        throw std::runtime_error(path + ": new-format Y-only files cannot be stored as multifiles "
+                                        "(their point count is derived from the file size)");
+    }
+    if (l.shared_x_offset + src->shared_x_size() > src->map.size()) {
+        throw std::runtime_error(path + ": shared X array extends past the end of the file");
+    }
+    for (uint32_t s = 0; s < l.num_subfiles; ++s) {
+        const SubfileLayout& sub = l.subfiles[s];
+        if (sub.y_offset + uint64_t{sub.num_points} * l.y_value_size(sub) > src->map.size()) {
+            throw std::runtime_error(path + ": subfile " + std::to_string(s) + " extends past the end of the file");
+        }
+    }
+    return src;
+}
+
+// Reject inputs whose subfiles would decode differently under the first input's header.
+void check_compatible(const SourceFile& first, const SourceFile& other) {
+    const SPCLayout& a = first.layout;
+    const SPCLayout& b = other.layout;
+    auto fail = [&](const std::string& what) {
+        throw std::runtime_error(other.path + ": " + what + " differs from " + first.path);
+    };
+    if (a.is_old_format != b.is_old_format) {
+        fail("format version");
+    }
+    if (a.y_in_16bit != b.y_in_16bit) {
+        fail("Y precision (16/32-bit)");
+    }
+    if (a.is_xy != b.is_xy || a.is_xyxy != b.is_xyxy) {
+        fail("X storage (Y-only, XY or XYXY)");
+    }
+    if ((first.global_exponent() == -128) != (other.global_exponent() == -128)) {
+        fail("float/integer Y exponent");
+    }
+    if (a.is_xyxy) {
+        return;
+    }
+    if (a.num_points != b.num_points) {
+        fail("point count");
+    }
+    if (a.is_xy ? std::memcmp(first.shared_x(), other.shared_x(), first.shared_x_size()) != 0
+                : (a.first_x != b.first_x || a.last_x != b.last_x)) {
+        fail("X axis");
+    }
+}
+
+struct SubfileRef {
+    const SourceFile* source;
+    uint32_t subfile;
+};
+
+void write_all(std::ofstream& out, const char* data, size_t size, const std::string& path) {
+    if (size != 0 && !out.write(data, static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Unable to write " + path);
+    }
+}
+
+// Write subfiles as one multifile using the header, shared X and log block of tmpl.
+void write_multifile(const std::string& output, const SourceFile& tmpl, const std::vector<SubfileRef>& subfiles) {
+    if (subfiles.empty()) {
+        throw std::runtime_error("No subfiles to write to " + output);
+    }
+    if (subfiles.size() > kMaxSubfiles) {
+        throw std::runtime_error(output + ": " + std::to_string(subfiles.size()) + " subfiles exceed the " +
+                                 std::to_string(kMaxSubfiles) + " an SPC subheader index can number");
+    }
+    const auto [log_data, log_size] = tmpl.log_block();
+    uint64_t log_offset = tmpl.header_size() + tmpl.shared_x_size() + subfiles.size() * kSubheaderSize;
+    for (const SubfileRef& ref : subfiles) {
+        log_offset += ref.source->block_size(ref.subfile);
+    }
+    if (log_size != 0 && log_offset > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error(output + ": log block would start beyond the 4 GiB a header offset can address");
+    }
+
+    std::vector<char> header(tmpl.map.data(), tmpl.map.data() + tmpl.header_size());
+    header[0] = static_cast<char>(static_cast<uint8_t>(header[0]) | kMultifileFlag);
+    const auto count = static_cast<uint32_t>(subfiles.size());
+    std::memcpy(header.data() + kSubfileCountOffset, &count, sizeof(count));
+    const auto log_field = static_cast<uint32_t>(log_size != 0 ? log_offset : 0);
+    std::memcpy(header.data() + kLogOffsetOffset, &log_field, sizeof(log_field));
+
+    std::vector<char> subheaders(subfiles.size() * kSubheaderSize);
+    for (size_t i = 0; i < subfiles.size(); ++i) {
+        const auto sh = subfiles[i].source->subheader(subfiles[i].subfile, static_cast<uint16_t>(i));
+        std::memcpy(subheaders.data() + i * kSubheaderSize, sh.data(), kSubheaderSize);
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Unable to create " + output);
+    }
+    write_all(out, header.data(), header.size(), output);
+    write_all(out, tmpl.shared_x(), tmpl.shared_x_size(), output);
+    write_all(out, subheaders.data(), subheaders.size(), output);
+    for (const SubfileRef& ref : subfiles) {
+        write_all(out, ref.source->block(ref.subfile), ref.source->block_size(ref.subfile), output);
+    }
+    write_all(out, log_data, log_size, output);
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Unable to write " + output);
+    }
+}
+
+}  // namespace
+
+size_t merge_spc_files(const std::vector<std::string>& inputs, const std::string& output) {
+    if (inputs.empty()) {
+        throw std::runtime_error("No input files to merge");
+    }
+    std::vector<std::unique_ptr<SourceFile>> sources;
+    std::vector<SubfileRef> subfiles;
+    for (const std::string& path : inputs) {
+        sources.push_back(open_source(path));
+        check_compatible(*sources.front(), *sources.back());
+        for (uint32_t s = 0; s < sources.back()->layout.num_subfiles; ++s) {
+            subfiles.push_back({sources.back().get(), s});
+        }
+    }
+    write_multifile(output, *sources.front(), subfiles);
+    return subfiles.size();
+}
+
+void extract_subfiles(const std::string& input, const std::vector<uint32_t>& subfiles, const std::string& output) {
+    const auto src = open_source(input);
+    std::vector<SubfileRef> refs;
+    refs.reserve(subfiles.size());
+    for (uint32_t s : subfiles) {
+        if (s >= src->layout.num_subfiles) {
+            throw std::runtime_error(input + ": subfile " + std::to_string(s) + " out of range for " +
+                                     std::to_string(src->layout.num_subfiles) + " subfiles");
+        }
+        refs.push_back({src.get(), s});
+    }
+    write_multifile(output, *src, refs);
+}
+
+void split_spc_file(const std::string& input, const std::vector<std::string>& outputs, size_t num_threads) {
+    const auto src = open_source(input);
+    if (outputs.size() != src->layout.num_subfiles) {
+        throw std::runtime_error(input + ": has " + std::to_string(src->layout.num_subfiles) +
+                                 " subfiles but " + std::to_string(outputs.size()) + " output paths were given");
+    }
+    parallel_for(outputs.size(), num_threads, [&](size_t i) {
+        write_multifile(outputs[i], *src, {{src.get(), static_cast<uint32_t>(i)}});
+    });
+}
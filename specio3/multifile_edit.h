@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Block-level reorganization of SPC files.
+ *
+ * Subfiles are moved as raw bytes (subheader, per-subfile X, Y), never
+ * decoded: only the main header's flags, subfile count and log offset and
+ * each subheader's index are rewritten. Outputs use the layout read by
+ * read_spc_layout(): main header, shared X, subheader table, data blocks,
+ * then the log block of the template file. Inputs are memory-mapped, so the
+ * cost is one copy of the bytes being moved.
+ *
+ * New-format Y-only files are rejected: read_spc_layout() derives their
+ * point count from the file size, which no multifile satisfies.
+ */
+
+/**
+ * Concatenate the subfiles of several SPC files into one multifile.
+ *
+ * Inputs must share format version, Y precision, X storage (Y-only, XY or
+ * XYXY), float/integer header exponent and, unless XYXY, the X axis (same
+ * point count and X values). Per-subfile exponents are kept in the
+ * subheaders, so inputs may be scaled differently. The header and log
+ * block of the first input are used for the output.
+ *
+ * @param inputs SPC files (single or multifiles), in output order
+ * @param output File to write
+ * @return Number of subfiles written
+ * @throws std::runtime_error naming the input if it is unreadable or incompatible,
+ *         or if the output would have more than 65535 subfiles (16-bit subheader index)
+ */
+size_t merge_spc_files(const std::vector<std::string>& inputs, const std::string& output);
+
+/**
+ * Write selected subfiles of an SPC file, in the given order, as a new multifile.
+ *
+ * @param input SPC file
+ * @param subfiles Subfile indices (may repeat)
+ * @param output File to write
+ * @throws std::runtime_error if the input is unreadable, an index is out of range or
+ *         more than 65535 subfiles are selected
+ */
+void extract_subfiles(const std::string& input, const std::vector<uint32_t>& subfiles, const std::string& output);
+
+/**
+ * Write every subfile of an SPC file to its own single-subfile multifile,
+ * keeping its z values, exponent and the input's log block.
+ *
+ * @param input SPC file
+ * @param outputs One output path per subfile
+ * @param num_threads Worker threads (0 = all cores)
+ * @throws std::runtime_error if the input is unreadable or outputs has the wrong length
+ */
+void split_spc_file(const std::string& input, const std::vector<std::string>& outputs, size_t num_threads);
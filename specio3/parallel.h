@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include "executor.h"
+
+/**
+ * Number of threads used when a caller passes num_threads == 0.
+ *
+ * @return The size of the process-wide executor (see Executor)
+ */
+inline size_t default_num_threads() {
+    return global_executor().num_threads();
+}
+
+/**
+ * Run fn(i) for every i in [0, count) on up to num_threads threads of the
+ * process-wide executor. Tasks are handed out dynamically, so uneven task
+ * costs balance out. The calling thread participates as one of the workers,
+ * and worker threads attribute their allocations to the caller's read (see
+ * ReadAllocationScope).
+ *
+ * @param count Number of tasks
+ * @param num_threads Maximum number of threads (0 selects default_num_threads()); capped at the executor size
+ * @param fn Callable invoked as fn(size_t task_index)
+ * @throws The first exception raised by any task, after all workers have stopped
+ */
+template <typename Fn>
+void parallel_for(size_t count, size_t num_threads, Fn&& fn) {
+    using Callable = std::remove_reference_t<Fn>;
+    global_executor().run(count, num_threads,
+                          [](void* context, size_t i) { (*static_cast<Callable*>(context))(i); },
+                          const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+}
@@ -0,0 +1,210 @@
+#include "pca.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+// Extra subspace columns and power iterations for the randomized fit. These
+// are the usual defaults from Halko, Martinsson & Tropp (2011); spectra have
+// fast-decaying spectra so a few iterations are enough.
+static constexpr size_t kOversampling = 10;
+static constexpr int kPowerIterations = 4;
+
+void PCAModel::project(const float* in, float* out) const {
+    for (uint32_t k = 0; k < num_components; ++k) {
+        const float* comp = components.data() + static_cast<size_t>(k) * input_dim;
+        float acc = 0;
+        for (uint32_t c = 0; c < input_dim; ++c) {
+            acc += comp[c] * (in[c] - mean[c]);
+        }
+        out[k] = acc;
+    }
+}
+
+// Modified Gram-Schmidt on the columns of a row-major (rows x cols) matrix.
+static void orthonormalize_columns(std::vector<double>& a, size_t rows, size_t cols) {
+    for (size_t j = 0; j < cols; ++j) {
+        for (size_t p = 0; p < j; ++p) {
+            double d = 0;
+            for (size_t r = 0; r < rows; ++r) {
+                d += a[r * cols + j] * a[r * cols + p];
+            }
+            for (size_t r = 0; r < rows; ++r) {
+                a[r * cols + j] -= d * a[r * cols + p];
+            }
+        }
+        double norm = 0;
+        for (size_t r = 0; r < rows; ++r) {
+            norm += a[r * cols + j] * a[r * cols + j];
+        }
+        norm = std::sqrt(norm);
+        const double inv = norm > 0 ? 1.0 / norm : 0.0;
+        for (size_t r = 0; r < rows; ++r) {
+            a[r * cols + j] *= inv;
+        }
+    }
+}
+
+// Cyclic Jacobi eigen-decomposition of a symmetric (n x n) row-major matrix.
+// On return s holds the eigenvalues on its diagonal and v the eigenvectors as columns.
+static void jacobi_eigen(std::vector<double>& s, std::vector<double>& v, size_t n) {
+    v.assign(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        v[i * n + i] = 1.0;
+    }
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        double off = 0;
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t q = p + 1; q < n; ++q) {
+                off += s[p * n + q] * s[p * n + q];
+            }
+        }
+        if (off < 1e-22) {
+            break;
+        }
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t q = p + 1; q < n; ++q) {
+                const double apq = s[p * n + q];
+                if (std::abs(apq) < 1e-300) {
+                    continue;
+                }
+                const double theta = (s[q * n + q] - s[p * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double sn = t * c;
+                for (size_t k = 0; k < n; ++k) {
+                    const double skp = s[k * n + p];
+                    const double skq = s[k * n + q];
+                    s[k * n + p] = c * skp - sn * skq;
+                    s[k * n + q] = sn * skp + c * skq;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    const double spk = s[p * n + k];
+                    const double sqk = s[q * n + k];
+                    s[p * n + k] = c * spk - sn * sqk;
+                    s[q * n + k] = sn * spk + c * sqk;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    const double vkp = v[k * n + p];
+                    const double vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - sn * vkq;
+                    v[k * n + q] = sn * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+PCAModel fit_pca(const float* samples, size_t num_samples, size_t dim, size_t num_components,
+                 uint64_t seed, size_t num_threads) {
+    if (num_components == 0 || num_components > std::min(num_samples, dim)) {
+        throw std::runtime_error("PCA components must be between 1 and min(samples, dim) = " +
+                                 std::to_string(std::min(num_samples, dim)));
+    }
+    const size_t l = std::min(dim, num_components + kOversampling);
+
+    PCAModel model;
+    model.input_dim = static_cast<uint32_t>(dim);
+    model.num_components = static_cast<uint32_t>(num_components);
+
+    std::vector<double> mean(dim, 0.0);
+    for (size_t i = 0; i < num_samples; ++i) {
+        for (size_t c = 0; c < dim; ++c) {
+            mean[c] += samples[i * dim + c];
+        }
+    }
+    for (double& m : mean) {
+        m /= static_cast<double>(num_samples);
+    }
+
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<double> q(dim * l);
+    for (double& value : q) {
+        value = normal(rng);
+    }
+    orthonormalize_columns(q, dim, l);
+
+    std::vector<double> y(num_samples * l);
+    // y = (X - mean) * q, rows in parallel.
+    auto multiply_centered = [&]() {
+        parallel_for(num_samples, num_threads, [&](size_t i) {
+            double* yi = y.data() + i * l;
+            std::fill(yi, yi + l, 0.0);
+            const float* xi = samples + i * dim;
+            for (size_t c = 0; c < dim; ++c) {
+                const double xc = xi[c] - mean[c];
+                const double* qc = q.data() + c * l;
+                for (size_t j = 0; j < l; ++j) {
+                    yi[j] += xc * qc[j];
+                }
+            }
+        });
+    };
+
+    const size_t col_block = 64;
+    const size_t num_col_blocks = (dim + col_block - 1) / col_block;
+    for (int it = 0; it < kPowerIterations; ++it) {
+        multiply_centered();
+        // q = (X - mean)^T * y, column blocks in parallel.
+        parallel_for(num_col_blocks, num_threads, [&](size_t b) {
+            const size_t c0 = b * col_block;
+            const size_t c1 = std::min(dim, c0 + col_block);
+            std::fill(q.begin() + static_cast<std::ptrdiff_t>(c0 * l), q.begin() + static_cast<std::ptrdiff_t>(c1 * l), 0.0);
+            for (size_t i = 0; i < num_samples; ++i) {
+                const float* xi = samples + i * dim;
+                const double* yi = y.data() + i * l;
+                for (size_t c = c0; c < c1; ++c) {
+                    const double xc = xi[c] - mean[c];
+                    double* qc = q.data() + c * l;
+                    for (size_t j = 0; j < l; ++j) {
+                        qc[j] += xc * yi[j];
+                    }
+                }
+            }
+        });
+        orthonormalize_columns(q, dim, l);
+    }
+
+    // Rayleigh-Ritz: rotate the subspace onto the eigenvectors of B^T B.
+    multiply_centered();
+    std::vector<double> s(l * l, 0.0);
+    for (size_t i = 0; i < num_samples; ++i) {
+        const double* yi = y.data() + i * l;
+        for (size_t a = 0; a < l; ++a) {
+            for (size_t b = a; b < l; ++b) {
+                s[a * l + b] += yi[a] * yi[b];
+            }
+        }
+    }
+    for (size_t a = 0; a < l; ++a) {
+        for (size_t b = 0; b < a; ++b) {
+            s[a * l + b] = s[b * l + a];
+        }
+    }
+    std::vector<double> v;
+    jacobi_eigen(s, v, l);
+
+    std::vector<size_t> order(l);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return s[a * l + a] > s[b * l + b]; });
+
+    model.mean.assign(mean.begin(), mean.end());
+    model.components.assign(num_components * dim, 0.0f);
+    for (size_t k = 0; k < num_components; ++k) {
+        const size_t col = order[k];
+        float* comp = model.components.data() + k * dim;
+        for (size_t c = 0; c < dim; ++c) {
+            double acc = 0;
+            for (size_t j = 0; j < l; ++j) {
+                acc += q[c * l + j] * v[j * l + col];
+            }
+            comp[c] = static_cast<float>(acc);
+        }
+    }
+    return model;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Principal component projection fitted by fit_pca().
+ */
+struct PCAModel {
+    uint32_t input_dim = 0;        ///< Length of input vectors
+    uint32_t num_components = 0;   ///< Length of projected vectors
+    std::vector<float> mean;       ///< Per-column mean of the training data (input_dim)
+    std::vector<float> components; ///< Row-major (num_components x input_dim), unit rows
+
+    /**
+     * Project one vector: out = components * (in - mean).
+     *
+     * @param in Input vector of input_dim floats
+     * @param out Output vector of num_components floats
+     */
+    void project(const float* in, float* out) const;
+};
+
+/**
+ * Fit the leading principal components of a sample matrix using randomized
+ * subspace iteration, which touches the data a handful of times instead of
+ * forming the input_dim x input_dim covariance matrix.
+ *
+ * @param samples Row-major (num_samples x dim) training data
+ * @param num_samples Number of rows
+ * @param dim Number of columns
+ * @param num_components Components to keep (1 <= num_components <= min(num_samples, dim))
+ * @param seed Seed for the random starting subspace
+ * @param num_threads Worker threads (0 = all cores)
+ * @return The fitted model, components ordered by decreasing variance
+ * @throws std::runtime_error if num_components is out of range
+ */
+PCAModel fit_pca(const float* samples, size_t num_samples, size_t dim, size_t num_components,
+                 uint64_t seed, size_t num_threads);
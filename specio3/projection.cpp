@@ -0,0 +1,85 @@
+#include "projection.h"
+#include "spc_batch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Y values decoded per block: 8 KiB of doubles stays in L1 while it is projected.
+constexpr size_t kBlockPoints = 1024;
+
+// Subfiles of one multifile handled by a single task.
+constexpr uint32_t kSubfilesPerTask = 16;
+
+// Accumulate (y - offset) * loadings for one subfile into scores[0..k).
+void project_subfile(std::ifstream& f, const SPCLayout& layout, const SubfileLayout& sub,
+                     const LinearProjection& model, tracked_vector<char>& raw, tracked_vector<double>& y,
+                     double* scores) {
+    const uint32_t k = model.num_outputs;
+    const uint32_t value_size = layout.y_value_size(sub);
+    std::fill(scores, scores + k, 0.0);
+
+    f.seekg(static_cast<std::streamoff>(sub.y_offset), std::ios::beg);
+    for (size_t start = 0; start < sub.num_points; start += kBlockPoints) {
+        const size_t count = std::min<size_t>(kBlockPoints, sub.num_points - start);
+        f.read(raw.data(), static_cast<std::streamsize>(count * value_size));
+        if (!f) {
+            throw std::runtime_error("Failed reading Y values at offset " +
+                                     std::to_string(sub.y_offset + start * value_size));
+        }
+        decode_y_values(layout, sub, raw.data(), count, y.data());
+        if (model.offset != nullptr) {
+            for (size_t i = 0; i < count; ++i) {
+                y[i] -= model.offset[start + i];
+            }
+        }
+        const double* row = model.loadings + start * k;
+        for (size_t i = 0; i < count; ++i, row += k) {
+            const double v = y[i];
+            for (uint32_t j = 0; j < k; ++j) {
+                scores[j] += v * row[j];
+            }
+        }
+    }
+}
+
+}  // namespace
+
+tracked_vector<double> project_spc_files(const std::vector<std::string>& paths, const LinearProjection& model,
+                                         size_t num_threads) {
+    if (model.loadings == nullptr || model.num_points == 0 || model.num_outputs == 0) {
+        throw std::runtime_error("Projection loadings must be a non-empty (num_points x k) matrix");
+    }
+
+    // Pass 1: headers only, to size the output and catch length mismatches up front
+    SPCBatch batch = read_spc_batch(paths, num_threads);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        for (const SubfileLayout& sub : batch.layouts[i].subfiles) {
+            if (sub.num_points != model.num_points) {
+                throw std::runtime_error(paths[i] + ": subfile has " + std::to_string(sub.num_points) +
+                                         " points but the projection expects " +
+                                         std::to_string(model.num_points));
+            }
+        }
+    }
+
+    // Pass 2: decode and project; each chunk writes its own disjoint rows
+    const uint32_t k = model.num_outputs;
+    tracked_vector<double> scores(batch.num_rows() * k);
+    for_each_subfile_chunk(batch, kSubfilesPerTask, num_threads,
+                           [&](std::ifstream& f, size_t file, uint32_t first_subfile, uint32_t end_subfile) {
+        const SPCLayout& layout = batch.layouts[file];
+        tracked_vector<char> raw(kBlockPoints * sizeof(uint32_t));
+        tracked_vector<double> y(kBlockPoints);
+        for (uint32_t s = first_subfile; s < end_subfile; ++s) {
+            double* out = scores.data() + (batch.first_row[file] + s) * k;
+            try {
+                project_subfile(f, layout, layout.subfiles[s], model, raw, y, out);
+            } catch (const std::exception& e) {
+                throw std::runtime_error("subfile " + std::to_string(s) + ": " + e.what());
+            }
+        }
+    });
+    return scores;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "alloc_tracking.h"
+
+/**
+ * A linear model applied to decoded spectra: score = (y - offset) · loadings.
+ * Covers PCA scores (offset = mean, loadings = components) and PLS
+ * predictions (offset = X mean, loadings = regression coefficients).
+ * Pointers are borrowed; the caller keeps them alive for the call.
+ */
+struct LinearProjection {
+    const double* loadings = nullptr;  ///< Row-major (num_points x num_outputs)
+    const double* offset = nullptr;    ///< num_points values subtracted first, or nullptr
+    uint32_t num_points = 0;           ///< Points every projected subfile must have
+    uint32_t num_outputs = 0;          ///< Number of scores per subfile (k)
+};
+
+/**
+ * Project every subfile of every SPC file onto a linear model without
+ * materializing the spectra. Y values are decoded in cache-sized blocks and
+ * accumulated into the scores straight away; work is spread over files and
+ * over chunks of subfiles within large multifiles.
+ *
+ * @param paths SPC files, all with model.num_points points per subfile
+ * @param model Loadings and optional offset
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Row-major (total_subfiles x model.num_outputs) scores, in file then subfile order
+ * @throws std::runtime_error if a file cannot be read or its length does not match the model
+ */
+tracked_vector<double> project_spc_files(const std::vector<std::string>& paths, const LinearProjection& model,
+                                         size_t num_threads);
@@ -0,0 +1,64 @@
+"""Linear-model projection (PCA scores, PLS predictions) fused into SPC decoding."""
+import os
+from typing import Optional, Sequence, Union
+
+import numpy as np
+from numpy.typing import ArrayLike, NDArray
+
+from . import _specio3
+from .library import PathLike
+
+
+def project_spc(
+    paths: Union[PathLike, Sequence[PathLike]],
+    loadings: ArrayLike,
+    offset: Optional[ArrayLike] = None,
+    num_threads: int = 0,
+) -> NDArray[np.float64]:
+    """
+    Compute ``(y - offset) @ loadings`` for every subfile without keeping the spectra.
+
+    Y values are decoded in small blocks and multiplied into the scores while
+    they are still in cache, so memory use does not depend on spectrum length
+    or file count. Files, and groups of subfiles within large multifiles, are
+    processed in parallel.
+
+    Parameters
+    ----------
+    paths : str, PathLike or sequence of them
+        One SPC file or several; every subfile must have ``loadings.shape[0]``
+        points.
+    loadings : array_like, shape (num_points,) or (num_points, k)
+        Projection matrix, e.g. PCA components transposed or PLS coefficients.
+        A 1-D array is treated as a single column.
+    offset : array_like, shape (num_points,), optional
+        Subtracted from each spectrum first, e.g. the training mean.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    NDArray[np.float64], shape (n_subfiles, k)
+        One row per subfile, in file then subfile order.
+
+    Raises
+    ------
+    RuntimeError
+        If a file cannot be read or its length does not match ``loadings``.
+
+    Examples
+    --------
+    >>> scores = specio3.project_spc(paths, pca.components_.T, offset=pca.mean_)
+    >>> predictions = specio3.project_spc(paths, pls.coef_.T) + pls.intercept_
+    """
+    if isinstance(paths, (str, os.PathLike)):
+        paths = [paths]
+    loadings = np.asarray(loadings, dtype=np.float64)
+    if loadings.ndim == 1:
+        loadings = loadings[:, np.newaxis]
+    if offset is not None:
+        offset = np.asarray(offset, dtype=np.float64)
+    return _specio3.project_spc([os.fspath(p) for p in paths], loadings, offset, int(num_threads))
+
+
+__all__ = ["project_spc"]
@@ -0,0 +1,41 @@
+"""Per-subfile data-quality records produced while decoding."""
+import enum
+
+
+class QualityFlag(enum.IntFlag):
+    """
+    Bits of the ``flags`` field of a quality record.
+
+    Quality records are returned by ``read_spc(..., check_quality=True)`` and
+    ``read_spc_matrix(..., check_quality=True)`` as a NumPy structured array
+    with one record per subfile and the fields:
+
+    ``flags`` (uint32)
+        Combination of the flags below.
+    ``nan_count``, ``inf_count``, ``negative_count`` (uint32)
+        NaN, infinite and negative values.
+    ``saturated_count`` (uint32)
+        Integer values at the largest code of their width (0x7FFF or
+        0x7FFFFFFF), i.e. the detector's ceiling. Always 0 for float data.
+    ``saturated_run`` (uint32)
+        Longest run of consecutive saturated values.
+    ``y_min``, ``y_max`` (float64)
+        Range of the finite values (``inf``/``-inf`` if there are none).
+
+    Examples
+    --------
+    >>> spectra, quality = specio3.read_spc("run.spc", check_quality=True)
+    >>> bad = np.flatnonzero(quality["flags"] & (QualityFlag.NON_FINITE | QualityFlag.SATURATED))
+    """
+
+    NON_FINITE = 1 << 0
+    """At least one NaN or infinite value."""
+    SATURATED = 1 << 1
+    """At least one value at the largest integer code."""
+    FLAT = 1 << 2
+    """All finite values are equal (and there are at least two)."""
+    NEGATIVE = 1 << 3
+    """At least one value below zero."""
+
+
+__all__ = ["QualityFlag"]
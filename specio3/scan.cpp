@@ -0,0 +1,260 @@
+#include "scan.h"
+#include "parallel.h"
+#include "spc_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+// Rows decoded per task; a task reopens a file only when its rows move on to the next one.
+constexpr size_t kRowsPerTask = 64;
+
+// Selected point indices of a subfile (ascending) and their X values.
+struct PointPlan {
+    tracked_vector<uint32_t> indices;
+    tracked_vector<double> x;
+};
+
+// One selected subfile.
+struct PlannedRow {
+    uint32_t file;
+    uint32_t subfile;
+    const PointPlan* points;
+};
+
+// A plan resolved against the file headers: everything except the Y data.
+struct ResolvedScan {
+    SPCBatch batch;
+    std::vector<PointPlan> file_points;  ///< Shared by all subfiles of a file (non-XYXY files)
+    std::vector<PointPlan> row_points;   ///< Per row (XYXY files only)
+    std::vector<PlannedRow> rows;
+    tracked_vector<int64_t> offsets;
+};
+
+void select_points(const double* x, size_t n, const ScanPlan& plan, PointPlan& out) {
+    tracked_vector<uint32_t> window;
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] >= plan.x_min && x[i] <= plan.x_max) {
+            window.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (plan.max_points > 0 && window.size() > plan.max_points) {
+        // Evenly spaced over the window, always keeping its first point
+        out.indices.resize(plan.max_points);
+        for (size_t k = 0; k < plan.max_points; ++k) {
+            out.indices[k] = window[static_cast<size_t>(uint64_t{k} * window.size() / plan.max_points)];
+        }
+    } else {
+        out.indices = std::move(window);
+    }
+    out.x.resize(out.indices.size());
+    for (size_t k = 0; k < out.indices.size(); ++k) {
+        out.x[k] = x[out.indices[k]];
+    }
+}
+
+void open_stream(std::ifstream& f, const std::string& path) {
+    f.close();
+    f.clear();
+    f.open(path, std::ios::binary);
+    if (!f) {
+        throw std::runtime_error("Unable to open file: " + path);
+    }
+}
+
+// Buffers reused by the rows of one task.
+struct RowScratch {
+    std::ifstream f;  ///< Open on the current row's file
+    tracked_vector<char> raw;
+    tracked_vector<double> values;
+};
+
+// Run fn(row_index, row, scratch) for every planned row in parallel.
+template <typename Fn>
+void for_each_row(const ResolvedScan& scan, size_t num_threads, Fn&& fn) {
+    const size_t num_tasks = (scan.rows.size() + kRowsPerTask - 1) / kRowsPerTask;
+    parallel_for(num_tasks, num_threads, [&](size_t t) {
+        const size_t end = std::min(scan.rows.size(), (t + 1) * kRowsPerTask);
+        RowScratch scratch;
+        size_t open_file = scan.batch.paths.size();
+        for (size_t r = t * kRowsPerTask; r < end; ++r) {
+            const PlannedRow& row = scan.rows[r];
+            const std::string& path = scan.batch.paths[row.file];
+            try {
+                if (row.file != open_file) {
+                    open_stream(scratch.f, path);
+                    open_file = row.file;
+                }
+                fn(r, row, scratch);
+            } catch (const std::exception& e) {
+                throw std::runtime_error(path + ": " + e.what());
+            }
+        }
+    });
+}
+
+ResolvedScan resolve(const std::vector<std::string>& paths, const ScanPlan& plan, size_t num_threads) {
+    ResolvedScan scan;
+    scan.batch = read_spc_batch(paths, num_threads);
+    const size_t num_files = paths.size();
+
+    // Subfiles by subheader z
+    std::vector<bool> file_selected(num_files, false);
+    bool any_xyxy = false;
+    for (size_t i = 0; i < num_files; ++i) {
+        const SPCLayout& layout = scan.batch.layouts[i];
+        for (uint32_t s = 0; s < layout.num_subfiles; ++s) {
+            const double z = layout.subfiles[s].z_start;
+            if (z >= plan.z_min && z <= plan.z_max) {
+                scan.rows.push_back({static_cast<uint32_t>(i), s, nullptr});
+                file_selected[i] = true;
+                any_xyxy |= layout.is_xyxy;
+            }
+        }
+    }
+
+    // Points by X: once per file with a common axis...
+    scan.file_points.resize(num_files);
+    parallel_for(num_files, num_threads, [&](size_t i) {
+        const SPCLayout& layout = scan.batch.layouts[i];
+        if (!file_selected[i] || layout.is_xyxy) {
+            return;
+        }
+        try {
+            std::ifstream f;
+            open_stream(f, paths[i]);
+            tracked_vector<double> x(layout.num_points);
+            read_subfile_x(f, layout, layout.subfiles[0], x.data());
+            select_points(x.data(), x.size(), plan, scan.file_points[i]);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(paths[i] + ": " + e.what());
+        }
+    });
+
+    // ...and per subfile for XYXY files, whose X arrays are read from each subfile
+    scan.row_points.resize(any_xyxy ? scan.rows.size() : 0);
+    if (any_xyxy) {
+        for_each_row(scan, num_threads, [&](size_t r, const PlannedRow& row, RowScratch& scratch) {
+            const SPCLayout& layout = scan.batch.layouts[row.file];
+            if (layout.is_xyxy) {
+                const SubfileLayout& sub = layout.subfiles[row.subfile];
+                scratch.values.resize(sub.num_points);
+                read_subfile_x(scratch.f, layout, sub, scratch.values.data());
+                select_points(scratch.values.data(), sub.num_points, plan, scan.row_points[r]);
+            }
+        });
+    }
+
+    scan.offsets.assign(scan.rows.size() + 1, 0);
+    for (size_t r = 0; r < scan.rows.size(); ++r) {
+        PlannedRow& row = scan.rows[r];
+        row.points = scan.batch.layouts[row.file].is_xyxy ? &scan.row_points[r] : &scan.file_points[row.file];
+        scan.offsets[r + 1] = scan.offsets[r] + static_cast<int64_t>(row.points->indices.size());
+    }
+    return scan;
+}
+
+// Read and decode only the byte range spanning a row's selected points into
+// scratch.values; returns the point index of scratch.values[0].
+uint32_t read_window(const ResolvedScan& scan, const PlannedRow& row, RowScratch& scratch) {
+    const tracked_vector<uint32_t>& indices = row.points->indices;
+    const SPCLayout& layout = scan.batch.layouts[row.file];
+    const uint32_t first = indices.front();
+    const size_t count = size_t{indices.back()} - first + 1;
+    scratch.values.resize(count);
+    read_subfile_y(scratch.f, layout, layout.subfiles[row.subfile], first, count, scratch.raw, scratch.values.data());
+    return first;
+}
+
+void fill_row_info(const ResolvedScan& scan, tracked_vector<double>& z, tracked_vector<int64_t>& source) {
+    z.resize(scan.rows.size());
+    source.resize(2 * scan.rows.size());
+    for (size_t r = 0; r < scan.rows.size(); ++r) {
+        const PlannedRow& row = scan.rows[r];
+        z[r] = scan.batch.layouts[row.file].subfiles[row.subfile].z_start;
+        source[2 * r] = row.file;
+        source[2 * r + 1] = row.subfile;
+    }
+}
+
+}  // namespace
+
+template <typename T>
+ScannedSpectra<T> scan_collect(const std::vector<std::string>& paths, const ScanPlan& plan, size_t num_threads) {
+    ResolvedScan scan = resolve(paths, plan, num_threads);
+    ScannedSpectra<T> out;
+    out.num_rows = scan.rows.size();
+    const auto total = static_cast<size_t>(scan.offsets.back());
+    out.x.resize(total);
+    out.y.resize(total);
+    fill_row_info(scan, out.z, out.source);
+
+    for_each_row(scan, num_threads, [&](size_t r, const PlannedRow& row, RowScratch& scratch) {
+        const PointPlan& points = *row.points;
+        if (points.indices.empty()) {
+            return;
+        }
+        const uint32_t first = read_window(scan, row, scratch);
+        const tracked_vector<double>& window = scratch.values;
+        T* x = out.x.data() + scan.offsets[r];
+        T* y = out.y.data() + scan.offsets[r];
+        for (size_t k = 0; k < points.indices.size(); ++k) {
+            x[k] = static_cast<T>(points.x[k]);
+            y[k] = static_cast<T>(window[points.indices[k] - first]);
+        }
+    });
+    out.offsets = std::move(scan.offsets);
+    return out;
+}
+
+template ScannedSpectra<float> scan_collect<float>(const std::vector<std::string>&, const ScanPlan&, size_t);
+template ScannedSpectra<double> scan_collect<double>(const std::vector<std::string>&, const ScanPlan&, size_t);
+
+ScanStats scan_stats(const std::vector<std::string>& paths, const ScanPlan& plan, size_t num_threads) {
+    ResolvedScan scan = resolve(paths, plan, num_threads);
+    ScanStats out;
+    const size_t n = scan.rows.size();
+    out.num_rows = n;
+    out.count.resize(n);
+    out.min.assign(n, std::nan(""));
+    out.max.assign(n, std::nan(""));
+    out.mean.assign(n, std::nan(""));
+    out.std.assign(n, std::nan(""));
+    fill_row_info(scan, out.z, out.source);
+
+    for_each_row(scan, num_threads, [&](size_t r, const PlannedRow& row, RowScratch& scratch) {
+        const tracked_vector<uint32_t>& indices = row.points->indices;
+        out.count[r] = static_cast<int64_t>(indices.size());
+        if (indices.empty()) {
+            return;
+        }
+        const uint32_t first = read_window(scan, row, scratch);
+        const tracked_vector<double>& window = scratch.values;
+        // Two passes over the selection: mean first, then the centred sum of squares
+        double lo = window[indices[0] - first];
+        double hi = lo;
+        double sum = 0;
+        bool has_nan = false;
+        for (uint32_t i : indices) {
+            const double y = window[i - first];
+            has_nan |= std::isnan(y);
+            lo = std::min(lo, y);
+            hi = std::max(hi, y);
+            sum += y;
+        }
+        const double mean = sum / static_cast<double>(indices.size());
+        double squares = 0;
+        for (uint32_t i : indices) {
+            const double d = window[i - first] - mean;
+            squares += d * d;
+        }
+        out.min[r] = has_nan ? std::nan("") : lo;
+        out.max[r] = has_nan ? std::nan("") : hi;
+        out.mean[r] = mean;
+        out.std[r] = std::sqrt(squares / static_cast<double>(indices.size()));
+    });
+    return out;
+}
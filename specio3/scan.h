@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "alloc_tracking.h"
+
+/**
+ * The selections of a specio3.scan() expression. Selections always apply
+ * before decimation, whatever order the expression was written in.
+ */
+struct ScanPlan {
+    double z_min = -std::numeric_limits<double>::infinity();  ///< Keep subfiles with z_min <= z_start <= z_max
+    double z_max = std::numeric_limits<double>::infinity();
+    double x_min = -std::numeric_limits<double>::infinity();  ///< Keep points with x_min <= x <= x_max
+    double x_max = std::numeric_limits<double>::infinity();
+    size_t max_points = 0;  ///< Decimate every subfile to at most this many evenly spaced points (0 = all)
+};
+
+/**
+ * Selected subfiles of a scan as ragged arrays (see RaggedSpectra): row i
+ * occupies [offsets[i], offsets[i + 1]) of x and y.
+ */
+template <typename T>
+struct ScannedSpectra {
+    size_t num_rows = 0;
+    tracked_vector<T> x;
+    tracked_vector<T> y;
+    tracked_vector<int64_t> offsets;  ///< num_rows + 1 start offsets
+    tracked_vector<double> z;         ///< z_start of each row
+    tracked_vector<int64_t> source;   ///< (file index, subfile index) of each row, num_rows x 2
+};
+
+/**
+ * Per-row statistics of the selected points of a scan, computed in double
+ * precision. NaN values propagate into min, max, mean and std.
+ */
+struct ScanStats {
+    size_t num_rows = 0;
+    tracked_vector<int64_t> count;  ///< Selected points
+    tracked_vector<double> min;
+    tracked_vector<double> max;
+    tracked_vector<double> mean;
+    tracked_vector<double> std;     ///< Population standard deviation
+    tracked_vector<double> z;
+    tracked_vector<int64_t> source;  ///< (file index, subfile index) of each row, num_rows x 2
+};
+
+/**
+ * Run a scan: decode the selected points of the selected subfiles of a set
+ * of files.
+ *
+ * The headers are parsed first (in parallel) and the plan is resolved from
+ * them: subfiles are chosen by their subheader z, and the point indices by
+ * the X axis, which is read or generated once per file (per subfile for
+ * XYXY files). Only then is spectral data touched: each selected subfile
+ * reads just the byte range spanning its selected points, decodes it and
+ * gathers the selection straight into the output, in parallel.
+ *
+ * @param paths SPC files; rows come out in file then subfile order
+ * @param plan Selections
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Selected spectra, converted to T (float or double)
+ * @throws std::runtime_error naming the file if a file cannot be read
+ */
+template <typename T>
+ScannedSpectra<T> scan_collect(const std::vector<std::string>& paths, const ScanPlan& plan, size_t num_threads);
+
+/**
+ * Run a scan that reduces every selected subfile to statistics instead of
+ * returning its points. Reads the same bytes as scan_collect() but keeps
+ * nothing else.
+ *
+ * @param paths SPC files; rows come out in file then subfile order
+ * @param plan Selections
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Statistics of each selected subfile
+ * @throws std::runtime_error naming the file if a file cannot be read
+ */
+ScanStats scan_stats(const std::vector<std::string>& paths, const ScanPlan& plan, size_t num_threads);
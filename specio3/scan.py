@@ -0,0 +1,178 @@
+"""Lazy scans: selections over a batch of SPC files, pushed down into the I/O."""
+import math
+import os
+from typing import Dict, NamedTuple, Optional, Sequence, Union
+
+import numpy as np
+from numpy.typing import DTypeLike, NDArray
+
+from . import _specio3
+from .library import PathLike
+
+
+class ScanResult(NamedTuple):
+    """
+    Spectra selected by a :class:`Scan`, as ragged arrays.
+
+    Row ``i`` is ``x[offsets[i]:offsets[i + 1]]`` and
+    ``y[offsets[i]:offsets[i + 1]]``, as in :func:`read_spc_ragged`.
+    """
+
+    x: NDArray[np.floating]
+    y: NDArray[np.floating]
+    offsets: NDArray[np.int64]
+    z: NDArray[np.float64]
+    source: NDArray[np.int64]  # (file index, subfile index) of each row
+
+
+def _intersect(current, lo: Optional[float], hi: Optional[float]):
+    lo = -math.inf if lo is None else float(lo)
+    hi = math.inf if hi is None else float(hi)
+    if lo > hi:
+        lo, hi = hi, lo
+    return max(current[0], lo), min(current[1], hi)
+
+
+class Scan:
+    """
+    A lazy query over the spectra of one or more SPC files.
+
+    Create one with :func:`scan`. Every method returns a new ``Scan``; nothing
+    is read until :meth:`collect`. The selections are then planned together:
+    the headers are parsed first, subfiles are chosen by their Z value and
+    points by the X axis, and only the byte range spanning the selected
+    points of each selected subfile is read and decoded, in parallel, straight
+    into the output arrays.
+
+    Selections always apply before decimation, whatever order they are
+    chained in, and repeating a selection narrows it.
+    """
+
+    __slots__ = ("_paths", "_z", "_x", "_max_points", "_dtype", "_stats")
+
+    def __init__(self, paths: Sequence[str], z=(-math.inf, math.inf), x=(-math.inf, math.inf),
+                 max_points: int = 0, dtype: np.dtype = np.dtype(np.float64), stats: bool = False):
+        self._paths = tuple(paths)
+        self._z = z
+        self._x = x
+        self._max_points = max_points
+        self._dtype = dtype
+        self._stats = stats
+
+    def _replace(self, **changes) -> "Scan":
+        fields = dict(paths=self._paths, z=self._z, x=self._x, max_points=self._max_points,
+                      dtype=self._dtype, stats=self._stats)
+        fields.update(changes)
+        return Scan(**fields)
+
+    def select_z(self, lo: Optional[float] = None, hi: Optional[float] = None) -> "Scan":
+        """Keep the subfiles whose Z (start) value lies in ``[lo, hi]``; ``None`` leaves a side open."""
+        return self._replace(z=_intersect(self._z, lo, hi))
+
+    def x_range(self, lo: Optional[float] = None, hi: Optional[float] = None) -> "Scan":
+        """Keep the points whose X lies in ``[lo, hi]``; the bounds may be given in either order."""
+        return self._replace(x=_intersect(self._x, lo, hi))
+
+    def decimate(self, max_points: int) -> "Scan":
+        """Keep at most ``max_points`` evenly spaced points of each subfile's selection."""
+        max_points = int(max_points)
+        if max_points < 1:
+            raise ValueError("max_points must be at least 1")
+        if self._max_points:
+            max_points = min(max_points, self._max_points)
+        return self._replace(max_points=max_points)
+
+    def astype(self, dtype: DTypeLike) -> "Scan":
+        """Return X and Y as ``float32`` or ``float64`` (the default); converted while gathering."""
+        dtype = np.dtype(dtype)
+        if dtype not in (np.dtype(np.float32), np.dtype(np.float64)):
+            raise TypeError(f"scan results can be float32 or float64, not {dtype}")
+        return self._replace(dtype=dtype)
+
+    def map_stats(self) -> "Scan":
+        """
+        Reduce each selected subfile to statistics instead of returning its points.
+
+        :meth:`collect` then returns a dict of arrays with one entry per row:
+        ``count``, ``min``, ``max``, ``mean`` and ``std`` (population), computed
+        in double precision, plus ``z`` and ``source``. Rows with no selected
+        points have a count of 0 and NaN statistics.
+        """
+        return self._replace(stats=True)
+
+    def explain(self) -> str:
+        """Describe the plan :meth:`collect` would run."""
+        lines = [f"scan {len(self._paths)} file(s)"]
+        if self._z != (-math.inf, math.inf):
+            lines.append(f"  subfiles: {self._z[0]} <= z <= {self._z[1]} (from subheaders)")
+        if self._x != (-math.inf, math.inf):
+            lines.append(f"  points: {self._x[0]} <= x <= {self._x[1]} (from the X axis; one byte range per subfile)")
+        if self._max_points:
+            lines.append(f"  decimate: at most {self._max_points} points per subfile")
+        lines.append("  output: per-subfile statistics" if self._stats else f"  output: {self._dtype.name} ragged arrays")
+        return "\n".join(lines)
+
+    def __repr__(self) -> str:
+        return f"<specio3.Scan\n{self.explain()}>"
+
+    def collect(self, num_threads: int = 0) -> Union[ScanResult, Dict[str, np.ndarray]]:
+        """
+        Run the scan.
+
+        Parameters
+        ----------
+        num_threads : int, default 0
+            Worker threads; 0 uses every core.
+
+        Returns
+        -------
+        ScanResult or dict
+            ``(x, y, offsets, z, source)`` ragged arrays with rows in file then
+            subfile order, or the statistics dict after :meth:`map_stats`.
+
+        Raises
+        ------
+        RuntimeError
+            If a file cannot be read; the message names the file.
+        """
+        if self._stats:
+            return _specio3.scan_stats(list(self._paths), *self._z, *self._x, self._max_points, int(num_threads))
+        return ScanResult(*_specio3.scan_collect(list(self._paths), *self._z, *self._x, self._max_points,
+                                                 self._dtype == np.float32, int(num_threads)))
+
+
+def scan(paths: Union[PathLike, Sequence[PathLike]]) -> Scan:
+    """
+    Start a lazy scan over one or more SPC files.
+
+    Parameters
+    ----------
+    paths : str, PathLike or sequence of them
+        SPC files of any type. Rows of the result come out in file then
+        subfile order.
+
+    Returns
+    -------
+    Scan
+        An expression selecting every point of every subfile; narrow it with
+        :meth:`Scan.select_z`, :meth:`Scan.x_range`, :meth:`Scan.decimate`,
+        :meth:`Scan.astype` and :meth:`Scan.map_stats`, then call
+        :meth:`Scan.collect`.
+
+    Examples
+    --------
+    >>> result = (specio3.scan(paths)
+    ...           .select_z(10, 20)
+    ...           .x_range(1000, 1800)
+    ...           .decimate(256)
+    ...           .astype(np.float32)
+    ...           .collect())
+    >>> stats = specio3.scan(paths).x_range(1600, 1700).map_stats().collect()
+    >>> stats["max"]
+    """
+    if isinstance(paths, (str, os.PathLike)):
+        paths = [paths]
+    return Scan([os.fspath(p) for p in paths])
+
+
+__all__ = ["scan", "Scan", "ScanResult"]
@@ -0,0 +1,218 @@
+#include "shard.h"
+#include "parallel.h"
+#include "spc_batch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+constexpr char kShardMagic[8] = {'S', 'P', 'C', 'S', 'H', 'R', 'D', '\0'};
+constexpr char kIndexMagic[8] = {'S', 'P', 'C', 'S', 'H', 'I', 'D', 'X'};
+constexpr uint32_t kShardVersion = 1;
+constexpr uint64_t kHeaderSize = 16;
+constexpr uint64_t kTrailerSize = 24;
+constexpr uint64_t kMemberAlignment = 64;
+// Fixed part of an index entry: offset, length, points, subfiles, first/last X, flags, name length
+constexpr size_t kEntrySize = 48;
+
+enum ShardFlags : uint8_t {
+    kMultifile = 1 << 0,
+    kXY = 1 << 1,
+    kXYXY = 1 << 2,
+    kY16Bit = 1 << 3,
+    kOldFormat = 1 << 4,
+};
+
+template <typename T>
+void append(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write_all(std::ofstream& out, const char* data, size_t size, const std::string& path) {
+    if (!out.write(data, static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Unable to write shard: " + path);
+    }
+}
+
+}  // namespace
+
+size_t pack_shard(const std::vector<std::string>& paths, const std::vector<std::string>& names,
+                  const std::string& output, size_t num_threads) {
+    if (!names.empty() && names.size() != paths.size()) {
+        throw std::runtime_error("Expected one name per path (" + std::to_string(paths.size()) + "), got " +
+                                 std::to_string(names.size()));
+    }
+    std::vector<std::string> member_names = names;
+    if (member_names.empty()) {
+        for (const std::string& p : paths) {
+            member_names.push_back(std::filesystem::path(p).filename().string());
+        }
+    }
+    std::unordered_set<std::string> seen;
+    for (const std::string& name : member_names) {
+        if (!seen.insert(name).second) {
+            throw std::runtime_error("Duplicate shard member name: " + name);
+        }
+    }
+
+    // Validate every input before writing anything
+    const SPCBatch batch = read_spc_batch(paths, num_threads);
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Unable to create shard: " + output);
+    }
+    std::string header(kShardMagic, sizeof(kShardMagic));
+    append(header, kShardVersion);
+    append(header, uint32_t{0});
+    write_all(out, header.data(), header.size(), output);
+
+    std::string index;
+    std::vector<char> buffer(1 << 20);
+    const char zeros[kMemberAlignment] = {};
+    uint64_t pos = kHeaderSize;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const uint64_t padding = (kMemberAlignment - pos % kMemberAlignment) % kMemberAlignment;
+        write_all(out, zeros, padding, output);
+        pos += padding;
+
+        std::ifstream in(paths[i], std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Unable to open file: " + paths[i]);
+        }
+        uint64_t length = 0;
+        while (in) {
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            const auto n = static_cast<size_t>(in.gcount());
+            write_all(out, buffer.data(), n, output);
+            length += n;
+        }
+        const SPCLayout& layout = batch.layouts[i];
+        if (length != layout.file_size) {
+            throw std::runtime_error(paths[i] + ": file changed while packing");
+        }
+
+        const uint8_t flags = (layout.is_multifile ? kMultifile : 0) | (layout.is_xy ? kXY : 0) |
+                              (layout.is_xyxy ? kXYXY : 0) | (layout.y_in_16bit ? kY16Bit : 0) |
+                              (layout.is_old_format ? kOldFormat : 0);
+        append(index, pos);
+        append(index, length);
+        append(index, layout.num_points);
+        append(index, layout.num_subfiles);
+        append(index, layout.first_x);
+        append(index, layout.last_x);
+        append(index, flags);
+        index.append(3, '\0');
+        append(index, static_cast<uint32_t>(member_names[i].size()));
+        index += member_names[i];
+        pos += length;
+    }
+
+    std::string trailer;
+    append(trailer, pos);
+    append(trailer, static_cast<uint64_t>(paths.size()));
+    trailer.append(kIndexMagic, sizeof(kIndexMagic));
+    write_all(out, index.data(), index.size(), output);
+    write_all(out, trailer.data(), trailer.size(), output);
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Unable to write shard: " + output);
+    }
+    return paths.size();
+}
+
+SPCShard::SPCShard(const std::string& path) : path_(path), map_(path) {
+    const char* data = map_.data();
+    const uint64_t size = map_.size();
+    if (size < kHeaderSize + kTrailerSize || std::memcmp(data, kShardMagic, sizeof(kShardMagic)) != 0 ||
+        std::memcmp(data + size - sizeof(kIndexMagic), kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        throw std::runtime_error(path + ": not an SPC shard");
+    }
+    const auto version = read_le<uint32_t>(data + 8);
+    if (version != kShardVersion) {
+        throw std::runtime_error(path + ": unsupported shard version " + std::to_string(version));
+    }
+
+    const char* trailer = data + size - kTrailerSize;
+    const auto index_offset = read_le<uint64_t>(trailer);
+    const auto count = read_le<uint64_t>(trailer + 8);
+    const uint64_t index_end = size - kTrailerSize;
+    if (index_offset < kHeaderSize || index_offset > index_end || count > (index_end - index_offset) / kEntrySize) {
+        throw std::runtime_error(path + ": corrupt shard index");
+    }
+
+    members_.resize(count);
+    uint64_t p = index_offset;
+    for (size_t i = 0; i < count; ++i) {
+        if (index_end - p < kEntrySize) {
+            throw std::runtime_error(path + ": corrupt shard index");
+        }
+        const char* e = data + p;
+        ShardMember& m = members_[i];
+        m.offset = read_le<uint64_t>(e);
+        m.length = read_le<uint64_t>(e + 8);
+        m.num_points = read_le<uint32_t>(e + 16);
+        m.num_subfiles = read_le<uint32_t>(e + 20);
+        m.first_x = read_le<double>(e + 24);
+        m.last_x = read_le<double>(e + 32);
+        const auto flags = static_cast<uint8_t>(e[40]);
+        m.is_multifile = flags & kMultifile;
+        m.is_xy = flags & kXY;
+        m.is_xyxy = flags & kXYXY;
+        m.y_in_16bit = flags & kY16Bit;
+        m.is_old_format = flags & kOldFormat;
+        const auto name_length = read_le<uint32_t>(e + 44);
+        p += kEntrySize;
+        if (index_end - p < name_length || m.offset > index_offset || m.length > index_offset - m.offset) {
+            throw std::runtime_error(path + ": corrupt shard index");
+        }
+        m.name.assign(data + p, name_length);
+        p += name_length;
+        by_name_.emplace(m.name, i);
+    }
+}
+
+const ShardMember& SPCShard::member(size_t index) const {
+    if (index >= members_.size()) {
+        throw std::runtime_error("Shard member " + std::to_string(index) + " out of range for " +
+                                 std::to_string(members_.size()) + " members");
+    }
+    return members_[index];
+}
+
+size_t SPCShard::find(const std::string& name) const {
+    auto it = by_name_.find(name);
+    if (it == by_name_.end()) {
+        throw std::runtime_error(path_ + ": no member named " + name);
+    }
+    return it->second;
+}
+
+SPCFile SPCShard::read(size_t index) const {
+    const ShardMember& m = member(index);
+    try {
+        return read_spc_memory(map_.data() + m.offset, m.length, m.name);
+    } catch (const std::exception& e) {
+        throw std::runtime_error(path_ + ":" + m.name + ": " + e.what());
+    }
+}
+
+std::vector<SPCFile> SPCShard::read_range(size_t first, size_t count, size_t num_threads) const {
+    if (first > members_.size() || count > members_.size() - first) {
+        throw std::runtime_error("Shard members [" + std::to_string(first) + ", " + std::to_string(first + count) +
+                                 ") out of range for " + std::to_string(members_.size()) + " members");
+    }
+    std::vector<SPCFile> out(count);
+    if (count == 0) {
+        return out;
+    }
+    const ShardMember& last = members_[first + count - 1];
+    map_.prefetch(members_[first].offset, last.offset + last.length - members_[first].offset);
+    parallel_for(count, num_threads, [&](size_t i) { out[i] = read(first + i); });
+    return out;
+}
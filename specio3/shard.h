@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mapped_file.h"
+#include "spc_reader.h"
+
+/**
+ * One SPC file stored in a shard, with a summary of its header.
+ */
+struct ShardMember {
+    std::string name;
+    uint64_t offset = 0;        ///< Start of the member's bytes in the shard
+    uint64_t length = 0;        ///< Size of the original file
+    uint32_t num_points = 0;
+    uint32_t num_subfiles = 0;
+    double first_x = 0;
+    double last_x = 0;
+    bool is_multifile = false;
+    bool is_xy = false;
+    bool is_xyxy = false;
+    bool y_in_16bit = false;
+    bool is_old_format = false;
+};
+
+/**
+ * Pack SPC files byte-for-byte into one shard file.
+ *
+ * Layout: a 16-byte header ("SPCSHRD\0", version, reserved), the member
+ * files each starting on a 64-byte boundary, an index of one entry per
+ * member (offset, length, header summary, name) and a 24-byte trailer
+ * (index offset, member count, "SPCSHIDX"). Headers are validated in
+ * parallel before anything is written; the copy itself is sequential.
+ *
+ * @param paths SPC files to pack, in member order
+ * @param names Member names (empty = file names of paths); must be unique
+ * @param output Shard file to write (overwritten)
+ * @param num_threads Worker threads for header parsing (0 = all cores)
+ * @return Number of members written
+ * @throws std::runtime_error if an input is not a readable SPC file, a name
+ *         is repeated or the shard cannot be written
+ */
+size_t pack_shard(const std::vector<std::string>& paths, const std::vector<std::string>& names,
+                  const std::string& output, size_t num_threads);
+
+/**
+ * Read-only view of a shard written by pack_shard().
+ *
+ * The shard is memory-mapped and members are decoded directly from the
+ * mapping through the same parser as standalone files, so opening a member
+ * costs no file open and no copy of its bytes.
+ */
+class SPCShard {
+public:
+    /**
+     * Map a shard and load its index.
+     *
+     * @throws std::runtime_error if the file is not a valid shard
+     */
+    explicit SPCShard(const std::string& path);
+
+    size_t size() const { return members_.size(); }
+    const ShardMember& member(size_t index) const;
+
+    /**
+     * Index of the member with this name.
+     *
+     * @throws std::runtime_error if there is no such member
+     */
+    size_t find(const std::string& name) const;
+
+    /** Raw bytes of a member inside the mapping. */
+    const char* member_data(size_t index) const { return map_.data() + member(index).offset; }
+
+    /**
+     * Decode one member.
+     *
+     * @throws std::runtime_error naming the member if it cannot be decoded
+     */
+    SPCFile read(size_t index) const;
+
+    /**
+     * Decode members [first, first + count) in parallel. The byte range is
+     * prefetched first, so sequential scans stream from disk.
+     */
+    std::vector<SPCFile> read_range(size_t first, size_t count, size_t num_threads) const;
+
+private:
+    std::string path_;
+    MappedFile map_;
+    std::vector<ShardMember> members_;
+    std::unordered_map<std::string, size_t> by_name_;
+};
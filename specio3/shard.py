@@ -0,0 +1,131 @@
+"""Packing many small SPC files into large shard files."""
+import os
+from typing import Any, Dict, Iterator, List, Optional, Sequence, Tuple, Union
+
+from . import _specio3
+from .library import PathLike
+from .spectrum import Spectrum, spectra_from_dict
+
+MemberKey = Union[int, str]
+
+
+def pack_shard(
+    paths: Sequence[PathLike],
+    output: PathLike,
+    names: Optional[Sequence[str]] = None,
+    num_threads: int = 0,
+) -> "Shard":
+    """
+    Pack SPC files byte-for-byte into one shard file and open it.
+
+    Millions of small files are slow on every filesystem; a shard stores them
+    back to back (64-byte aligned) followed by an index of member names,
+    offsets, lengths and a summary of each header. Members are read straight
+    from the memory-mapped shard by :class:`Shard`.
+
+    Parameters
+    ----------
+    paths : sequence of str or PathLike
+        SPC files to pack, in member order. Every header is validated (in
+        parallel) before anything is written.
+    output : str or PathLike
+        Shard file to write. An existing file is overwritten.
+    names : sequence of str, optional
+        Member names; defaults to the file names of ``paths``. Must be unique.
+    num_threads : int, default 0
+        Worker threads for header validation; 0 uses every core.
+
+    Returns
+    -------
+    Shard
+        The new shard.
+
+    Raises
+    ------
+    RuntimeError
+        If an input is not a readable SPC file, a name is repeated or the
+        shard cannot be written.
+    """
+    _specio3.pack_shard(
+        [os.fspath(p) for p in paths],
+        [] if names is None else [str(n) for n in names],
+        os.fspath(output),
+        int(num_threads),
+    )
+    return Shard(output)
+
+
+class Shard:
+    """
+    Read-only, memory-mapped view of a shard written by :func:`pack_shard`.
+
+    Members are addressed by index or by name and decoded from the mapping
+    with the same parser as standalone files. Iterating scans members in
+    order, decoding batches in parallel while the next bytes are prefetched.
+
+    Examples
+    --------
+    >>> shard = specio3.pack_shard(sorted(glob.glob("run/*.spc")), "run.spcshard")
+    >>> x, y = shard.read("sample_0042.spc")[0]
+    >>> for name, spectra in shard:
+    ...     process(name, spectra)
+    """
+
+    def __init__(self, path: PathLike):
+        self._shard = _specio3.SPCShard(os.fspath(path))
+
+    def __len__(self) -> int:
+        return len(self._shard)
+
+    def __contains__(self, name: str) -> bool:
+        try:
+            self._shard.index(name)
+        except RuntimeError:
+            return False
+        return True
+
+    @property
+    def names(self) -> List[str]:
+        """Member names in shard order."""
+        return [self._shard.name(i) for i in range(len(self._shard))]
+
+    def _index(self, key: MemberKey) -> int:
+        if isinstance(key, str):
+            return self._shard.index(key)
+        index = int(key)
+        return index + len(self._shard) if index < 0 else index
+
+    def info(self, key: MemberKey) -> Dict[str, Any]:
+        """Index entry of a member: name, offset, length and header summary."""
+        return self._shard.info(self._index(key))
+
+    def read(self, key: MemberKey) -> List[Spectrum]:
+        """Decode a member by index or name; returns the same list as :func:`read_spc`."""
+        return spectra_from_dict(self._shard.read(self._index(key)))
+
+    def read_bytes(self, key: MemberKey) -> bytes:
+        """Original file contents of a member."""
+        return self._shard.read_bytes(self._index(key))
+
+    def scan(self, batch_size: int = 256, num_threads: int = 0) -> Iterator[Tuple[str, List[Spectrum]]]:
+        """
+        Yield ``(name, spectra)`` for every member in shard order.
+
+        Parameters
+        ----------
+        batch_size : int, default 256
+            Members decoded together; their bytes are prefetched as one range.
+        num_threads : int, default 0
+            Worker threads per batch; 0 uses every core.
+        """
+        batch_size = max(int(batch_size), 1)
+        for first in range(0, len(self._shard), batch_size):
+            count = min(batch_size, len(self._shard) - first)
+            for i, result in enumerate(self._shard.read_range(first, count, int(num_threads))):
+                yield self._shard.name(first + i), spectra_from_dict(result)
+
+    def __iter__(self) -> Iterator[Tuple[str, List[Spectrum]]]:
+        return self.scan()
+
+
+__all__ = ["pack_shard", "Shard"]
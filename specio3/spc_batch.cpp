@@ -0,0 +1,60 @@
+#include "spc_batch.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+struct SubfileChunk {
+    size_t file;
+    uint32_t first_subfile;
+    uint32_t end_subfile;
+};
+
+}  // namespace
+
+SPCBatch read_spc_batch(const std::vector<std::string>& paths, size_t num_threads) {
+    SPCBatch batch;
+    batch.paths = paths;
+    batch.layouts.resize(paths.size());
+    parallel_for(paths.size(), num_threads, [&](size_t i) {
+        try {
+            batch.layouts[i] = read_spc_layout(paths[i]);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(paths[i] + ": " + e.what());
+        }
+    });
+
+    batch.first_row.assign(paths.size() + 1, 0);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        batch.first_row[i + 1] = batch.first_row[i] + batch.layouts[i].num_subfiles;
+    }
+    return batch;
+}
+
+void for_each_subfile_chunk(const SPCBatch& batch, uint32_t subfiles_per_task, size_t num_threads,
+                            const SubfileChunkFn& fn) {
+    subfiles_per_task = std::max<uint32_t>(subfiles_per_task, 1);
+    std::vector<SubfileChunk> chunks;
+    for (size_t i = 0; i < batch.layouts.size(); ++i) {
+        const uint32_t num_subfiles = batch.layouts[i].num_subfiles;
+        for (uint32_t s = 0; s < num_subfiles; s += subfiles_per_task) {
+            chunks.push_back({i, s, std::min(num_subfiles, s + subfiles_per_task)});
+        }
+    }
+
+    parallel_for(chunks.size(), num_threads, [&](size_t c) {
+        const SubfileChunk& chunk = chunks[c];
+        const std::string& path = batch.paths[chunk.file];
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            throw std::runtime_error("Unable to open file: " + path);
+        }
+        try {
+            fn(f, chunk.file, chunk.first_subfile, chunk.end_subfile);
+        } catch (const std::exception& e) {
+            throw std::runtime_error(path + ": " + e.what());
+        }
+    });
+}
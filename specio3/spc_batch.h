@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "spc_reader.h"
+
+/**
+ * Layouts of a batch of SPC files, with every subfile numbered consecutively
+ * in file then subfile order. Batch readers use the numbering to write each
+ * subfile's result to a fixed output row.
+ */
+struct SPCBatch {
+    std::vector<std::string> paths;
+    tracked_vector<SPCLayout> layouts;  ///< One per path
+    std::vector<size_t> first_row;      ///< Row of each file's first subfile; back() is the total
+
+    size_t num_rows() const { return first_row.empty() ? 0 : first_row.back(); }
+};
+
+/**
+ * Parse the headers of a batch of SPC files in parallel.
+ *
+ * @param paths SPC files
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Layouts and row numbering
+ * @throws std::runtime_error naming the file if a header cannot be read
+ */
+SPCBatch read_spc_batch(const std::vector<std::string>& paths, size_t num_threads);
+
+/**
+ * Called for a run of subfiles [first_subfile, end_subfile) of file `file`,
+ * with a stream opened on that file for the duration of the call.
+ */
+using SubfileChunkFn = std::function<void(std::ifstream& f, size_t file, uint32_t first_subfile,
+                                          uint32_t end_subfile)>;
+
+/**
+ * Run fn over every subfile of a batch in parallel. Work is split into
+ * chunks of up to subfiles_per_task subfiles so large multifiles are shared
+ * between threads; each chunk opens its own stream.
+ *
+ * @param batch Batch from read_spc_batch()
+ * @param subfiles_per_task Maximum subfiles per chunk
+ * @param num_threads Worker threads (0 = all cores)
+ * @param fn Chunk callback; exceptions are rethrown prefixed with the file name
+ */
+void for_each_subfile_chunk(const SPCBatch& batch, uint32_t subfiles_per_task, size_t num_threads,
+                            const SubfileChunkFn& fn);
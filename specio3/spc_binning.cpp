@@ -0,0 +1,217 @@
+#include "spc_binning.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "spc_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Subfiles decoded per task; XYXY files often have thousands of short subfiles.
+constexpr size_t kSubfilesPerTask = 64;
+
+struct MappedSPC {
+    MappedFile map;
+    SPCLayout layout;
+
+    explicit MappedSPC(const std::string& path) : map(path) {
+        MemoryInputStream stream(map.data(), map.size());
+        layout = read_spc_layout(stream, map.size());
+        for (uint32_t s = 0; s < layout.num_subfiles; ++s) {
+            const SubfileLayout& sub = layout.subfiles[s];
+            if (sub.y_offset + uint64_t{sub.num_points} * layout.y_value_size(sub) > map.size() ||
+                (layout.is_xyxy && sub.x_offset + uint64_t{sub.num_points} * sizeof(float) > map.size())) {
+                throw std::runtime_error("Subfile " + std::to_string(s) + " extends past the end of the file (" +
+                                         std::to_string(map.size()) + " bytes)");
+            }
+        }
+    }
+
+    double xyxy_x(const SubfileLayout& sub, uint32_t i) const {
+        return static_cast<double>(read_le<float>(map.data() + sub.x_offset + size_t{i} * sizeof(float)));
+    }
+
+    tracked_vector<double> shared_x() const {
+        tracked_vector<double> x(layout.num_points);
+        MemoryInputStream stream(map.data(), map.size());
+        read_subfile_x(stream, layout, layout.subfiles[0], x.data());
+        return x;
+    }
+};
+
+// Maps an X value to its bin, or to num_bins if it falls outside the edges.
+class BinLocator {
+public:
+    explicit BinLocator(const tracked_vector<double>& edges)
+        : edges_(edges.data()), num_bins_(edges.size() - 1), lo_(edges.front()), hi_(edges.back()),
+          scale_(static_cast<double>(num_bins_) / (hi_ - lo_)) {}
+
+    size_t operator()(double x) const {
+        if (!(x >= lo_ && x <= hi_)) {
+            return num_bins_;
+        }
+        // Guess as if the bins were equal-width; exact for uniform grids, else search
+        size_t i = std::min(num_bins_ - 1, static_cast<size_t>((x - lo_) * scale_));
+        if (x < edges_[i] || (x >= edges_[i + 1] && i + 1 < num_bins_)) {
+            i = static_cast<size_t>(std::upper_bound(edges_, edges_ + num_bins_, x) - edges_) - 1;
+        }
+        return i;
+    }
+
+private:
+    const double* edges_;
+    size_t num_bins_;
+    double lo_;
+    double hi_;
+    double scale_;
+};
+
+BinnedSpectra bin_mapped(const MappedSPC& file, tracked_vector<double> edges, size_t num_threads) {
+    if (edges.size() < 2) {
+        throw std::runtime_error("Binning needs at least two edges");
+    }
+    for (size_t i = 0; i + 1 < edges.size(); ++i) {
+        if (!(edges[i] < edges[i + 1]) || !std::isfinite(edges[i]) || !std::isfinite(edges[i + 1])) {
+            throw std::runtime_error("Bin edges must be finite and strictly increasing");
+        }
+    }
+    const SPCLayout& layout = file.layout;
+    const size_t rows = layout.num_subfiles;
+    const size_t bins = edges.size() - 1;
+    if (rows != 0 && bins > std::numeric_limits<size_t>::max() / sizeof(double) / rows) {
+        throw std::runtime_error("Binned matrix of " + std::to_string(rows) + " x " + std::to_string(bins) +
+                                 " values is too large");
+    }
+
+    BinnedSpectra out;
+    out.num_subfiles = rows;
+    out.num_bins = bins;
+    out.values.assign(rows * bins, 0.0);
+    out.z.resize(rows);
+    for (size_t s = 0; s < rows; ++s) {
+        out.z[s] = layout.subfiles[s].z_start;
+    }
+    out.edges = std::move(edges);
+    const BinLocator locate(out.edges);
+
+    // Files with a common X axis locate the bin of every point once
+    tracked_vector<size_t> shared_bins;
+    if (!layout.is_xyxy && rows != 0) {
+        const tracked_vector<double> x = file.shared_x();
+        shared_bins.resize(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            shared_bins[i] = locate(x[i]);
+        }
+    }
+
+    const size_t num_tasks = (rows + kSubfilesPerTask - 1) / kSubfilesPerTask;
+    parallel_for(num_tasks, num_threads, [&](size_t t) {
+        const size_t end = std::min(rows, (t + 1) * kSubfilesPerTask);
+        tracked_vector<double> y;
+        for (size_t s = t * kSubfilesPerTask; s < end; ++s) {
+            const SubfileLayout& sub = layout.subfiles[s];
+            y.resize(sub.num_points);
+            decode_y_values(layout, sub, file.map.data() + sub.y_offset, sub.num_points, y.data());
+            double* row = out.values.data() + s * bins;
+            if (layout.is_xyxy) {
+                for (uint32_t i = 0; i < sub.num_points; ++i) {
+                    const size_t b = locate(file.xyxy_x(sub, i));
+                    if (b < bins) {
+                        row[b] += y[i];
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < y.size(); ++i) {
+                    if (shared_bins[i] < bins) {
+                        row[shared_bins[i]] += y[i];
+                    }
+                }
+            }
+        }
+    });
+    return out;
+}
+
+// Smallest and largest finite X of any subfile, NaN if there are none.
+std::pair<double, double> x_extent(const MappedSPC& file, size_t num_threads) {
+    const SPCLayout& layout = file.layout;
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+    auto include = [](double x, double& lo, double& hi) {
+        if (std::isfinite(x)) {
+            lo = std::min(lo, x);
+            hi = std::max(hi, x);
+        }
+    };
+    if (!layout.is_xyxy) {
+        if (layout.num_subfiles != 0) {
+            for (double x : file.shared_x()) {
+                include(x, lo, hi);
+            }
+        }
+    } else {
+        const size_t num_tasks = (layout.num_subfiles + kSubfilesPerTask - 1) / kSubfilesPerTask;
+        std::vector<std::pair<double, double>> partial(num_tasks, {lo, hi});
+        parallel_for(num_tasks, num_threads, [&](size_t t) {
+            const size_t end = std::min<size_t>(layout.num_subfiles, (t + 1) * kSubfilesPerTask);
+            for (size_t s = t * kSubfilesPerTask; s < end; ++s) {
+                const SubfileLayout& sub = layout.subfiles[s];
+                for (uint32_t i = 0; i < sub.num_points; ++i) {
+                    include(file.xyxy_x(sub, i), partial[t].first, partial[t].second);
+                }
+            }
+        });
+        for (const auto& [task_lo, task_hi] : partial) {
+            lo = std::min(lo, task_lo);
+            hi = std::max(hi, task_hi);
+        }
+    }
+    if (lo > hi) {
+        return {std::nan(""), std::nan("")};
+    }
+    return {lo, hi};
+}
+
+}  // namespace
+
+BinnedSpectra read_spc_binned(const std::string& path, const std::vector<double>& edges, size_t num_threads) {
+    const MappedSPC file(path);
+    return bin_mapped(file, tracked_vector<double>(edges.begin(), edges.end()), num_threads);
+}
+
+BinnedSpectra read_spc_binned(const std::string& path, double width, double lo, double hi, size_t num_threads) {
+    if (!(width > 0) || !std::isfinite(width)) {
+        throw std::runtime_error("Bin width must be positive");
+    }
+    const MappedSPC file(path);
+    if (std::isnan(lo) || std::isnan(hi)) {
+        const auto [x_lo, x_hi] = x_extent(file, num_threads);
+        if (std::isnan(x_lo)) {
+            throw std::runtime_error("Cannot derive a bin range from a file without finite X values");
+        }
+        lo = std::isnan(lo) ? x_lo : lo;
+        hi = std::isnan(hi) ? x_hi : hi;
+    }
+    if (!std::isfinite(lo) || !std::isfinite(hi) || hi < lo) {
+        throw std::runtime_error("Bin range must be finite with lo <= hi");
+    }
+    if ((hi - lo) / width > static_cast<double>(std::numeric_limits<uint32_t>::max())) {
+        throw std::runtime_error("Bin width is too small for the range");
+    }
+    // Enough bins for the last edge to reach hi; at least one
+    auto num_bins = static_cast<size_t>(std::max(1.0, std::ceil((hi - lo) / width)));
+    while (lo + static_cast<double>(num_bins) * width < hi) {
+        ++num_bins;
+    }
+    tracked_vector<double> edges(num_bins + 1);
+    for (size_t i = 0; i <= num_bins; ++i) {
+        edges[i] = lo + static_cast<double>(i) * width;
+    }
+    return bin_mapped(file, std::move(edges), num_threads);
+}
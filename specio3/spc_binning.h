@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "alloc_tracking.h"
+
+/**
+ * All subfiles of an SPC file binned onto one X grid: row s of the
+ * (num_subfiles x num_bins) matrix holds the summed Y values of subfile s
+ * whose X falls in each bin.
+ */
+struct BinnedSpectra {
+    size_t num_subfiles = 0;
+    size_t num_bins = 0;
+    tracked_vector<double> values;  ///< num_subfiles x num_bins, row-major
+    tracked_vector<double> edges;   ///< num_bins + 1 ascending bin edges
+    tracked_vector<double> z;       ///< z_start of each subfile
+};
+
+/**
+ * Bin every subfile of an SPC file, summing the Y values in each bin.
+ *
+ * Bins follow numpy.histogram: bin i is [edges[i], edges[i + 1]) except the
+ * last, which also includes its upper edge. Points outside the edges or with
+ * a NaN X are dropped. The matrix is allocated once and subfiles are decoded
+ * from the memory-mapped file and scattered into their own rows in parallel.
+ * Meant for centroided XYXY mass spectra, but any file type is accepted;
+ * files with a common X axis locate the bin of each point only once.
+ *
+ * @param path SPC file
+ * @param edges At least two strictly increasing bin edges
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Binned matrix, the edges and z values
+ * @throws std::runtime_error if the edges are invalid, the file cannot be
+ *         read or a subfile extends past its end
+ */
+BinnedSpectra read_spc_binned(const std::string& path, const std::vector<double>& edges, size_t num_threads);
+
+/**
+ * Bin every subfile of an SPC file onto a grid of equal-width bins
+ * starting at lo: edges lo, lo + width, ... up to the first edge >= hi.
+ *
+ * @param path SPC file
+ * @param width Bin width (> 0)
+ * @param lo Lower edge of the grid; NaN uses the smallest X in the file
+ * @param hi X the grid must reach; NaN uses the largest X in the file
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Binned matrix, the edges and z values
+ * @throws std::runtime_error if the grid is invalid, the file cannot be read
+ *         or a subfile extends past its end
+ */
+BinnedSpectra read_spc_binned(const std::string& path, double width, double lo, double hi, size_t num_threads);
@@ -0,0 +1,68 @@
+#include "spc_handle.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+SPCHandle::SPCHandle(const std::string& path) : path_(path), map_(path) {
+    MemoryInputStream stream(map_.data(), map_.size());
+    layout_ = read_spc_layout(stream, map_.size());
+
+    for (uint32_t s = 0; s < layout_.num_subfiles; ++s) {
+        const SubfileLayout& sub = layout_.subfiles[s];
+        if (sub.y_offset + uint64_t{sub.num_points} * layout_.y_value_size(sub) > map_.size() ||
+            (layout_.is_xyxy && sub.x_offset + uint64_t{sub.num_points} * sizeof(float) > map_.size())) {
+            throw std::runtime_error("Subfile " + std::to_string(s) + " extends past the end of the file (" +
+                                     std::to_string(map_.size()) + " bytes)");
+        }
+    }
+    if (!layout_.is_xyxy && layout_.num_subfiles != 0) {
+        shared_x_.resize(layout_.num_points);
+        read_subfile_x(stream, layout_, layout_.subfiles[0], shared_x_.data());
+    }
+}
+
+const SubfileLayout& SPCHandle::subfile_layout(uint32_t subfile) const {
+    if (subfile >= layout_.num_subfiles) {
+        throw std::runtime_error("Subfile " + std::to_string(subfile) + " out of range for " +
+                                 std::to_string(layout_.num_subfiles) + " subfiles");
+    }
+    return layout_.subfiles[subfile];
+}
+
+void SPCHandle::read_x(uint32_t subfile, double* out) const {
+    const SubfileLayout& sub = subfile_layout(subfile);
+    if (!layout_.is_xyxy) {
+        std::copy(shared_x_.begin(), shared_x_.end(), out);
+        return;
+    }
+    const char* raw = map_.data() + sub.x_offset;
+    for (uint32_t i = 0; i < sub.num_points; ++i) {
+        out[i] = static_cast<double>(read_le<float>(raw + i * sizeof(float)));
+    }
+}
+
+void SPCHandle::check_point_range(uint32_t subfile, size_t first, size_t count) const {
+    const uint32_t num_points = subfile_layout(subfile).num_points;
+    if (first > num_points || count > num_points - first) {
+        throw std::runtime_error(std::to_string(count) + " points from index " + std::to_string(first) +
+                                 " out of range for a subfile of " + std::to_string(num_points) + " points");
+    }
+}
+
+void SPCHandle::read_y(uint32_t subfile, size_t first, size_t count, double* out) const {
+    check_point_range(subfile, first, count);
+    const SubfileLayout& sub = layout_.subfiles[subfile];
+    decode_y_values(layout_, sub, map_.data() + sub.y_offset + first * layout_.y_value_size(sub), count, out);
+}
+
+Subfile SPCHandle::read_subfile(uint32_t subfile) const {
+    const SubfileLayout& sub = subfile_layout(subfile);
+    Subfile out;
+    out.z_start = sub.z_start;
+    out.z_end = sub.z_end;
+    out.x.resize(sub.num_points);
+    out.y.resize(sub.num_points);
+    read_x(subfile, out.x.data());
+    read_y(subfile, 0, sub.num_points, out.y.data());
+    return out;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "alloc_tracking.h"
+#include "mapped_file.h"
+#include "spc_reader.h"
+
+/**
+ * Open SPC file that many threads can decode from at once.
+ *
+ * The file is memory-mapped and its layout parsed (and bounds-checked) once
+ * in the constructor. Every read method is const and only reads from the
+ * mapping at precomputed offsets -- there is no shared stream position -- so
+ * any number of threads may decode the same or different subfiles
+ * concurrently without locking.
+ */
+class SPCHandle {
+public:
+    /**
+     * Map an SPC file and parse its headers.
+     *
+     * @param path SPC file
+     * @throws std::runtime_error if the file cannot be mapped, its header is
+     *         invalid or any subfile extends past the end of the file
+     */
+    explicit SPCHandle(const std::string& path);
+
+    const std::string& path() const { return path_; }
+    const SPCLayout& layout() const { return layout_; }
+    size_t size() const { return layout_.num_subfiles; }
+
+    /** Number of points in a subfile. */
+    uint32_t num_points(uint32_t subfile) const { return subfile_layout(subfile).num_points; }
+
+    /**
+     * Decode the X values of a subfile.
+     *
+     * @param subfile Subfile index
+     * @param out Output buffer of num_points(subfile) doubles
+     */
+    void read_x(uint32_t subfile, double* out) const;
+
+    /**
+     * Check that points [first, first + count) lie inside a subfile.
+     *
+     * @throws std::runtime_error if the subfile index or the range is out of range
+     */
+    void check_point_range(uint32_t subfile, size_t first, size_t count) const;
+
+    /**
+     * Decode Y values [first, first + count) of a subfile.
+     *
+     * @param subfile Subfile index
+     * @param first Index of the first point
+     * @param count Number of points
+     * @param out Output buffer of count doubles
+     * @throws std::runtime_error if the range is outside the subfile
+     */
+    void read_y(uint32_t subfile, size_t first, size_t count, double* out) const;
+
+    /**
+     * Decode one whole subfile, with the same values read_spc_impl() produces.
+     *
+     * @throws std::runtime_error if the index is out of range
+     */
+    Subfile read_subfile(uint32_t subfile) const;
+
+private:
+    const SubfileLayout& subfile_layout(uint32_t subfile) const;
+
+    std::string path_;
+    MappedFile map_;
+    SPCLayout layout_;
+    tracked_vector<double> shared_x_;  ///< Decoded common X axis (non-XYXY files)
+};
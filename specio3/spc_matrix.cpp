@@ -0,0 +1,126 @@
+#include "spc_matrix.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "spc_reader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+// Tile of 64 subfiles x 256 points: 128 KiB of doubles, resident in L2 while
+// it is transposed, and 512-byte contiguous runs on both the read and write side.
+constexpr size_t kTileSubfiles = 64;
+constexpr size_t kTilePoints = 256;
+
+// Subfiles decoded per task for the row-major layout.
+constexpr size_t kRowsPerTask = 64;
+
+}  // namespace
+
+SpectraMatrix read_spc_matrix(const std::string& path, bool transposed, size_t num_threads, bool check_quality) {
+    SpectraMatrix out;
+    SPCLayout layout;
+    {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            throw std::runtime_error("Unable to open file: " + path);
+        }
+        f.seekg(0, std::ios::end);
+        layout = read_spc_layout(f, static_cast<uint64_t>(f.tellg()));
+        if (layout.is_xyxy) {
+            throw std::runtime_error("XYXY files have a separate X axis per subfile and cannot be read as a matrix");
+        }
+        if (layout.num_subfiles == 0) {
+            throw std::runtime_error(path + ": file has no subfiles");
+        }
+        out.x.resize(layout.num_points);
+        read_subfile_x(f, layout, layout.subfiles[0], out.x.data());
+    }
+
+    MappedFile map(path);
+    for (const SubfileLayout& sub : layout.subfiles) {
+        if (sub.y_offset + uint64_t{sub.num_points} * layout.y_value_size(sub) > map.size()) {
+            throw std::runtime_error("Y data at offset " + std::to_string(sub.y_offset) +
+                                     " extends past the end of the file (" + std::to_string(map.size()) + " bytes)");
+        }
+    }
+
+    const size_t rows = layout.num_subfiles;
+    const size_t cols = layout.num_points;
+    out.num_subfiles = rows;
+    out.num_points = cols;
+    out.transposed = transposed;
+    out.values.resize(rows * cols);
+    out.z.resize(rows);
+    for (size_t s = 0; s < rows; ++s) {
+        out.z[s] = layout.subfiles[s].z_start;
+    }
+    if (check_quality) {
+        out.quality.resize(rows);
+    }
+
+    if (!transposed) {
+        const size_t num_tasks = (rows + kRowsPerTask - 1) / kRowsPerTask;
+        parallel_for(num_tasks, num_threads, [&](size_t t) {
+            const size_t end = std::min(rows, (t + 1) * kRowsPerTask);
+            for (size_t s = t * kRowsPerTask; s < end; ++s) {
+                const SubfileLayout& sub = layout.subfiles[s];
+                const char* raw = map.data() + sub.y_offset;
+                if (check_quality) {
+                    decode_y_values_checked(layout, sub, raw, cols, out.values.data() + s * cols, out.quality[s]);
+                    finish_quality_check(layout, sub, raw, out.quality[s]);
+                } else {
+                    decode_y_values(layout, sub, raw, cols, out.values.data() + s * cols);
+                }
+            }
+        });
+        return out;
+    }
+
+    const size_t row_tiles = (rows + kTileSubfiles - 1) / kTileSubfiles;
+    const size_t col_tiles = (cols + kTilePoints - 1) / kTilePoints;
+    // Tiles of the same subfiles run concurrently; each merges its counters under its row of tiles' lock
+    std::vector<std::mutex> quality_locks(check_quality ? row_tiles : 0);
+    parallel_for(row_tiles * col_tiles, num_threads, [&](size_t t) {
+        const size_t s0 = (t / col_tiles) * kTileSubfiles;
+        const size_t p0 = (t % col_tiles) * kTilePoints;
+        const size_t ns = std::min(kTileSubfiles, rows - s0);
+        const size_t np = std::min(kTilePoints, cols - p0);
+
+        // Decode each subfile's slice of the tile contiguously...
+        tracked_vector<double> tile(kTileSubfiles * kTilePoints);
+        SubfileQuality tile_quality[kTileSubfiles];
+        for (size_t i = 0; i < ns; ++i) {
+            const SubfileLayout& sub = layout.subfiles[s0 + i];
+            const char* raw = map.data() + sub.y_offset + p0 * layout.y_value_size(sub);
+            if (check_quality) {
+                decode_y_values_checked(layout, sub, raw, np, tile.data() + i * kTilePoints, tile_quality[i]);
+            } else {
+                decode_y_values(layout, sub, raw, np, tile.data() + i * kTilePoints);
+            }
+        }
+        if (check_quality) {
+            std::lock_guard<std::mutex> lock(quality_locks[s0 / kTileSubfiles]);
+            for (size_t i = 0; i < ns; ++i) {
+                out.quality[s0 + i].merge(tile_quality[i]);
+            }
+        }
+        // ...then write it out one point (output row) at a time
+        double* dst = out.values.data() + p0 * rows + s0;
+        for (size_t j = 0; j < np; ++j, dst += rows) {
+            for (size_t i = 0; i < ns; ++i) {
+                dst[i] = tile[i * kTilePoints + j];
+            }
+        }
+    });
+    if (check_quality) {
+        parallel_for(rows, num_threads, [&](size_t s) {
+            const SubfileLayout& sub = layout.subfiles[s];
+            finish_quality_check(layout, sub, map.data() + sub.y_offset, out.quality[s]);
+        });
+    }
+    return out;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "alloc_tracking.h"
+#include "spc_reader.h"
+
+/**
+ * All subfiles of an SPC file with a common X axis as one dense matrix.
+ * values is (num_subfiles x num_points) row-major, or (num_points x
+ * num_subfiles) row-major when transposed, i.e. every X position is then a
+ * contiguous series over the subfiles.
+ */
+struct SpectraMatrix {
+    size_t num_subfiles = 0;
+    size_t num_points = 0;
+    bool transposed = false;
+    tracked_vector<double> x;       ///< Common X axis (num_points)
+    tracked_vector<double> values;  ///< Y values in the layout selected by transposed
+    tracked_vector<double> z;       ///< z_start of each subfile
+    tracked_vector<SubfileQuality> quality;  ///< Per-subfile checks (empty unless requested)
+};
+
+/**
+ * Decode an SPC file straight into a dense matrix.
+ *
+ * The transposed layout is produced without an intermediate copy: the file
+ * is memory-mapped and decoded in tiles of subfiles x points that fit in
+ * cache, each tile being written out column-wise, so neither the reads nor
+ * the writes stride across the whole matrix. Tiles are processed in parallel.
+ *
+ * @param path SPC file (Y-only, XY or XYY; XYXY files have no common X axis)
+ * @param transposed Produce (num_points x num_subfiles) instead of (num_subfiles x num_points)
+ * @param num_threads Worker threads (0 = all cores)
+ * @param check_quality Also fill SpectraMatrix::quality, in the decoding pass
+ * @return Matrix, X axis and subfile z values
+ * @throws std::runtime_error if the file cannot be read or is XYXY
+ */
+SpectraMatrix read_spc_matrix(const std::string& path, bool transposed, size_t num_threads,
+                              bool check_quality = false);
@@ -0,0 +1,71 @@
+#include "spc_ragged.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "spc_reader.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Subfiles decoded per task; XYXY files often have thousands of short subfiles.
+constexpr size_t kSubfilesPerTask = 64;
+
+}  // namespace
+
+RaggedSpectra read_spc_ragged(const std::string& path, size_t num_threads) {
+    MappedFile map(path);
+    SPCLayout layout;
+    {
+        MemoryInputStream stream(map.data(), map.size());
+        layout = read_spc_layout(stream, map.size());
+    }
+
+    RaggedSpectra out;
+    const size_t rows = layout.num_subfiles;
+    out.num_subfiles = rows;
+    out.offsets.resize(rows + 1);
+    out.z.resize(rows);
+    uint64_t total = 0;
+    for (size_t s = 0; s < rows; ++s) {
+        const SubfileLayout& sub = layout.subfiles[s];
+        if (sub.y_offset + uint64_t{sub.num_points} * layout.y_value_size(sub) > map.size() ||
+            (layout.is_xyxy && sub.x_offset + uint64_t{sub.num_points} * sizeof(float) > map.size())) {
+            throw std::runtime_error("Subfile " + std::to_string(s) + " extends past the end of the file (" +
+                                     std::to_string(map.size()) + " bytes)");
+        }
+        out.offsets[s] = static_cast<int64_t>(total);
+        out.z[s] = sub.z_start;
+        total += sub.num_points;
+    }
+    out.offsets[rows] = static_cast<int64_t>(total);
+    out.x.resize(total);
+    out.y.resize(total);
+
+    // Files with a common X axis decode it once and copy it into every slice
+    tracked_vector<double> shared_x;
+    if (!layout.is_xyxy && rows != 0) {
+        shared_x.resize(layout.num_points);
+        MemoryInputStream stream(map.data(), map.size());
+        read_subfile_x(stream, layout, layout.subfiles[0], shared_x.data());
+    }
+
+    const size_t num_tasks = (rows + kSubfilesPerTask - 1) / kSubfilesPerTask;
+    parallel_for(num_tasks, num_threads, [&](size_t t) {
+        const size_t end = std::min(rows, (t + 1) * kSubfilesPerTask);
+        for (size_t s = t * kSubfilesPerTask; s < end; ++s) {
+            const SubfileLayout& sub = layout.subfiles[s];
+            double* x = out.x.data() + out.offsets[s];
+            if (layout.is_xyxy) {
+                const char* raw = map.data() + sub.x_offset;
+                for (uint32_t i = 0; i < sub.num_points; ++i) {
+                    x[i] = static_cast<double>(read_le<float>(raw + i * sizeof(float)));
+                }
+            } else {
+                std::copy(shared_x.begin(), shared_x.end(), x);
+            }
+            decode_y_values(layout, sub, map.data() + sub.y_offset, sub.num_points, out.y.data() + out.offsets[s]);
+        }
+    });
+    return out;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "alloc_tracking.h"
+
+/**
+ * All subfiles of an SPC file as flat ragged arrays (Arrow/Awkward list
+ * layout): subfile i occupies [offsets[i], offsets[i + 1]) of both x and y.
+ */
+struct RaggedSpectra {
+    size_t num_subfiles = 0;
+    tracked_vector<double> x;         ///< X values of every subfile, concatenated
+    tracked_vector<double> y;         ///< Y values of every subfile, concatenated
+    tracked_vector<int64_t> offsets;  ///< num_subfiles + 1 start offsets; offsets[0] == 0
+    tracked_vector<double> z;         ///< z_start of each subfile
+};
+
+/**
+ * Decode an SPC file into ragged arrays.
+ *
+ * The subheaders are read first, so the offsets are known and x and y are
+ * allocated once at their final size; the memory-mapped subfiles are then
+ * decoded in parallel straight into their slices. Intended for XYXY files,
+ * whose subfiles differ in length, but any file type is accepted.
+ *
+ * @param path SPC file
+ * @param num_threads Worker threads (0 = all cores)
+ * @return Concatenated x and y, offsets and z values
+ * @throws std::runtime_error if the file cannot be read or a subfile extends past its end
+ */
+RaggedSpectra read_spc_ragged(const std::string& path, size_t num_threads);
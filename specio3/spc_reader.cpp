@@ -1,5 +1,8 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "spc_reader.h"
+#include "mapped_file.h"
+#include "tracepoints.h"
 
 #include <fstream>
 #include <vector>
@@ -7,44 +10,26 @@
 #include <stdexcept>
 #include <cstring>
 #include <sstream>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace py = pybind11;
 
-static std::string human_offset(std::streamoff o) {
+std::string human_offset(std::streamoff o) {
     std::ostringstream ss;
     ss << o;
     return ss.str();
 }
 
-// Helpers for reading little-endian values (assuming host is little-endian; if not, you need byte-swapping)
-template <typename T>
-T read_le(const char* buffer) {
-    T v;
-    std::memcpy(&v, buffer, sizeof(T));
-    return v;
-}
-
-struct Subfile {
-    std::vector<double> x;
-    std::vector<double> y;
-    float z_start = 0;
-    float z_end = 0;
-};
-
-struct SPCFile {
-    bool is_multifile = false;
-    bool is_xy = false;
-    bool is_xyxy = false;
-    bool y_in_16bit = false;
-    uint32_t num_points = 0;
-    uint32_t num_subfiles = 0;
-    double first_x = 0;
-    double last_x = 0;
-    std::vector<Subfile> subfiles;
-    std::string log_text;
-};
-
-static double apply_y_scaling_uint32(uint32_t integer_y, int8_t exponent_byte, bool is_16bit) {
+double apply_y_scaling_uint32(uint32_t integer_y, int8_t exponent_byte, bool is_16bit) {
     // For SPC files, if exponent is -128, it indicates float data
     if (exponent_byte == -128) {
         // Reinterpret the integer as a float
@@ -61,7 +46,7 @@ static double apply_y_scaling_uint32(uint32_t integer_y, int8_t exponent_byte, b
     return static_cast<double>(signed_y) / divisor;
 }
 
-static double apply_y_scaling_uint16(uint16_t integer_y, int8_t exponent_byte) {
+double apply_y_scaling_uint16(uint16_t integer_y, int8_t exponent_byte) {
     // Convert unsigned to signed
     int16_t signed_y = static_cast<int16_t>(integer_y);
     
@@ -75,39 +60,27 @@ static double apply_y_scaling_uint16(uint16_t integer_y, int8_t exponent_byte) {
     return static_cast<double>(signed_y) / divisor;
 }
 
-// Special handling for old format (0x4D) Y-data with byte swapping
-static double apply_y_scaling_old_format(const char* y_bytes, int8_t exponent_byte) {
-    // For old format, swap 1st and 2nd byte, as well as 3rd and 4th byte
-    uint8_t b0 = static_cast<uint8_t>(y_bytes[0]);
-    uint8_t b1 = static_cast<uint8_t>(y_bytes[1]);
-    uint8_t b2 = static_cast<uint8_t>(y_bytes[2]);
-    uint8_t b3 = static_cast<uint8_t>(y_bytes[3]);
-    
-    // Reconstruct integer with byte swapping
-    uint32_t swapped_int = (b1 << 24) + (b0 << 16) + (b3 << 8) + b2;
-    
-    // Convert to signed
-    int32_t signed_y = static_cast<int32_t>(swapped_int);
-    
-    // Apply scaling: Y = integer / (2^(32-exponent))
-    double divisor = std::pow(2.0, 32 - static_cast<int>(exponent_byte));
-    return static_cast<double>(signed_y) / divisor;
-}
-
-SPCFile read_spc_impl(const std::string& filename) {
-    std::ifstream f(filename, std::ios::binary);
-    if (!f) {
-        throw std::runtime_error("Unable to open file: " + filename);
-    }
-
-    SPCFile out;
+// Raw 32-byte subheader as stored in multifile SPC files
+struct SubHeaderRaw {
+    uint8_t subfile_flags;       // 1 byte
+    int8_t subfile_exponent;     // 1 byte (signed; -128 == float Y)
+    uint16_t subfile_index;      // 2 bytes
+    float z_start;               // 4 bytes
+    float z_end;                 // 4 bytes
+    float noise;                // 4 bytes
+    uint32_t num_points_xyxy;    // 4 bytes
+    uint32_t num_coadded_scans;  // 4 bytes
+    float w_axis_value;          // 4 bytes
+    char reserved[4];            // 4 bytes
+};
+static_assert(sizeof(SubHeaderRaw) == 32, "SubheaderRaw must be 32 bytes");
 
-    // Get file size
-    f.seekg(0, std::ios::end);
-    std::streamsize file_size = f.tellg();
-    f.seekg(0, std::ios::beg);
+SPCLayout read_spc_layout(std::istream& f, uint64_t file_size) {
+    SPCLayout out;
+    out.file_size = file_size;
 
     // Read first 2 bytes to determine format
+    f.seekg(0, std::ios::beg);
     char format_bytes[2];
     f.read(format_bytes, 2);
     if (f.gcount() != 2) {
@@ -116,12 +89,12 @@ SPCFile read_spc_impl(const std::string& filename) {
     
     // Determine format and header size
     auto version_byte = static_cast<uint8_t>(format_bytes[1]);
-    bool is_old_format = (version_byte == 0x4D);
-    uint32_t header_size = is_old_format ? 256 : 512;
+    out.is_old_format = (version_byte == 0x4D);
+    uint32_t header_size = out.is_old_format ? 256 : 512;
     
     // Go back to beginning and read full header
     f.seekg(0, std::ios::beg);
-    std::vector<char> mainhdr_buf(header_size);
+    tracked_vector<char> mainhdr_buf(header_size);
     f.read(mainhdr_buf.data(), header_size);
     if (f.gcount() != static_cast<std::streamsize>(header_size)) {
         throw std::runtime_error("Failed to read full main header (expected " + std::to_string(header_size) + " bytes, got " + std::to_string(f.gcount()) + ")");
@@ -141,7 +114,7 @@ SPCFile read_spc_impl(const std::string& filename) {
     int8_t global_exponent_y = static_cast<int8_t>(mainhdr_buf[1]);
     
     // For old format, exponent is at offset 2-3 (16-bit)
-    if (is_old_format) {
+    if (out.is_old_format) {
         global_exponent_y = read_le<int16_t>(mainhdr_buf.data() + 2);
         // For old format: onpts at offset 4-7, ofirst at 8-11, olast at 12-15
         out.num_points = static_cast<uint32_t>(read_le<float>(mainhdr_buf.data() + 4));
@@ -151,7 +124,7 @@ SPCFile read_spc_impl(const std::string& filename) {
         global_exponent_y = static_cast<int8_t>(mainhdr_buf[1]);
         // For Y-only files, calculate number of points from file size
         if (!out.is_xy) {
-            std::streamsize data_size = file_size - header_size;
+            uint64_t data_size = file_size - header_size;
             if (out.y_in_16bit) {
                 out.num_points = static_cast<uint32_t>(data_size / 2);
             } else {
@@ -178,64 +151,38 @@ SPCFile read_spc_impl(const std::string& filename) {
     }
     
     // Bytes 244-247: Log block offset, little-endian 32-bit
-    auto log_block_offset = read_le<uint32_t>(mainhdr_buf.data() + 244);
+    out.log_block_offset = read_le<uint32_t>(mainhdr_buf.data() + 244);
 
-    // Shared X array (for XY / XYY) if applicable
-    std::vector<double> shared_x;
-    // Defensive: ensure out.num_points is initialized before use
-    // (It is set above from the file header, but some static analyzers may warn)
-    // If you want to silence such warnings, you can add an assert:
     if (out.is_xy && out.num_points == 0) {
         throw std::runtime_error("num_points is zero but expected >0 for XY-type file.");
     }
-    if (!out.is_xyxy) {
-        if (out.is_xy) {
-            // Shared X array of floats comes immediately after main header
-            shared_x.resize(out.num_points);
-            for (uint32_t i = 0; i < out.num_points; ++i) {
-                float xv;
-                f.read(reinterpret_cast<char*>(&xv), sizeof(float));
-                if (!f) {
-                    throw std::runtime_error("Failed reading shared X array at point " + std::to_string(i) +
-                                             ", file offset " + human_offset(f.tellg()));
-                }
-                shared_x[i] = static_cast<double>(xv);
-            }
-            if (!shared_x.empty()) {
-                out.first_x = shared_x.front();
-                out.last_x = shared_x.back();
-            }
-        }
+
+    // Shared X array of floats comes immediately after main header (XY / XYY)
+    uint64_t pos = header_size;
+    if (out.is_xy && !out.is_xyxy) {
+        out.shared_x_offset = pos;
+        pos += static_cast<uint64_t>(out.num_points) * sizeof(float);
     }
 
     // Read all subheaders (each is 32 bytes) - only for multifile
-    struct SubHeaderRaw {
-        uint8_t subfile_flags;       // 1 byte
-        int8_t subfile_exponent;     // 1 byte (signed; -128 == float Y)
-        uint16_t subfile_index;      // 2 bytes
-        float z_start;               // 4 bytes
-        float z_end;                 // 4 bytes
-        float noise;                // 4 bytes
-        uint32_t num_points_xyxy;    // 4 bytes
-        uint32_t num_coadded_scans;  // 4 bytes
-        float w_axis_value;          // 4 bytes
-        char reserved[4];            // 4 bytes
-    };
-    static_assert(sizeof(SubHeaderRaw) == 32, "SubheaderRaw must be 32 bytes");
-
-    std::vector<SubHeaderRaw> subhdrs;
+    tracked_vector<SubHeaderRaw> subhdrs;
     if (out.is_multifile) {
-        subhdrs.reserve(out.num_subfiles);
-        for (uint32_t i = 0; i < out.num_subfiles; ++i) {
-            SubHeaderRaw sh;
-            f.read(reinterpret_cast<char*>(&sh), sizeof(SubHeaderRaw));
-            if (!f) {
-                std::ostringstream err;
-                err << "Failed reading subheader " << i << " at offset " << human_offset(f.tellg());
-                throw std::runtime_error(err.str());
-            }
-            subhdrs.push_back(sh);
+        const uint64_t subhdr_bytes = static_cast<uint64_t>(out.num_subfiles) * sizeof(SubHeaderRaw);
+        if (pos + subhdr_bytes > file_size) {
+            std::ostringstream err;
+            err << "Failed reading " << out.num_subfiles << " subheaders at offset " << pos
+                << ": file is only " << file_size << " bytes";
+            throw std::runtime_error(err.str());
+        }
+        subhdrs.resize(out.num_subfiles);
+        f.seekg(static_cast<std::streamoff>(pos), std::ios::beg);
+        f.read(reinterpret_cast<char*>(subhdrs.data()), static_cast<std::streamsize>(subhdr_bytes));
+        if (!f) {
+            std::ostringstream err;
+            err << "Failed reading subheaders at offset " << pos;
+            throw std::runtime_error(err.str());
         }
+        pos += subhdr_bytes;
     } else {
         // For single file, create a dummy subheader
         SubHeaderRaw sh = {};
@@ -247,43 +194,448 @@ SPCFile read_spc_impl(const std::string& filename) {
     // Determine if global Y is float
     bool global_float_y = (global_exponent_y == static_cast<int8_t>(-128));
 
-    // Prepare subfiles container
     out.subfiles.resize(out.num_subfiles);
     for (uint32_t si = 0; si < out.num_subfiles; ++si) {
         const SubHeaderRaw& sh = subhdrs[si];
-        Subfile& s = out.subfiles[si];
+        SubfileLayout& s = out.subfiles[si];
         s.z_start = sh.z_start;
         s.z_end = sh.z_end;
 
         bool subfile_float_y = (sh.subfile_exponent == static_cast<int8_t>(-128));
-        int8_t exponent_to_use = subfile_float_y ? 0 : sh.subfile_exponent;
-        bool use_float_y = subfile_float_y || global_float_y;
-
-        uint32_t this_num_points = out.num_points;
-        if (out.is_xyxy) {
-            this_num_points = sh.num_points_xyxy;
-        }
+        s.exponent = subfile_float_y ? 0 : sh.subfile_exponent;
+        s.float_y = subfile_float_y || global_float_y;
+        s.num_points = out.is_xyxy ? sh.num_points_xyxy : out.num_points;
 
-        if (this_num_points == 0) {
+        if (s.num_points == 0) {
             std::ostringstream err;
             err << "Subfile " << si << " has zero points (this_num_points==0)";
             throw std::runtime_error(err.str());
         }
 
+        // X axis per subfile (XYXY), then Y values
+        if (out.is_xyxy) {
+            s.x_offset = pos;
+            pos += static_cast<uint64_t>(s.num_points) * sizeof(float);
+        }
+        s.y_offset = pos;
+        pos += static_cast<uint64_t>(s.num_points) * out.y_value_size(s);
+    }
+
+    return out;
+}
+
+void decode_y_values(const SPCLayout& layout, const SubfileLayout& sub, const char* raw, size_t count, double* out) {
+    if (sub.float_y) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<double>(read_le<float>(raw + 4 * i));
+        }
+        return;
+    }
+    if (layout.y_in_16bit) {
+        // Y = integer / (2^(16-exponent)); multiplying by the exact reciprocal power of two is identical
+        const double scale = 1.0 / std::pow(2.0, 16 - static_cast<int>(sub.exponent));
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<double>(read_le<int16_t>(raw + 2 * i)) * scale;
+        }
+        return;
+    }
+    // Y = integer / (2^(32-exponent))
+    const double scale = 1.0 / std::pow(2.0, 32 - static_cast<int>(sub.exponent));
+    if (layout.is_old_format) {
+        // Old format swaps the 16-bit halves of each 32-bit value
+        for (size_t i = 0; i < count; ++i) {
+            const auto* b = reinterpret_cast<const uint8_t*>(raw + 4 * i);
+            uint32_t swapped_int = (static_cast<uint32_t>(b[1]) << 24) | (static_cast<uint32_t>(b[0]) << 16) |
+                                   (static_cast<uint32_t>(b[3]) << 8) | static_cast<uint32_t>(b[2]);
+            out[i] = static_cast<double>(static_cast<int32_t>(swapped_int)) * scale;
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<double>(read_le<int32_t>(raw + 4 * i)) * scale;
+    }
+}
+
+void SubfileQuality::merge(const SubfileQuality& other) {
+    nan_count += other.nan_count;
+    inf_count += other.inf_count;
+    negative_count += other.negative_count;
+    saturated_count += other.saturated_count;
+    y_min = std::min(y_min, other.y_min);
+    y_max = std::max(y_max, other.y_max);
+}
+
+namespace {
+
+// Loaders of one raw integer Y code per encoding, shared by the checked decode and the saturation rescan.
+struct Int16Code {
+    using Code = int16_t;
+    static Code load(const char* raw, size_t i) { return read_le<int16_t>(raw + 2 * i); }
+};
+struct Int32Code {
+    using Code = int32_t;
+    static Code load(const char* raw, size_t i) { return read_le<int32_t>(raw + 4 * i); }
+};
+struct SwappedInt32Code {
+    using Code = int32_t;
+    static Code load(const char* raw, size_t i) {
+        const auto* b = reinterpret_cast<const uint8_t*>(raw + 4 * i);
+        return static_cast<int32_t>((static_cast<uint32_t>(b[1]) << 24) | (static_cast<uint32_t>(b[0]) << 16) |
+                                    (static_cast<uint32_t>(b[3]) << 8) | static_cast<uint32_t>(b[2]));
+    }
+};
+
+// The checks run on the raw codes rather than the doubles: integer compares
+// and min/max reductions vectorize (SSE2 and up) without -ffast-math, while
+// NaN-aware double reductions do not. The loop bodies are kept branch-free
+// for the same reason.
+
+// Integer codes are always finite, and with scale > 0 the order of the codes
+// is the order of the values.
+template <typename Loader>
+void decode_checked_integer(const char* raw, size_t count, double scale, double* out, SubfileQuality& q) {
+    using Code = typename Loader::Code;
+    constexpr Code kSaturated = std::numeric_limits<Code>::max();
+    uint32_t negative_count = 0;
+    uint32_t saturated_count = 0;
+    Code lo = std::numeric_limits<Code>::max();
+    Code hi = std::numeric_limits<Code>::min();
+    for (size_t i = 0; i < count; ++i) {
+        const Code code = Loader::load(raw, i);
+        out[i] = static_cast<double>(code) * scale;
+        negative_count += code < 0 ? 1 : 0;
+        saturated_count += code == kSaturated ? 1 : 0;
+        lo = code < lo ? code : lo;
+        hi = code > hi ? code : hi;
+    }
+    q.negative_count += negative_count;
+    q.saturated_count += saturated_count;
+    if (count > 0) {
+        q.y_min = std::min(q.y_min, static_cast<double>(lo) * scale);
+        q.y_max = std::max(q.y_max, static_cast<double>(hi) * scale);
+    }
+}
+
+// IEEE floats are checked on their bit patterns. key maps the bits to an
+// int32 with the same order as the float values, so min/max are integer
+// reductions; non-finite values are replaced by a neutral key.
+void decode_checked_float(const char* raw, size_t count, double* out, SubfileQuality& q) {
+    constexpr int32_t kInfBits = 0x7f800000;
+    constexpr int32_t kNegativeInfBits = -0x800000;  // 0xff800000; negative floats are [INT32_MIN, this]
+    constexpr int32_t kMin = std::numeric_limits<int32_t>::min();
+    constexpr int32_t kMax = std::numeric_limits<int32_t>::max();
+    uint32_t nan_count = 0;
+    uint32_t inf_count = 0;
+    uint32_t sign_count = 0;           // negative values, -Inf and -0
+    uint32_t negative_zero_count = 0;  // -0
+    int32_t lo = kMax;
+    int32_t hi = kMin;
+    for (size_t i = 0; i < count; ++i) {
+        const auto bits = read_le<int32_t>(raw + 4 * i);
+        out[i] = static_cast<double>(read_le<float>(raw + 4 * i));
+        const int32_t magnitude = bits & kMax;
+        nan_count += magnitude > kInfBits ? 1 : 0;
+        inf_count += magnitude == kInfBits ? 1 : 0;
+        sign_count += bits <= kNegativeInfBits ? 1 : 0;
+        negative_zero_count += bits == kMin ? 1 : 0;
+        const int32_t key = bits ^ ((bits >> 31) & kMax);
+        const int32_t finite = (magnitude - kInfBits) >> 31;  // all ones for finite values
+        const int32_t lo_key = (key & finite) | (kMax & ~finite);
+        const int32_t hi_key = (key & finite) | (kMin & ~finite);
+        lo = lo_key < lo ? lo_key : lo;
+        hi = hi_key > hi ? hi_key : hi;
+    }
+    q.nan_count += nan_count;
+    q.inf_count += inf_count;
+    q.negative_count += sign_count - negative_zero_count;
+    if (lo != kMax) {  // at least one finite value
+        auto key_to_double = [](int32_t key) {
+            const int32_t value_bits = key ^ ((key >> 31) & kMax);
+            float value;
+            std::memcpy(&value, &value_bits, sizeof(value));
+            return static_cast<double>(value);
+        };
+        q.y_min = std::min(q.y_min, key_to_double(lo));
+        q.y_max = std::max(q.y_max, key_to_double(hi));
+    }
+}
+
+template <typename Loader>
+uint32_t longest_saturated_run(const char* raw, size_t count) {
+    constexpr auto kSaturated = std::numeric_limits<typename Loader::Code>::max();
+    uint32_t longest = 0;
+    uint32_t run = 0;
+    for (size_t i = 0; i < count; ++i) {
+        run = Loader::load(raw, i) == kSaturated ? run + 1 : 0;
+        longest = std::max(longest, run);
+    }
+    return longest;
+}
+
+}  // namespace
+
+void decode_y_values_checked(const SPCLayout& layout, const SubfileLayout& sub, const char* raw, size_t count,
+                             double* out, SubfileQuality& quality) {
+    if (sub.float_y) {
+        decode_checked_float(raw, count, out, quality);
+    } else if (layout.y_in_16bit) {
+        const double scale = 1.0 / std::pow(2.0, 16 - static_cast<int>(sub.exponent));
+        decode_checked_integer<Int16Code>(raw, count, scale, out, quality);
+    } else {
+        const double scale = 1.0 / std::pow(2.0, 32 - static_cast<int>(sub.exponent));
+        if (layout.is_old_format) {
+            decode_checked_integer<SwappedInt32Code>(raw, count, scale, out, quality);
+        } else {
+            decode_checked_integer<Int32Code>(raw, count, scale, out, quality);
+        }
+    }
+}
+
+void finish_quality_check(const SPCLayout& layout, const SubfileLayout& sub, const char* raw,
+                          SubfileQuality& quality) {
+    if (quality.saturated_count > 0) {
+        if (layout.y_in_16bit) {
+            quality.saturated_run = longest_saturated_run<Int16Code>(raw, sub.num_points);
+        } else if (layout.is_old_format) {
+            quality.saturated_run = longest_saturated_run<SwappedInt32Code>(raw, sub.num_points);
+        } else {
+            quality.saturated_run = longest_saturated_run<Int32Code>(raw, sub.num_points);
+        }
+    }
+    const uint32_t finite_count = sub.num_points - quality.nan_count - quality.inf_count;
+    quality.flags = 0;
+    if (quality.nan_count + quality.inf_count > 0) {
+        quality.flags |= kQualityNonFinite;
+    }
+    if (quality.saturated_count > 0) {
+        quality.flags |= kQualitySaturated;
+    }
+    if (finite_count > 1 && quality.y_min == quality.y_max) {
+        quality.flags |= kQualityFlat;
+    }
+    if (quality.negative_count > 0) {
+        quality.flags |= kQualityNegative;
+    }
+}
+
+// Read count little-endian floats starting at offset into doubles.
+static void read_x_floats(std::istream& f, uint64_t offset, uint32_t count, double* out, const char* what) {
+    tracked_vector<float> buf(count);
+    f.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    f.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(count * sizeof(float)));
+    if (!f) {
+        std::ostringstream err;
+        err << "Failed reading " << what << " (" << count << " points at offset " << offset << ")";
+        throw std::runtime_error(err.str());
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i] = static_cast<double>(buf[i]);
+    }
+}
+
+SPCLayout read_spc_layout(const std::string& filename) {
+    std::ifstream f(filename, std::ios::binary);
+    if (!f) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+    SPECIO3_PROBE1(file_open, filename.c_str());
+    f.seekg(0, std::ios::end);
+    auto file_size = static_cast<uint64_t>(f.tellg());
+    SPCLayout layout = read_spc_layout(f, file_size);
+    SPECIO3_PROBE4(header_parsed, filename.c_str(), layout.num_subfiles, layout.num_points, layout.file_size);
+    return layout;
+}
+
+void read_subfile_x(std::istream& f, const SPCLayout& layout, const SubfileLayout& sub, double* out) {
+    if (layout.is_xyxy) {
+        read_x_floats(f, sub.x_offset, sub.num_points, out, "subfile X data");
+    } else if (layout.is_xy) {
+        read_x_floats(f, layout.shared_x_offset, layout.num_points, out, "shared X array");
+    } else {
+        for (uint32_t i = 0; i < layout.num_points; ++i) {
+            out[i] = layout.generated_x(i);
+        }
+    }
+}
+
+void read_subfile_y(std::istream& f, const SPCLayout& layout, const SubfileLayout& sub, size_t first,
+                    size_t count, tracked_vector<char>& scratch, double* out) {
+    const size_t value_size = layout.y_value_size(sub);
+    const uint64_t offset = sub.y_offset + first * value_size;
+    scratch.resize(count * value_size);
+    f.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    f.read(scratch.data(), static_cast<std::streamsize>(scratch.size()));
+    if (!f) {
+        std::ostringstream err;
+        err << "Failed reading " << count << " Y values at offset " << offset;
+        throw std::runtime_error(err.str());
+    }
+    decode_y_values(layout, sub, scratch.data(), count, out);
+}
+
+static std::string read_spc_log_text(std::istream& f, uint32_t log_block_offset) {
+    std::string log_text;
+    if (log_block_offset == 0) {
+        return log_text;
+    }
+    f.clear();
+    f.seekg(static_cast<std::streamoff>(log_block_offset), std::ios::beg);
+    if (!f) {
+        throw std::runtime_error("Failed to seek to log block offset: " + std::to_string(log_block_offset));
+    }
+
+    // Minimal log header reading (assuming fixed layout)
+    struct LogHeaderRaw {
+        uint32_t log_block_size;
+        uint32_t memory_block_size;
+        uint32_t offset_to_text;
+        uint32_t binary_log_size;
+        uint32_t disk_area_size;
+        char reserved[44];
+    };
+    static_assert(sizeof(LogHeaderRaw) == 64, "Unexpected log header size");
+    LogHeaderRaw loghdr;
+    f.read(reinterpret_cast<char*>(&loghdr), sizeof(LogHeaderRaw));
+    if (!f) {
+        throw std::runtime_error("Failed reading log header at offset " + human_offset(f.tellg()));
+    }
+
+    uint32_t text_offset_within_log = loghdr.offset_to_text;
+    if (text_offset_within_log != 0 && loghdr.log_block_size > text_offset_within_log) {
+        uint32_t ascii_log_size = loghdr.log_block_size - text_offset_within_log;
+        f.seekg(static_cast<std::streamoff>(log_block_offset + text_offset_within_log), std::ios::beg);
+        tracked_vector<char> logtext_buf(ascii_log_size);
+        f.read(logtext_buf.data(), ascii_log_size);
+        size_t actually_read = f.gcount();
+        if (actually_read > 0) {
+            log_text.assign(logtext_buf.data(), actually_read);
+        }
+    }
+    return log_text;
+}
+
+/**
+ * Read a whole file into buf if it is at most kSlurpThreshold bytes.
+ * Costs one open, fstat and (normally) one read.
+ *
+ * @return false if the file is larger, leaving buf unchanged
+ * @throws std::runtime_error if the file cannot be opened or read
+ */
+static bool slurp_small_file(const std::string& filename, std::vector<char>& buf) {
+#ifdef _WIN32
+    std::ifstream f(filename, std::ios::binary | std::ios::ate);
+    if (!f) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+    const auto size = static_cast<uint64_t>(f.tellg());
+    if (size > kSlurpThreshold) {
+        return false;
+    }
+    buf.resize(static_cast<size_t>(size));
+    f.seekg(0, std::ios::beg);
+    if (!f.read(buf.data(), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Unable to read file: " + filename);
+    }
+    return true;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) > kSlurpThreshold) {
+        ::close(fd);
+        return false;
+    }
+    buf.resize(static_cast<size_t>(st.st_size));
+    size_t done = 0;
+    while (done < buf.size()) {
+        ssize_t n = ::read(fd, buf.data() + done, buf.size() - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ::close(fd);
+            throw std::runtime_error("Unable to read file: " + filename);
+        }
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    return true;
+#endif
+}
+
+SPCFile read_spc_impl(const std::string& filename, bool check_quality) {
+    // Reused across calls so batch reads of small files do not allocate per file;
+    // bounded by kSlurpThreshold and not attributed to any read's allocation stats.
+    thread_local std::vector<char> file_buffer;
+    if (slurp_small_file(filename, file_buffer)) {
+        SPECIO3_PROBE1(file_open, filename.c_str());
+        return read_spc_memory(file_buffer.data(), file_buffer.size(), filename, check_quality);
+    }
+
+    std::ifstream f(filename, std::ios::binary);
+    if (!f) {
+        throw std::runtime_error("Unable to open file: " + filename);
+    }
+
+    SPECIO3_PROBE1(file_open, filename.c_str());
+
+    // Get file size
+    f.seekg(0, std::ios::end);
+    std::streamsize file_size = f.tellg();
+
+    return read_spc_stream(f, static_cast<uint64_t>(file_size), filename, check_quality);
+}
+
+/**
+ * Parse a complete SPC file from f. If data is not null it must hold the
+ * same file_size bytes as f; Y values are then decoded from it directly
+ * instead of being read through the stream into a scratch buffer.
+ */
+static SPCFile parse_spc(std::istream& f, uint64_t file_size, const char* data, const std::string& name,
+                         bool check_quality) {
+    SPCLayout layout = read_spc_layout(f, file_size);
+    SPECIO3_PROBE4(header_parsed, name.c_str(), layout.num_subfiles, layout.num_points, layout.file_size);
+
+    SPCFile out;
+    out.is_multifile = layout.is_multifile;
+    out.is_xy = layout.is_xy;
+    out.is_xyxy = layout.is_xyxy;
+    out.y_in_16bit = layout.y_in_16bit;
+    out.num_points = layout.num_points;
+    out.num_subfiles = layout.num_subfiles;
+    out.first_x = layout.first_x;
+    out.last_x = layout.last_x;
+
+    // Shared X array (for XY / XYY) if applicable
+    tracked_vector<double> shared_x;
+    if (out.is_xy && !out.is_xyxy) {
+        shared_x.resize(out.num_points);
+        read_x_floats(f, layout.shared_x_offset, out.num_points, shared_x.data(), "shared X array");
+        if (!shared_x.empty()) {
+            out.first_x = shared_x.front();
+            out.last_x = shared_x.back();
+        }
+    }
+
+    // Each subfile's Y block is read with a single call and converted in memory
+    tracked_vector<char> raw;
+    out.subfiles.resize(out.num_subfiles);
+    if (check_quality) {
+        out.quality.resize(out.num_subfiles);
+    }
+    for (uint32_t si = 0; si < out.num_subfiles; ++si) {
+        const SubfileLayout& sl = layout.subfiles[si];
+        Subfile& s = out.subfiles[si];
+        s.z_start = sl.z_start;
+        s.z_end = sl.z_end;
+
         // X axis per subfile
         if (out.is_xyxy) {
-            s.x.resize(this_num_points);
-            for (uint32_t i = 0; i < this_num_points; ++i) {
-                float xv;
-                f.read(reinterpret_cast<char*>(&xv), sizeof(float));
-                if (!f) {
-                    std::ostringstream err;
-                    err << "Failed reading XYXY subfile X data for subfile " << si << " at point " << i
-                        << " offset " << human_offset(f.tellg());
-                    throw std::runtime_error(err.str());
-                }
-                s.x[i] = static_cast<double>(xv);
-            }
+            s.x.resize(sl.num_points);
+            std::string what = "XYXY subfile X data for subfile " + std::to_string(si);
+            read_x_floats(f, sl.x_offset, sl.num_points, s.x.data(), what.c_str());
         } else if (out.is_xy) {
             s.x = shared_x;
         } else {
@@ -300,104 +652,50 @@ SPCFile read_spc_impl(const std::string& filename) {
         }
 
         // Y values
-        s.y.resize(this_num_points);
-        if (use_float_y) {
-            for (uint32_t i = 0; i < this_num_points; ++i) {
-                float yv;
-                f.read(reinterpret_cast<char*>(&yv), sizeof(float));
-                if (!f) {
-                    std::ostringstream err;
-                    err << "Failed reading float Y values for subfile " << si << " at point " << i
-                        << " offset " << human_offset(f.tellg());
-                    throw std::runtime_error(err.str());
-                }
-                s.y[i] = static_cast<double>(yv);
-            }
+        const size_t y_bytes = static_cast<size_t>(sl.num_points) * layout.y_value_size(sl);
+        const char* y_raw = nullptr;
+        if (data != nullptr && sl.y_offset + y_bytes <= file_size) {
+            y_raw = data + sl.y_offset;
         } else {
-            if (out.y_in_16bit) {
-                for (uint32_t i = 0; i < this_num_points; ++i) {
-                    uint16_t iv;
-                    f.read(reinterpret_cast<char*>(&iv), sizeof(uint16_t));
-                    if (!f) {
-                        std::ostringstream err;
-                        err << "Failed reading 16-bit integer Y for subfile " << si << " at point " << i
-                            << " offset " << human_offset(f.tellg());
-                        throw std::runtime_error(err.str());
-                    }
-                    s.y[i] = apply_y_scaling_uint16(iv, exponent_to_use);
-                }
-            } else {
-                // 32-bit integer Y data
-                if (is_old_format) {
-                    // Old format requires special byte swapping
-                    for (uint32_t i = 0; i < this_num_points; ++i) {
-                        char y_bytes[4];
-                        f.read(y_bytes, 4);
-                        if (!f) {
-                            std::ostringstream err;
-                            err << "Failed reading 32-bit integer Y for subfile " << si << " at point " << i
-                                << " offset " << human_offset(f.tellg());
-                            throw std::runtime_error(err.str());
-                        }
-                        s.y[i] = apply_y_scaling_old_format(y_bytes, exponent_to_use);
-                    }
-                } else {
-                    // New format - standard reading
-                    for (uint32_t i = 0; i < this_num_points; ++i) {
-                        uint32_t iv;
-                        f.read(reinterpret_cast<char*>(&iv), sizeof(uint32_t));
-                        if (!f) {
-                            std::ostringstream err;
-                            err << "Failed reading 32-bit integer Y for subfile " << si << " at point " << i
-                                << " offset " << human_offset(f.tellg());
-                            throw std::runtime_error(err.str());
-                        }
-                        s.y[i] = apply_y_scaling_uint32(iv, exponent_to_use, false);
-                    }
-                }
+            raw.resize(y_bytes);
+            f.seekg(static_cast<std::streamoff>(sl.y_offset), std::ios::beg);
+            f.read(raw.data(), static_cast<std::streamsize>(y_bytes));
+            if (!f) {
+                std::ostringstream err;
+                err << "Failed reading Y values for subfile " << si << " (" << sl.num_points
+                    << " points at offset " << sl.y_offset << ")";
+                throw std::runtime_error(err.str());
             }
+            y_raw = raw.data();
         }
+        s.y.resize(sl.num_points);
+        if (check_quality) {
+            decode_y_values_checked(layout, sl, y_raw, sl.num_points, s.y.data(), out.quality[si]);
+            finish_quality_check(layout, sl, y_raw, out.quality[si]);
+        } else {
+            decode_y_values(layout, sl, y_raw, sl.num_points, s.y.data());
+        }
+        SPECIO3_PROBE3(subfile_decoded, si, sl.num_points, static_cast<uint64_t>(y_bytes));
     }
 
     // Read log text if present
-    if (log_block_offset != 0) {
-        f.seekg(static_cast<std::streamoff>(log_block_offset), std::ios::beg);
-        if (!f) {
-            throw std::runtime_error("Failed to seek to log block offset: " + std::to_string(log_block_offset));
-        }
-
-        // Minimal log header reading (assuming fixed layout)
-        struct LogHeaderRaw {
-            uint32_t log_block_size;
-            uint32_t memory_block_size;
-            uint32_t offset_to_text;
-            uint32_t binary_log_size;
-            uint32_t disk_area_size;
-            char reserved[44];
-        };
-        static_assert(sizeof(LogHeaderRaw) == 64, "Unexpected log header size");
-        LogHeaderRaw loghdr;
-        f.read(reinterpret_cast<char*>(&loghdr), sizeof(LogHeaderRaw));
-        if (!f) {
-            throw std::runtime_error("Failed reading log header at offset " + human_offset(f.tellg()));
-        }
-
-        uint32_t text_offset_within_log = loghdr.offset_to_text;
-        if (text_offset_within_log != 0 && loghdr.log_block_size > text_offset_within_log) {
-            uint32_t ascii_log_size = loghdr.log_block_size - text_offset_within_log;
-            f.seekg(static_cast<std::streamoff>(log_block_offset + text_offset_within_log), std::ios::beg);
-            std::vector<char> logtext_buf(ascii_log_size);
-            f.read(logtext_buf.data(), ascii_log_size);
-            size_t actually_read = f.gcount();
-            if (actually_read > 0) {
-                out.log_text.assign(logtext_buf.data(), actually_read);
-            }
-        }
+    out.log_text = read_spc_log_text(f, layout.log_block_offset);
+    if (layout.log_block_offset != 0) {
+        SPECIO3_PROBE1(log_parsed, static_cast<uint64_t>(out.log_text.size()));
     }
 
     return out;
 }
 
+SPCFile read_spc_stream(std::istream& f, uint64_t file_size, const std::string& name, bool check_quality) {
+    return parse_spc(f, file_size, nullptr, name, check_quality);
+}
+
+SPCFile read_spc_memory(const char* data, size_t size, const std::string& name, bool check_quality) {
+    MemoryInputStream f(data, size);
+    return parse_spc(f, size, data, name, check_quality);
+}
+
 py::dict to_pydict(const SPCFile& spc) {
     py::dict d;
     d["is_multifile"] = spc.is_multifile;
@@ -420,5 +718,6 @@ py::dict to_pydict(const SPCFile& spc) {
         subs.append(sd);
     }
     d["subfiles"] = subs;
+    SPECIO3_PROBE1(to_python_done, spc.num_subfiles);
     return d;
 }
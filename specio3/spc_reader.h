@@ -1,10 +1,16 @@
 #pragma once
 
 #include <pybind11/pybind11.h>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
 #include <vector>
 #include <string>
 #include <fstream>
 
+#include "alloc_tracking.h"
+
 namespace py = pybind11;
 
 // Forward declarations
@@ -28,19 +34,50 @@ std::string human_offset(std::streamoff o);
  * @return The value read from buffer in host byte order
  */
 template <typename T>
-T read_le(const char* buffer);
+T read_le(const char* buffer) {
+    T v;
+    std::memcpy(&v, buffer, sizeof(T));
+    return v;
+}
 
 /**
  * Structure representing a single spectrum subfile.
  * Contains X and Y data vectors along with Z-axis metadata.
  */
 struct Subfile {
-    std::vector<double> x;      ///< X-axis values (wavelength, frequency, etc.)
-    std::vector<double> y;      ///< Y-axis values (intensity, absorbance, etc.)
+    tracked_vector<double> x;   ///< X-axis values (wavelength, frequency, etc.)
+    tracked_vector<double> y;   ///< Y-axis values (intensity, absorbance, etc.)
     float z_start = 0;          ///< Starting Z-axis value for this subfile
     float z_end = 0;            ///< Ending Z-axis value for this subfile
 };
 
+/// Bits of SubfileQuality::flags.
+enum QualityFlag : uint32_t {
+    kQualityNonFinite = 1u << 0,  ///< At least one NaN or infinite value
+    kQualitySaturated = 1u << 1,  ///< At least one value at the largest integer code (detector saturation)
+    kQualityFlat = 1u << 2,       ///< All finite values are equal
+    kQualityNegative = 1u << 3,   ///< At least one negative value
+};
+
+/**
+ * Data-quality counters of one subfile, gathered while its Y values are
+ * decoded (see decode_y_values_checked()). Exposed to NumPy as a structured
+ * dtype, so its field names are part of the Python API.
+ */
+struct SubfileQuality {
+    uint32_t flags = 0;            ///< QualityFlag bits, set by finish_quality_check()
+    uint32_t nan_count = 0;        ///< NaN values
+    uint32_t inf_count = 0;        ///< Infinite values
+    uint32_t negative_count = 0;   ///< Values below zero
+    uint32_t saturated_count = 0;  ///< Integer values at the largest code of their width
+    uint32_t saturated_run = 0;    ///< Longest run of consecutive saturated values
+    double y_min = std::numeric_limits<double>::infinity();   ///< Smallest finite value
+    double y_max = -std::numeric_limits<double>::infinity();  ///< Largest finite value
+
+    /// Add the counters of another run of values of the same subfile.
+    void merge(const SubfileQuality& other);
+};
+
 /**
  * Structure representing a complete SPC file with all metadata and spectral data.
  * Supports various SPC format variants including single/multi-file and different data types.
@@ -61,8 +98,152 @@ struct SPCFile {
     // Spectral data and log information
     std::vector<Subfile> subfiles;  ///< Vector of all spectra in the file
     std::string log_text;           ///< Optional log text from the file
+    tracked_vector<SubfileQuality> quality;  ///< Per-subfile checks (empty unless requested)
 };
 
+/**
+ * Location and encoding of one subfile's data within an SPC file.
+ * Produced by read_spc_layout() without touching the spectral data itself.
+ */
+struct SubfileLayout {
+    uint64_t x_offset = 0;      ///< File offset of this subfile's X floats (XYXY only)
+    uint64_t y_offset = 0;      ///< File offset of the first Y value
+    uint32_t num_points = 0;    ///< Number of points in this subfile
+    int8_t exponent = 0;        ///< Y exponent for integer data
+    bool float_y = false;       ///< True if Y values are stored as IEEE floats
+    float z_start = 0;          ///< Starting Z-axis value for this subfile
+    float z_end = 0;            ///< Ending Z-axis value for this subfile
+};
+
+/**
+ * Parsed main header plus the position of every subfile's data.
+ * Lets callers read or skip individual subfiles (or parts of them)
+ * without decoding the whole file.
+ */
+struct SPCLayout {
+    // File format flags (same meaning as in SPCFile)
+    bool is_multifile = false;
+    bool is_xy = false;
+    bool is_xyxy = false;
+    bool y_in_16bit = false;
+    bool is_old_format = false;  ///< True for the pre-1996 0x4D format (word-swapped Y)
+
+    uint32_t num_points = 0;        ///< Points per subfile (if not XYXY)
+    uint32_t num_subfiles = 0;      ///< Number of subfiles
+    double first_x = 0;             ///< First X value from the header
+    double last_x = 0;              ///< Last X value from the header
+    uint64_t file_size = 0;         ///< Total file size in bytes
+    uint64_t shared_x_offset = 0;   ///< File offset of the shared X floats (XY, non-XYXY)
+    uint32_t log_block_offset = 0;  ///< File offset of the log block (0 = none)
+
+    tracked_vector<SubfileLayout> subfiles;  ///< One entry per subfile, in file order
+
+    /// Bytes per stored Y value of a subfile (2 or 4).
+    uint32_t y_value_size(const SubfileLayout& sub) const {
+        return (!sub.float_y && y_in_16bit) ? 2 : 4;
+    }
+
+    /// X value of point i in a Y-only file (evenly spaced from first_x to last_x).
+    double generated_x(uint32_t i) const {
+        if (num_points <= 1) {
+            return first_x;
+        }
+        double step = (last_x - first_x) / static_cast<double>(num_points - 1);
+        return first_x + step * i;
+    }
+};
+
+/**
+ * Parse the main header and subheaders of an SPC file and locate every
+ * subfile's data. Reads only the header region; spectral data is skipped.
+ * Offsets follow the same file walk as read_spc_impl(), so data read at
+ * these offsets is exactly what read_spc_impl() decodes.
+ *
+ * @param f Binary stream positioned anywhere; it is repositioned as needed
+ * @param file_size Total size of the file in bytes
+ * @return The file layout
+ * @throws std::runtime_error if the header is truncated or inconsistent
+ */
+SPCLayout read_spc_layout(std::istream& f, uint64_t file_size);
+
+/**
+ * Open an SPC file and parse its layout.
+ *
+ * @param filename Path to the SPC file
+ * @return The file layout
+ * @throws std::runtime_error if the file cannot be opened or its header is invalid
+ */
+SPCLayout read_spc_layout(const std::string& filename);
+
+/**
+ * Read the X values of one subfile: stored per subfile (XYXY), shared (XY)
+ * or generated from first_x/last_x (Y-only).
+ *
+ * @param f Binary stream of the file the layout was read from
+ * @param layout File layout
+ * @param sub Subfile to read
+ * @param out Output buffer of sub.num_points doubles
+ * @throws std::runtime_error if the stream ends early
+ */
+void read_subfile_x(std::istream& f, const SPCLayout& layout, const SubfileLayout& sub, double* out);
+
+/**
+ * Read and decode Y values [first, first + count) of one subfile with a
+ * single read. Only the requested bytes are touched.
+ *
+ * @param f Binary stream of the file the layout was read from
+ * @param layout File layout
+ * @param sub Subfile to read
+ * @param first Index of the first point
+ * @param count Number of points (first + count <= sub.num_points)
+ * @param scratch Reusable buffer for the raw bytes
+ * @param out Output buffer of count doubles
+ * @throws std::runtime_error if the stream ends early
+ */
+void read_subfile_y(std::istream& f, const SPCLayout& layout, const SubfileLayout& sub, size_t first,
+                    size_t count, tracked_vector<char>& scratch, double* out);
+
+/**
+ * Convert a run of raw Y values of one subfile to scaled doubles.
+ * Handles float, 16-bit and 32-bit integer encodings and the word-swapped
+ * old format, producing the same values as read_spc_impl().
+ *
+ * @param layout File layout
+ * @param sub Subfile the values belong to
+ * @param raw Raw bytes, count * layout.y_value_size(sub) long
+ * @param count Number of values to convert
+ * @param out Output buffer of count doubles
+ */
+void decode_y_values(const SPCLayout& layout, const SubfileLayout& sub, const char* raw, size_t count, double* out);
+
+/**
+ * decode_y_values() fused with the data-quality checks: the values are
+ * checked for NaN/Inf, negatives and saturated integer codes in the same
+ * pass that converts them. Counters are added to quality, so a subfile may
+ * be decoded in several runs; call finish_quality_check() once afterwards.
+ *
+ * @param layout File layout
+ * @param sub Subfile the values belong to
+ * @param raw Raw bytes, count * layout.y_value_size(sub) long
+ * @param count Number of values to convert
+ * @param out Output buffer of count doubles
+ * @param quality Counters to add to
+ */
+void decode_y_values_checked(const SPCLayout& layout, const SubfileLayout& sub, const char* raw, size_t count,
+                             double* out, SubfileQuality& quality);
+
+/**
+ * Complete the counters of a fully decoded subfile: measure the longest run
+ * of saturated values (only rescanning raw if any were seen) and set flags.
+ *
+ * @param layout File layout
+ * @param sub Subfile the counters belong to
+ * @param raw All of the subfile's raw Y bytes
+ * @param quality Counters accumulated by decode_y_values_checked()
+ */
+void finish_quality_check(const SPCLayout& layout, const SubfileLayout& sub, const char* raw,
+                          SubfileQuality& quality);
+
 /**
  * Apply Y-axis scaling for 32-bit integer values according to SPC specification.
  * Uses the exponent byte to scale raw integer values to floating point.
@@ -88,13 +269,46 @@ double apply_y_scaling_uint16(uint16_t integer_y, int8_t exponent_byte);
  * Read and parse a complete SPC file into memory.
  * Handles all SPC format variants including single/multi-file, Y-only/XY/XYXY formats,
  * and different data precision levels (16-bit/32-bit integers, floats).
+ * Files up to kSlurpThreshold bytes are read with a single read() into a
+ * reusable per-thread buffer and parsed from memory; larger files are streamed.
  *
  * @param filename Path to the SPC file to read
+ * @param check_quality Also fill SPCFile::quality, in the decoding pass
  * @return SPCFile structure containing all parsed data and metadata
  * @throws std::runtime_error if file cannot be opened, read, or contains invalid data
  * @throws std::runtime_error if file format is unsupported or corrupted
  */
-SPCFile read_spc_impl(const std::string& filename);
+SPCFile read_spc_impl(const std::string& filename, bool check_quality = false);
+
+/// Largest file read_spc_impl() reads whole instead of streaming (bytes).
+constexpr uint64_t kSlurpThreshold = 4u << 20;
+
+/**
+ * Parse a complete SPC file from a stream, as read_spc_impl() does for a
+ * path. Used for SPC data that is not a standalone file, such as a member
+ * of a shard read through MemoryInputStream.
+ *
+ * @param f Binary stream whose offset 0 is the start of the SPC data
+ * @param file_size Size of the SPC data in bytes
+ * @param name Name reported by tracepoints (path or member name)
+ * @param check_quality Also fill SPCFile::quality
+ * @return SPCFile structure containing all parsed data and metadata
+ * @throws std::runtime_error if the data is truncated or invalid
+ */
+SPCFile read_spc_stream(std::istream& f, uint64_t file_size, const std::string& name, bool check_quality = false);
+
+/**
+ * Parse a complete SPC file held in memory (a slurped file or a mapped
+ * shard member). Y values are decoded in place, without a scratch copy.
+ *
+ * @param data Start of the SPC data
+ * @param size Size of the SPC data in bytes
+ * @param name Name reported by tracepoints (path or member name)
+ * @param check_quality Also fill SPCFile::quality
+ * @return SPCFile structure containing all parsed data and metadata
+ * @throws std::runtime_error if the data is truncated or invalid
+ */
+SPCFile read_spc_memory(const char* data, size_t size, const std::string& name, bool check_quality = false);
 
 /**
  * Convert SPCFile structure to Python dictionary for pybind11 bindings.
@@ -0,0 +1,143 @@
+#include "spc_segment.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#if !defined(_WIN32) && !defined(__linux__)
+#include <atomic>
+#endif
+
+namespace {
+
+// Indices of the points of one subfile that a selection keeps.
+void select_points(const double* x, size_t n, const PointSelection& selection, tracked_vector<uint32_t>& out) {
+    out.clear();
+    size_t matched = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] >= selection.x_min && x[i] <= selection.x_max) {
+            if (matched++ % selection.step == 0) {
+                out.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+}
+
+#ifndef _WIN32
+int create_shared_file() {
+#ifdef __linux__
+    int fd = memfd_create("specio3-spectra", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+    static std::atomic<unsigned> counter{0};
+    const std::string name = "/specio3-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name.c_str());
+    }
+#endif
+    if (fd < 0) {
+        throw std::runtime_error("Unable to create shared memory: " + std::string(std::strerror(errno)));
+    }
+    return fd;
+}
+#endif
+
+}  // namespace
+
+SpectraSegment decode_to_segment(const SPCHandle& handle, uint32_t first, uint32_t count,
+                                 const PointSelection& selection, size_t num_threads) {
+#ifdef _WIN32
+    (void)handle, (void)first, (void)count, (void)selection, (void)num_threads;
+    throw std::runtime_error("Shared-memory segments are not supported on Windows");
+#else
+    if (first > handle.size() || count > handle.size() - first) {
+        throw std::runtime_error("Subfiles [" + std::to_string(first) + ", " + std::to_string(uint64_t{first} + count) +
+                                 ") out of range for " + std::to_string(handle.size()) + " subfiles");
+    }
+    if (selection.step == 0) {
+        throw std::runtime_error("step must be at least 1");
+    }
+
+    // Pass 1: count the selected points of every subfile
+    tracked_vector<int64_t> offsets(size_t{count} + 1, 0);
+    parallel_for(count, num_threads, [&](size_t i) {
+        const uint32_t s = first + static_cast<uint32_t>(i);
+        tracked_vector<double> x(handle.num_points(s));
+        tracked_vector<uint32_t> picked;
+        handle.read_x(s, x.data());
+        select_points(x.data(), x.size(), selection, picked);
+        offsets[i + 1] = static_cast<int64_t>(picked.size());
+    });
+    for (size_t i = 0; i < count; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    SpectraSegment out;
+    out.num_subfiles = count;
+    out.num_values = static_cast<size_t>(offsets[count]);
+    const size_t offsets_bytes = (size_t{count} + 1) * sizeof(int64_t);
+    const size_t z_bytes = size_t{count} * sizeof(double);
+    const size_t values_bytes = out.num_values * sizeof(double);
+    out.size = offsets_bytes + z_bytes + 2 * values_bytes;
+
+    out.fd = create_shared_file();
+    void* map = MAP_FAILED;
+    try {
+        if (ftruncate(out.fd, static_cast<off_t>(out.size)) != 0) {
+            throw std::runtime_error("Unable to size shared memory: " + std::string(std::strerror(errno)));
+        }
+        map = mmap(nullptr, out.size, PROT_READ | PROT_WRITE, MAP_SHARED, out.fd, 0);
+        if (map == MAP_FAILED) {
+            throw std::runtime_error("Unable to map shared memory: " + std::string(std::strerror(errno)));
+        }
+        char* base = static_cast<char*>(map);
+        auto* seg_offsets = reinterpret_cast<int64_t*>(base);
+        auto* seg_z = reinterpret_cast<double*>(base + offsets_bytes);
+        auto* seg_x = reinterpret_cast<double*>(base + offsets_bytes + z_bytes);
+        auto* seg_y = seg_x + out.num_values;
+        std::copy(offsets.begin(), offsets.end(), seg_offsets);
+
+        // Pass 2: decode every subfile into its slice
+        parallel_for(count, num_threads, [&](size_t i) {
+            const uint32_t s = first + static_cast<uint32_t>(i);
+            const size_t n = handle.num_points(s);
+            tracked_vector<double> x(n);
+            tracked_vector<double> y(n);
+            tracked_vector<uint32_t> picked;
+            handle.read_x(s, x.data());
+            handle.read_y(s, 0, n, y.data());
+            select_points(x.data(), n, selection, picked);
+            double* dx = seg_x + offsets[i];
+            double* dy = seg_y + offsets[i];
+            for (size_t k = 0; k < picked.size(); ++k) {
+                dx[k] = x[picked[k]];
+                dy[k] = y[picked[k]];
+            }
+            seg_z[i] = handle.layout().subfiles[s].z_start;
+        });
+        munmap(map, out.size);
+        map = MAP_FAILED;
+#ifdef __linux__
+        // Clients map the segment on the promise that it never changes
+        if (fcntl(out.fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+            throw std::runtime_error("Unable to seal shared memory: " + std::string(std::strerror(errno)));
+        }
+#endif
+    } catch (...) {
+        if (map != MAP_FAILED) {
+            munmap(map, out.size);
+        }
+        close(out.fd);
+        throw;
+    }
+    return out;
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "spc_handle.h"
+
+/**
+ * Decoded spectra in an anonymous shared-memory file, for handing to other
+ * processes as a file descriptor (see specio3d).
+ *
+ * The file holds four float64/int64 arrays back to back, each 8-byte aligned:
+ * offsets (int64, num_subfiles + 1), z (num_subfiles), x (num_values) and
+ * y (num_values); subfile i is [offsets[i], offsets[i + 1]) of x and y, as in
+ * read_spc_ragged(). On Linux the file is sealed against writes and resizing,
+ * so receivers can map it read-only and trust its contents.
+ */
+struct SpectraSegment {
+    int fd = -1;            ///< Owned by the caller, who must close it
+    size_t num_subfiles = 0;
+    size_t num_values = 0;  ///< Points over all subfiles
+    size_t size = 0;        ///< File size in bytes
+};
+
+/**
+ * Selection of points within each subfile: x_min <= x <= x_max, then every
+ * step-th of the remaining points.
+ */
+struct PointSelection {
+    double x_min = -std::numeric_limits<double>::infinity();
+    double x_max = std::numeric_limits<double>::infinity();
+    size_t step = 1;
+};
+
+/**
+ * Decode subfiles [first, first + count) of an open file into a new
+ * shared-memory segment. Values are written straight into the mapping.
+ *
+ * @param handle Open SPC file (only read)
+ * @param first First subfile
+ * @param count Number of subfiles
+ * @param selection Points to keep from each subfile
+ * @param num_threads Worker threads (0 = the executor's size)
+ * @return The segment; its fd must be closed by the caller
+ * @throws std::runtime_error on an invalid range or step, or if shared memory is unavailable
+ */
+SpectraSegment decode_to_segment(const SPCHandle& handle, uint32_t first, uint32_t count,
+                                 const PointSelection& selection, size_t num_threads);
@@ -0,0 +1,119 @@
+#include "spectral_grid.h"
+
+#include <cmath>
+#include <stdexcept>
+
+SimilarityMetric parse_similarity_metric(const std::string& name) {
+    if (name == "cosine") {
+        return SimilarityMetric::Cosine;
+    }
+    if (name == "pearson") {
+        return SimilarityMetric::Pearson;
+    }
+    throw std::runtime_error("Unknown similarity metric: '" + name + "' (expected 'cosine' or 'pearson')");
+}
+
+const char* similarity_metric_name(SimilarityMetric metric) {
+    return metric == SimilarityMetric::Pearson ? "pearson" : "cosine";
+}
+
+void validate_grid(const SpectralGrid& grid) {
+    if (grid.num_points < 2) {
+        throw std::runtime_error("Grid must have at least 2 points");
+    }
+    if (!(grid.x_min < grid.x_max)) {
+        throw std::runtime_error("Grid x_min must be smaller than x_max");
+    }
+}
+
+// Interpolation walk over an ascending view of the spectrum. Index maps the
+// logical ascending position to the storage position, so descending inputs
+// are handled without a copy.
+template <typename Index>
+static void resample_ascending(const double* x, const double* y, size_t n, Index idx,
+                               const SpectralGrid& grid, float* out) {
+    const double x_lo = x[idx(0)];
+    const double x_hi = x[idx(n - 1)];
+    size_t j = 0;
+    for (uint32_t i = 0; i < grid.num_points; ++i) {
+        const double g = grid.x_at(i);
+        if (g <= x_lo) {
+            out[i] = static_cast<float>(y[idx(0)]);
+            continue;
+        }
+        if (g >= x_hi) {
+            out[i] = static_cast<float>(y[idx(n - 1)]);
+            continue;
+        }
+        while (j + 2 < n && x[idx(j + 1)] < g) {
+            ++j;
+        }
+        const double x0 = x[idx(j)];
+        const double x1 = x[idx(j + 1)];
+        const double y0 = y[idx(j)];
+        const double y1 = y[idx(j + 1)];
+        const double t = (x1 != x0) ? (g - x0) / (x1 - x0) : 0.0;
+        out[i] = static_cast<float>(y0 + (y1 - y0) * t);
+    }
+}
+
+void resample_to_grid(const double* x, const double* y, size_t n, const SpectralGrid& grid, float* out) {
+    if (n == 0) {
+        throw std::runtime_error("Cannot resample an empty spectrum");
+    }
+    if (n == 1) {
+        for (uint32_t i = 0; i < grid.num_points; ++i) {
+            out[i] = static_cast<float>(y[0]);
+        }
+        return;
+    }
+    if (x[0] <= x[n - 1]) {
+        resample_ascending(x, y, n, [](size_t i) { return i; }, grid, out);
+    } else {
+        resample_ascending(x, y, n, [n](size_t i) { return n - 1 - i; }, grid, out);
+    }
+}
+
+void normalize_spectrum(float* v, size_t n, SimilarityMetric metric) {
+    if (metric == SimilarityMetric::Pearson) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += v[i];
+        }
+        const float mean = static_cast<float>(sum / static_cast<double>(n));
+        for (size_t i = 0; i < n; ++i) {
+            v[i] -= mean;
+        }
+    }
+
+    double sq = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sq += static_cast<double>(v[i]) * v[i];
+    }
+    if (sq <= 0 || !std::isfinite(sq)) {
+        for (size_t i = 0; i < n; ++i) {
+            v[i] = 0.0f;
+        }
+        return;
+    }
+    const float scale = static_cast<float>(1.0 / std::sqrt(sq));
+    for (size_t i = 0; i < n; ++i) {
+        v[i] *= scale;
+    }
+}
+
+float dot_f32(const float* a, const float* b, size_t n) {
+    constexpr size_t kLanes = 8;
+    float acc[kLanes] = {0, 0, 0, 0, 0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (size_t l = 0; l < kLanes; ++l) {
+            acc[l] += a[i + l] * b[i + l];
+        }
+    }
+    float tail = 0;
+    for (; i < n; ++i) {
+        tail += a[i] * b[i];
+    }
+    return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7])) + tail;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Similarity measure used when comparing resampled spectra.
+ * Both are computed as a plain dot product after normalize_spectrum().
+ */
+enum class SimilarityMetric : uint32_t {
+    Cosine = 0,   ///< Vectors scaled to unit L2 norm
+    Pearson = 1,  ///< Vectors mean-centred, then scaled to unit L2 norm
+};
+
+/**
+ * Parse a metric name ("cosine" or "pearson").
+ *
+ * @param name Metric name, case-sensitive
+ * @return The matching SimilarityMetric
+ * @throws std::runtime_error if the name is not recognised
+ */
+SimilarityMetric parse_similarity_metric(const std::string& name);
+
+/**
+ * Name of a metric, the inverse of parse_similarity_metric().
+ */
+const char* similarity_metric_name(SimilarityMetric metric);
+
+/**
+ * Evenly spaced X grid that spectra are resampled onto before comparison.
+ */
+struct SpectralGrid {
+    double x_min = 0;         ///< X value of the first grid point
+    double x_max = 0;         ///< X value of the last grid point
+    uint32_t num_points = 0;  ///< Number of grid points (>= 2)
+
+    /// X value of grid point i.
+    double x_at(size_t i) const {
+        return x_min + (x_max - x_min) * static_cast<double>(i) / static_cast<double>(num_points - 1);
+    }
+};
+
+/**
+ * Validate a grid definition.
+ *
+ * @throws std::runtime_error if num_points < 2 or x_min == x_max
+ */
+void validate_grid(const SpectralGrid& grid);
+
+/**
+ * Linearly interpolate a spectrum onto a grid.
+ * X may be ascending or descending. Grid points outside the spectrum's X
+ * range take the nearest edge value, like numpy.interp.
+ *
+ * @param x X values of the spectrum
+ * @param y Y values of the spectrum
+ * @param n Number of points in x and y (>= 1)
+ * @param grid Target grid
+ * @param out Output buffer of grid.num_points floats
+ */
+void resample_to_grid(const double* x, const double* y, size_t n, const SpectralGrid& grid, float* out);
+
+/**
+ * Normalize a resampled spectrum in place so that the dot product of two
+ * normalized vectors equals their similarity under the given metric.
+ * All-constant (zero-norm) vectors are left as zeros.
+ *
+ * @param v Vector to normalize
+ * @param n Vector length
+ * @param metric Similarity metric
+ */
+void normalize_spectrum(float* v, size_t n, SimilarityMetric metric);
+
+/**
+ * Dot product of two float vectors.
+ * Uses independent accumulator lanes so the loop vectorizes without
+ * requiring -ffast-math.
+ */
+float dot_f32(const float* a, const float* b, size_t n);
@@ -0,0 +1,107 @@
+"""Spectrum container that pickles its arrays without copying."""
+import pickle
+from typing import List
+
+import numpy as np
+from numpy.typing import ArrayLike, NDArray
+
+
+def _rebuild_spectrum(x_buffer, y_buffer) -> "Spectrum":
+    """Unpickle a Spectrum from the raw float64 buffers of its arrays."""
+    return Spectrum(np.frombuffer(x_buffer, dtype=np.float64), np.frombuffer(y_buffer, dtype=np.float64))
+
+
+class Spectrum(tuple):
+    """
+    One decoded spectrum as an ``(x, y)`` pair of float64 arrays.
+
+    A ``Spectrum`` is a 2-tuple, so existing code that unpacks
+    ``x, y = spectra[0]`` keeps working. Its pickle support is tuned for
+    moving spectra between processes: with pickle protocol 5 the arrays are
+    exported as :class:`pickle.PickleBuffer` objects, so a pickler given a
+    ``buffer_callback`` (as used by shared-memory transports) hands the
+    data over out of band instead of copying it into the pickle stream, and
+    the unpickled arrays are views of the supplied buffers.
+
+    Parameters
+    ----------
+    x, y : array_like
+        X and Y values; stored as C-contiguous float64 arrays (without a
+        copy when they already are).
+
+    Examples
+    --------
+    >>> import pickle
+    >>> spectrum = specio3.read_spc('example.spc')[0]
+    >>> buffers = []
+    >>> data = pickle.dumps(spectrum, protocol=5, buffer_callback=buffers.append)
+    >>> x, y = pickle.loads(data, buffers=buffers)  # no copy of the arrays
+    """
+
+    __slots__ = ()
+
+    def __new__(cls, x: ArrayLike, y: ArrayLike) -> "Spectrum":
+        return super().__new__(cls, (np.ascontiguousarray(x, dtype=np.float64),
+                                     np.ascontiguousarray(y, dtype=np.float64)))
+
+    @property
+    def x(self) -> NDArray[np.float64]:
+        """X-axis values."""
+        return self[0]
+
+    @property
+    def y(self) -> NDArray[np.float64]:
+        """Y-axis values."""
+        return self[1]
+
+    def __reduce_ex__(self, protocol):
+        if protocol >= 5:
+            return _rebuild_spectrum, (pickle.PickleBuffer(self.x), pickle.PickleBuffer(self.y))
+        return Spectrum, (self.x, self.y)
+
+    def __repr__(self) -> str:
+        return f"Spectrum(x={self.x!r}, y={self.y!r})"
+
+
+def spectra_from_dict(result_dict) -> List[Spectrum]:
+    """
+    Convert the dictionary produced by the native reader into spectra.
+
+    Raises
+    ------
+    RuntimeError
+        If the dictionary is malformed or holds no (or empty) spectra.
+    """
+    # Validate the result structure
+    if not isinstance(result_dict, dict):
+        raise RuntimeError("Expected a dictionary from the SPC file reader.")
+
+    if 'subfiles' not in result_dict:
+        raise RuntimeError("No subfiles found in the SPC file.")
+
+    subfiles = result_dict['subfiles']
+    if not subfiles:
+        raise RuntimeError("No spectra found in the SPC file.")
+
+    # Convert to list of (x, y) tuples with numpy arrays
+    result = []
+    for i, subfile in enumerate(subfiles):
+        if not isinstance(subfile, dict) or 'x' not in subfile or 'y' not in subfile:
+            raise RuntimeError(f"Spectrum {i}: Expected a dictionary with 'x' and 'y' keys.")
+
+        x_data = subfile['x']
+        y_data = subfile['y']
+
+        # Convert to numpy arrays
+        x_arr = np.array(x_data, dtype=np.float64)
+        y_arr = np.array(y_data, dtype=np.float64)
+
+        if len(x_arr) != len(y_arr):
+            raise RuntimeError(f"Spectrum {i}: x and y arrays have different lengths ({len(x_arr)} vs {len(y_arr)}).")
+
+        if len(x_arr) == 0:
+            raise RuntimeError(f"Spectrum {i}: Empty spectrum data.")
+
+        result.append(Spectrum(x_arr, y_arr))
+
+    return result
@@ -0,0 +1,65 @@
+"""Reading batches of SPC files in the order they finish decoding."""
+import os
+from typing import Iterator, List, Sequence, Tuple, Union
+
+from . import _specio3
+from .library import PathLike
+from .spectrum import Spectrum, spectra_from_dict
+
+
+def iter_read(
+    paths: Union[PathLike, Sequence[PathLike]], num_threads: int = 0
+) -> Iterator[Tuple[str, List[Spectrum]]]:
+    """
+    Read a batch of SPC files, yielding each one as soon as it is decoded.
+
+    Decoding starts in the background as soon as ``iter_read`` is called,
+    in parallel on specio3's thread pool. Results come out in the order the
+    files finish rather than the order given, so processing the first
+    results overlaps with decoding the rest and a slow file does not hold
+    back the others. The GIL is only held while a finished file is converted
+    to Python objects.
+
+    Parameters
+    ----------
+    paths : str, PathLike or sequence of them
+        SPC files to read.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Yields
+    ------
+    path : str
+        The file, as given in ``paths``.
+    spectra : list of Spectrum
+        Its spectra, as returned by :func:`read_spc`.
+
+    Raises
+    ------
+    RuntimeError
+        When the iteration reaches a file that could not be read; the
+        message names the file. Files not yet started are skipped once the
+        iterator is closed or discarded.
+
+    Examples
+    --------
+    >>> for path, spectra in specio3.iter_read(paths, num_threads=8):
+    ...     db.insert(path, spectra)   # overlaps with decoding the other files
+    """
+    if isinstance(paths, (str, os.PathLike)):
+        paths = [paths]
+    paths = [os.fspath(p) for p in paths]
+    reader = _specio3.CompletionReader(paths, int(num_threads))
+    return _results(reader, paths)
+
+
+def _results(reader, paths: List[str]) -> Iterator[Tuple[str, List[Spectrum]]]:
+    while True:
+        done = reader.next()
+        if done is None:
+            return
+        index, data = done
+        yield paths[index], spectra_from_dict(data)
+
+
+__all__ = ["iter_read"]
@@ -0,0 +1,87 @@
+"""Control of the native thread pool shared by all parallel operations."""
+from typing import Any, Dict, List, Sequence
+
+from . import _specio3
+
+
+def set_num_threads(num_threads: int) -> None:
+    """
+    Resize the thread pool used by every parallel specio3 operation.
+
+    All native parallel code (batch reads, matrix and ragged reads, library
+    search, exports, ...) runs on one process-wide pool, so specio3 never
+    uses more threads than this, however many operations run at once. Use
+    it to leave cores to NumPy/BLAS or other thread pools. A ``num_threads``
+    argument of an individual function can only lower the limit further.
+
+    Parameters
+    ----------
+    num_threads : int
+        Threads including the calling thread. 0 restores the default: the
+        ``SPECIO3_NUM_THREADS`` environment variable if set, else every core
+        the process may run on (see ``os.sched_getaffinity``).
+
+    Examples
+    --------
+    >>> specio3.set_num_threads(4)
+    """
+    if num_threads < 0:
+        raise ValueError("num_threads must be >= 0")
+    _specio3.set_num_threads(int(num_threads))
+
+
+def get_num_threads() -> int:
+    """Threads used by native parallel operations (see :func:`set_num_threads`)."""
+    return _specio3.get_num_threads()
+
+
+def set_thread_affinity(cpus: Sequence[int]) -> None:
+    """
+    Pin the native worker threads to a set of CPUs (Linux only).
+
+    The thread that calls a specio3 function always works on it too and is
+    not pinned.
+
+    Parameters
+    ----------
+    cpus : sequence of int
+        CPU indices; an empty sequence removes the pinning, returning the
+        workers to the CPU mask the process started with.
+
+    Raises
+    ------
+    RuntimeError
+        If a CPU index is invalid, offline or outside the process's CPU
+        mask, or on platforms without thread affinity.
+    """
+    _specio3.set_thread_affinity([int(c) for c in cpus])
+
+
+def thread_affinity() -> List[int]:
+    """CPUs the native worker threads are pinned to; empty if they are not pinned."""
+    return _specio3.thread_affinity()
+
+
+def executor_stats() -> Dict[str, Any]:
+    """
+    Return utilization counters of the native thread pool.
+
+    Returns
+    -------
+    dict
+        ``num_threads``; ``jobs`` (parallel operations completed) and
+        ``tasks`` (work items they ran); ``busy_seconds`` (thread time spent
+        in tasks); ``capacity_seconds`` (wall time of each job times the
+        threads it was allowed); and ``utilization``, their ratio. A low
+        utilization means threads waited on each other or on too few tasks.
+    """
+    return _specio3.executor_stats()
+
+
+def reset_executor_stats() -> None:
+    """Reset the counters reported by :func:`executor_stats`."""
+    _specio3.reset_executor_stats()
+
+
+__all__ = ["set_num_threads", "get_num_threads", "set_thread_affinity", "thread_affinity",
+           "executor_stats", "reset_executor_stats"]
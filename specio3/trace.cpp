@@ -0,0 +1,152 @@
+#include "trace.h"
+#include "mapped_file.h"
+#include "parallel.h"
+#include "spc_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Subfiles gathered per task; large enough to amortize scheduling, small enough to balance page faults.
+constexpr size_t kSubfilesPerTask = 1024;
+
+// Index of the stored float X value nearest to target on the monotonic X axis of an XY file.
+size_t nearest_stored_index(const char* x_bytes, size_t n, double target) {
+    auto x = [&](size_t i) { return static_cast<double>(read_le<float>(x_bytes + i * sizeof(float))); };
+    const bool ascending = x(n - 1) >= x(0);
+    size_t lo = 0;
+    size_t hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ascending ? x(mid) < target : x(mid) > target) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == n) {
+        return n - 1;
+    }
+    if (lo > 0 && std::fabs(x(lo - 1) - target) <= std::fabs(x(lo) - target)) {
+        return lo - 1;
+    }
+    return lo;
+}
+
+// Index of the point of an XYXY peak list nearest to target, found with a
+// linear scan since the X values may be unsorted; NaN X is never nearest.
+// Returns n when no point has a comparable X.
+size_t nearest_scattered_index(const char* x_bytes, size_t n, double target) {
+    size_t best = n;
+    double best_distance = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double distance = std::fabs(static_cast<double>(read_le<float>(x_bytes + i * sizeof(float))) - target);
+        if (!std::isnan(distance) && (best == n || distance < best_distance)) {
+            best = i;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+// Index of the generated X value nearest to target in a Y-only file.
+size_t nearest_generated_index(const SPCLayout& layout, double target) {
+    const size_t n = layout.num_points;
+    if (n <= 1 || layout.last_x == layout.first_x) {
+        return 0;
+    }
+    const double step = (layout.last_x - layout.first_x) / static_cast<double>(n - 1);
+    const double g = std::round((target - layout.first_x) / step);
+    size_t i = g <= 0 ? 0 : (g >= static_cast<double>(n - 1) ? n - 1 : static_cast<size_t>(g));
+    auto distance = [&](size_t j) { return std::fabs(layout.generated_x(static_cast<uint32_t>(j)) - target); };
+    // Rounding of the affine estimate can be off by one near half-way points
+    while (i > 0 && distance(i - 1) < distance(i)) {
+        --i;
+    }
+    while (i + 1 < n && distance(i + 1) < distance(i)) {
+        ++i;
+    }
+    return i;
+}
+
+void check_range(const MappedFile& map, uint64_t offset, uint64_t length) {
+    if (offset + length > map.size()) {
+        throw std::runtime_error("Data at offset " + std::to_string(offset) + " extends past the end of the file (" +
+                                 std::to_string(map.size()) + " bytes)");
+    }
+}
+
+}  // namespace
+
+SpectralTrace read_trace(const std::string& path, const std::vector<double>& x_positions, size_t num_threads) {
+    if (x_positions.empty()) {
+        throw std::runtime_error("At least one X position is required");
+    }
+    for (double x : x_positions) {
+        if (!std::isfinite(x)) {
+            throw std::runtime_error("X positions must be finite");
+        }
+    }
+
+    SPCLayout layout;
+    {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            throw std::runtime_error("Unable to open file: " + path);
+        }
+        f.seekg(0, std::ios::end);
+        layout = read_spc_layout(f, static_cast<uint64_t>(f.tellg()));
+    }
+    MappedFile map(path);
+
+    // Y-only and XY files share one X axis, so the sample indices are found once
+    const size_t num_positions = x_positions.size();
+    std::vector<size_t> shared_indices(num_positions);
+    if (!layout.is_xyxy) {
+        if (layout.is_xy) {
+            check_range(map, layout.shared_x_offset, uint64_t{layout.num_points} * sizeof(float));
+        }
+        for (size_t p = 0; p < num_positions; ++p) {
+            shared_indices[p] = layout.is_xy
+                ? nearest_stored_index(map.data() + layout.shared_x_offset, layout.num_points, x_positions[p])
+                : nearest_generated_index(layout, x_positions[p]);
+        }
+    }
+
+    SpectralTrace trace;
+    trace.num_subfiles = layout.num_subfiles;
+    trace.num_positions = num_positions;
+    trace.values.resize(trace.num_subfiles * num_positions);
+    trace.z.resize(trace.num_subfiles);
+
+    const size_t num_tasks = (trace.num_subfiles + kSubfilesPerTask - 1) / kSubfilesPerTask;
+    parallel_for(num_tasks, num_threads, [&](size_t t) {
+        const size_t end = std::min(trace.num_subfiles, (t + 1) * kSubfilesPerTask);
+        std::vector<size_t> indices = shared_indices;
+        for (size_t s = t * kSubfilesPerTask; s < end; ++s) {
+            const SubfileLayout& sub = layout.subfiles[s];
+            trace.z[s] = sub.z_start;
+            if (layout.is_xyxy) {
+                check_range(map, sub.x_offset, uint64_t{sub.num_points} * sizeof(float));
+                for (size_t p = 0; p < num_positions; ++p) {
+                    indices[p] = nearest_scattered_index(map.data() + sub.x_offset, sub.num_points, x_positions[p]);
+                }
+            }
+            const uint32_t value_size = layout.y_value_size(sub);
+            for (size_t p = 0; p < num_positions; ++p) {
+                if (indices[p] == sub.num_points) {
+                    trace.values[s * num_positions + p] = std::numeric_limits<double>::quiet_NaN();
+                    continue;
+                }
+                const uint64_t offset = sub.y_offset + uint64_t{indices[p]} * value_size;
+                check_range(map, offset, value_size);
+                decode_y_values(layout, sub, map.data() + offset, 1, &trace.values[s * num_positions + p]);
+            }
+        }
+    });
+    return trace;
+}
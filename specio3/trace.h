@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "alloc_tracking.h"
+
+/**
+ * Y values at fixed X positions across every subfile of one SPC file,
+ * stored row-major (num_subfiles x num_positions).
+ */
+struct SpectralTrace {
+    size_t num_subfiles = 0;
+    size_t num_positions = 0;
+    tracked_vector<double> values;  ///< Y at the point nearest each requested X
+    tracked_vector<double> z;       ///< z_start of each subfile
+};
+
+/**
+ * Extract kinetic traces (columns of a multifile) without decoding whole spectra.
+ *
+ * Each requested X is mapped to the nearest point (affine for Y-only files,
+ * a binary search over the shared X axis of XY files, and a linear scan of
+ * each subfile for XYXY, whose peak lists may be unsorted or hold NaN X).
+ * XYXY subfiles with no points, or only NaN X, yield NaN. The file is
+ * memory-mapped and only the bytes of the selected samples are gathered, so
+ * the OS reads one page per subfile instead of the whole file.
+ *
+ * @param path SPC file
+ * @param x_positions X values to sample
+ * @param num_threads Worker threads for the gather (0 = all cores)
+ * @return Trace values and subfile z values
+ * @throws std::runtime_error if the file cannot be read or no positions are given
+ */
+SpectralTrace read_trace(const std::string& path, const std::vector<double>& x_positions, size_t num_threads);
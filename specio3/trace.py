@@ -0,0 +1,57 @@
+"""Kinetic traces: Y at fixed X positions across every subfile."""
+import os
+from typing import Sequence, Tuple, Union
+
+import numpy as np
+from numpy.typing import NDArray
+
+from . import _specio3
+from .library import PathLike
+
+
+def read_trace(
+    path: PathLike, x: Union[float, Sequence[float]], num_threads: int = 0
+) -> Tuple[NDArray[np.float64], NDArray[np.float64]]:
+    """
+    Read the Y values at one or more X positions from every subfile.
+
+    Only the bytes of the selected samples are read, so extracting a column
+    from a 20,000-subfile kinetics run touches one page per subfile instead
+    of decoding every spectrum.
+
+    Parameters
+    ----------
+    path : str or PathLike
+        SPC file to read.
+    x : float or sequence of float
+        X positions. Each is mapped to the nearest stored (or, for Y-only
+        files, generated) X value; for XYXY files this is done per subfile,
+        skipping points with NaN X, and a subfile with no other points gives NaN.
+    num_threads : int, default 0
+        Worker threads; 0 uses every core.
+
+    Returns
+    -------
+    values : NDArray[np.float64]
+        Shape ``(n_subfiles,)`` for a scalar ``x``, otherwise
+        ``(n_subfiles, len(x))``.
+    z : NDArray[np.float64], shape (n_subfiles,)
+        Z (start) value of each subfile, e.g. the acquisition time.
+
+    Raises
+    ------
+    RuntimeError
+        If the file cannot be read or an X position is not finite.
+
+    Examples
+    --------
+    >>> absorbance, t = specio3.read_trace("kinetics.spc", x=1715.0)
+    >>> plt.plot(t, absorbance)
+    """
+    scalar = np.ndim(x) == 0
+    positions = [float(v) for v in np.atleast_1d(np.asarray(x, dtype=np.float64))]
+    values, z = _specio3.read_trace(os.fspath(path), positions, int(num_threads))
+    return (values[:, 0] if scalar else values), z
+
+
+__all__ = ["read_trace"]
@@ -0,0 +1,39 @@
+#pragma once
+
+/**
+ * Static (USDT/SDT) probe points on the read pipeline, provider "specio3".
+ *
+ * When <sys/sdt.h> (systemtap-sdt-dev / systemtap-sdt-devel) is available at
+ * build time each probe is a single nop plus an ELF note; tools such as
+ * `perf probe sdt_specio3:*`, `bpftrace -l 'usdt:*:specio3:*'` or SystemTap
+ * attach to them in the shipped binary without rebuilding. Elsewhere, or
+ * with SPECIO3_NO_SDT defined, the macros compile to no code: their
+ * arguments only appear in sizeof, so they are not evaluated but still
+ * count as used.
+ *
+ * Probes:
+ *   file_open(const char* path)
+ *   header_parsed(const char* path, uint32 num_subfiles, uint32 num_points, uint64 file_size)
+ *   subfile_decoded(uint32 index, uint32 num_points, uint64 bytes)
+ *   log_parsed(uint64 bytes)
+ *   to_python_done(uint32 num_subfiles)
+ */
+
+#if !defined(SPECIO3_NO_SDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SPECIO3_HAVE_SDT 1
+#endif
+#endif
+
+#ifdef SPECIO3_HAVE_SDT
+#define SPECIO3_PROBE1(name, a1) DTRACE_PROBE1(specio3, name, a1)
+#define SPECIO3_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(specio3, name, a1, a2, a3)
+#define SPECIO3_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(specio3, name, a1, a2, a3, a4)
+#else
+// sizeof keeps the arguments "used" without evaluating them
+#define SPECIO3_PROBE1(name, a1) do { (void)sizeof(a1); } while (0)
+#define SPECIO3_PROBE3(name, a1, a2, a3) do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); } while (0)
+#define SPECIO3_PROBE4(name, a1, a2, a3, a4) \
+    do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); (void)sizeof(a4); } while (0)
+#endif
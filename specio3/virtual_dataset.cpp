@@ -0,0 +1,145 @@
+#include "virtual_dataset.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+// Rows decoded per task; a task keeps its current file open across them.
+constexpr size_t kRowsPerTask = 32;
+
+bool same_x(double a, double b) {
+    return std::fabs(a - b) <= 1e-9 * std::max({std::fabs(a), std::fabs(b), 1.0});
+}
+
+}  // namespace
+
+VirtualDataset::VirtualDataset(const std::vector<std::string>& paths, size_t num_threads)
+    : batch_(read_spc_batch(paths, num_threads)) {
+    if (batch_.num_rows() == 0) {
+        throw std::runtime_error("A virtual dataset needs at least one spectrum");
+    }
+
+    // The first file with any subfiles supplies the reference X axis
+    size_t ref = 0;
+    while (batch_.layouts[ref].num_subfiles == 0) {
+        ++ref;
+    }
+    const SPCLayout& first = batch_.layouts[ref];
+    for (size_t i = 0; i < batch_.layouts.size(); ++i) {
+        const SPCLayout& layout = batch_.layouts[i];
+        if (layout.is_xyxy) {
+            throw std::runtime_error(paths[i] + ": XYXY files have a separate X axis per subfile");
+        }
+        if (layout.num_points != first.num_points) {
+            throw std::runtime_error(paths[i] + ": has " + std::to_string(layout.num_points) + " points, expected " +
+                                     std::to_string(first.num_points));
+        }
+    }
+    num_points_ = first.num_points;
+
+    std::ifstream f(paths[ref], std::ios::binary);
+    if (!f) {
+        throw std::runtime_error("Unable to open file: " + paths[ref]);
+    }
+    x_.resize(num_points_);
+    read_subfile_x(f, first, first.subfiles[0], x_.data());
+
+    // Two Y-only files generate the same X when their ranges match; an XY
+    // file stores its X, so it is read and compared point by point
+    std::vector<char> differs(batch_.layouts.size(), 0);
+    parallel_for(batch_.layouts.size(), num_threads, [&](size_t i) {
+        const SPCLayout& layout = batch_.layouts[i];
+        if (i == ref || layout.num_subfiles == 0) {
+            return;
+        }
+        if (!layout.is_xy && !first.is_xy) {
+            differs[i] = !same_x(layout.first_x, first.first_x) || !same_x(layout.last_x, first.last_x);
+            return;
+        }
+        std::ifstream in(paths[i], std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Unable to open file: " + paths[i]);
+        }
+        tracked_vector<double> x(num_points_);
+        try {
+            read_subfile_x(in, layout, layout.subfiles[0], x.data());
+        } catch (const std::exception& e) {
+            throw std::runtime_error(paths[i] + ": " + e.what());
+        }
+        differs[i] = !std::equal(x.begin(), x.end(), x_.begin(), same_x);
+    });
+    for (size_t i = 0; i < differs.size(); ++i) {
+        if (differs[i]) {
+            throw std::runtime_error(paths[i] + ": X axis differs from " + paths[ref]);
+        }
+    }
+}
+
+std::pair<size_t, uint32_t> VirtualDataset::locate(size_t row) const {
+    if (row >= num_rows()) {
+        throw std::runtime_error("Row " + std::to_string(row) + " out of range for " + std::to_string(num_rows()) +
+                                 " rows");
+    }
+    // Last file whose first row is <= row; files without subfiles are skipped
+    auto it = std::upper_bound(batch_.first_row.begin(), batch_.first_row.end(), row);
+    const size_t file = static_cast<size_t>(it - batch_.first_row.begin()) - 1;
+    return {file, static_cast<uint32_t>(row - batch_.first_row[file])};
+}
+
+tracked_vector<double> VirtualDataset::read_block(const std::vector<size_t>& rows, size_t first_point, size_t count,
+                                                  size_t num_threads) const {
+    if (first_point > num_points_ || count > num_points_ - first_point) {
+        throw std::runtime_error("Points [" + std::to_string(first_point) + ", " +
+                                 std::to_string(first_point + count) + ") out of range for " +
+                                 std::to_string(num_points_) + " points");
+    }
+    std::vector<std::pair<size_t, uint32_t>> locations(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        locations[i] = locate(rows[i]);
+    }
+
+    tracked_vector<double> out(rows.size() * count);
+    if (count == 0) {
+        return out;
+    }
+
+    std::vector<size_t> order(rows.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rows[a] < rows[b]; });
+
+    const size_t num_tasks = (order.size() + kRowsPerTask - 1) / kRowsPerTask;
+    parallel_for(num_tasks, num_threads, [&](size_t t) {
+        const size_t end = std::min(order.size(), (t + 1) * kRowsPerTask);
+        std::ifstream f;
+        size_t open_file = std::numeric_limits<size_t>::max();
+        tracked_vector<char> raw;
+        for (size_t k = t * kRowsPerTask; k < end; ++k) {
+            const size_t i = order[k];
+            const auto [file, subfile] = locations[i];
+            const std::string& file_path = batch_.paths[file];
+            if (file != open_file) {
+                f.close();
+                f.clear();
+                f.open(file_path, std::ios::binary);
+                if (!f) {
+                    throw std::runtime_error("Unable to open file: " + file_path);
+                }
+                open_file = file;
+            }
+            const SPCLayout& layout = batch_.layouts[file];
+            try {
+                read_subfile_y(f, layout, layout.subfiles[subfile], first_point, count, raw,
+                               out.data() + i * count);
+            } catch (const std::exception& e) {
+                throw std::runtime_error(file_path + ": " + e.what());
+            }
+        }
+    });
+    return out;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "spc_batch.h"
+
+/**
+ * A set of SPC files sharing one X axis, viewed as a single
+ * (num_rows x num_points) matrix whose rows are the subfiles in file order.
+ *
+ * Opening the dataset only parses headers; read_block() then decodes just
+ * the rows and the range of points it is asked for.
+ */
+class VirtualDataset {
+public:
+    /**
+     * Probe the headers of every file in parallel.
+     *
+     * The X axis is taken from the first file. Every file must have the same
+     * number of points and the same X values: Y-only files are compared by
+     * their first and last X, XY files point by point (in parallel).
+     *
+     * @param paths SPC files (Y-only or XY)
+     * @param num_threads Worker threads (0 = all cores)
+     * @throws std::runtime_error if a header cannot be read, a file is XYXY or
+     *         the files do not share an X axis
+     */
+    VirtualDataset(const std::vector<std::string>& paths, size_t num_threads);
+
+    size_t num_rows() const { return batch_.num_rows(); }
+    uint32_t num_points() const { return num_points_; }
+    const tracked_vector<double>& x() const { return x_; }
+
+    /**
+     * File index and subfile index of a row.
+     *
+     * @throws std::runtime_error if row is out of range
+     */
+    std::pair<size_t, uint32_t> locate(size_t row) const;
+
+    /** Path of a file by index. */
+    const std::string& path(size_t file) const { return batch_.paths[file]; }
+
+    /** Layouts and row numbering of the underlying files. */
+    const SPCBatch& batch() const { return batch_; }
+
+    /**
+     * Decode points [first_point, first_point + count) of the given rows.
+     *
+     * Rows are read in sorted order so each task opens a file once for its
+     * consecutive rows; only the bytes of the requested points are read.
+     *
+     * @param rows Row indices, in any order and possibly repeated
+     * @param first_point First point of every row to read
+     * @param count Number of points per row
+     * @param num_threads Worker threads (0 = all cores)
+     * @return rows.size() x count values, row-major, in the order of rows
+     * @throws std::runtime_error naming the file if a row cannot be read
+     */
+    tracked_vector<double> read_block(const std::vector<size_t>& rows, size_t first_point, size_t count,
+                                      size_t num_threads) const;
+
+private:
+    SPCBatch batch_;
+    uint32_t num_points_ = 0;
+    tracked_vector<double> x_;
+};
@@ -0,0 +1,211 @@
+#include "zarr_export.h"
+#include "parallel.h"
+#include "virtual_dataset.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    return out + "\"";
+}
+
+// Round-trippable JSON number; null for NaN and infinities, which JSON cannot represent.
+std::string json_number(double v) {
+    if (!std::isfinite(v)) {
+        return "null";
+    }
+    std::ostringstream os;
+    os.imbue(std::locale::classic());
+    os << std::setprecision(17) << v;
+    return os.str();
+}
+
+std::string json_shape(const std::vector<size_t>& dims) {
+    std::string out = "[";
+    for (size_t i = 0; i < dims.size(); ++i) {
+        out += (i ? ", " : "") + std::to_string(dims[i]);
+    }
+    return out + "]";
+}
+
+std::string json_names(const std::vector<std::string>& names) {
+    std::string out = "[";
+    for (size_t i = 0; i < names.size(); ++i) {
+        out += (i ? ", " : "") + json_string(names[i]);
+    }
+    return out + "]";
+}
+
+void write_file(const fs::path& path, const void* data, size_t size) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f || !f.write(static_cast<const char*>(data), static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Unable to write " + path.string());
+    }
+}
+
+void write_text(const fs::path& path, const std::string& text) {
+    write_file(path, text.data(), text.size());
+}
+
+// Group and array metadata for one Zarr format version.
+class ZarrStore {
+public:
+    ZarrStore(fs::path root, int format) : root_(std::move(root)), format_(format) {}
+
+    void write_group(const std::string& attributes) const {
+        fs::create_directories(root_);
+        if (format_ == 2) {
+            write_text(root_ / ".zgroup", "{\"zarr_format\": 2}\n");
+            write_text(root_ / ".zattrs", attributes + "\n");
+        } else {
+            write_text(root_ / "zarr.json",
+                       "{\"zarr_format\": 3, \"node_type\": \"group\", \"attributes\": " + attributes + "}\n");
+        }
+    }
+
+    void write_array(const std::string& name, const std::vector<size_t>& shape, const std::vector<size_t>& chunks,
+                     const std::vector<std::string>& dims) const {
+        const fs::path dir = root_ / name;
+        fs::create_directories(dir);
+        if (format_ == 2) {
+            write_text(dir / ".zarray",
+                       "{\"zarr_format\": 2, \"shape\": " + json_shape(shape) + ", \"chunks\": " + json_shape(chunks) +
+                           ", \"dtype\": \"<f8\", \"compressor\": null, \"fill_value\": 0.0, \"order\": \"C\", "
+                           "\"filters\": null, \"dimension_separator\": \".\"}\n");
+            write_text(dir / ".zattrs", "{\"_ARRAY_DIMENSIONS\": " + json_names(dims) + "}\n");
+        } else {
+            write_text(dir / "zarr.json",
+                       "{\"zarr_format\": 3, \"node_type\": \"array\", \"shape\": " + json_shape(shape) +
+                           ", \"data_type\": \"float64\", \"chunk_grid\": {\"name\": \"regular\", \"configuration\": "
+                           "{\"chunk_shape\": " + json_shape(chunks) + "}}, \"chunk_key_encoding\": {\"name\": "
+                           "\"default\", \"configuration\": {\"separator\": \"/\"}}, \"fill_value\": 0.0, "
+                           "\"codecs\": [{\"name\": \"bytes\", \"configuration\": {\"endian\": \"little\"}}], "
+                           "\"attributes\": {}, \"dimension_names\": " + json_names(dims) + "}\n");
+        }
+    }
+
+    // Path of chunk `index` of array `name`, creating its directory for v3 keys (c/i/j).
+    fs::path chunk_path(const std::string& name, const std::vector<size_t>& index) const {
+        fs::path path = root_ / name;
+        if (format_ == 2) {
+            std::string key;
+            for (size_t i = 0; i < index.size(); ++i) {
+                key += (i ? "." : "") + std::to_string(index[i]);
+            }
+            return path / key;
+        }
+        path /= "c";
+        for (size_t i = 0; i + 1 < index.size(); ++i) {
+            path /= std::to_string(index[i]);
+        }
+        fs::create_directories(path);
+        return path / std::to_string(index.back());
+    }
+
+private:
+    fs::path root_;
+    int format_;
+};
+
+// Group attributes: the header fields and row range of every source file.
+std::string source_attributes(const SPCBatch& batch) {
+    std::string files = "[";
+    for (size_t i = 0; i < batch.paths.size(); ++i) {
+        const SPCLayout& l = batch.layouts[i];
+        files += std::string(i ? ",\n    " : "\n    ") + "{\"path\": " + json_string(batch.paths[i]) +
+                 ", \"first_row\": " + std::to_string(batch.first_row[i]) +
+                 ", \"num_subfiles\": " + std::to_string(l.num_subfiles) +
+                 ", \"num_points\": " + std::to_string(l.num_points) +
+                 ", \"is_multifile\": " + (l.is_multifile ? "true" : "false") +
+                 ", \"is_xy\": " + (l.is_xy ? "true" : "false") +
+                 ", \"y_in_16bit\": " + (l.y_in_16bit ? "true" : "false") +
+                 ", \"is_old_format\": " + (l.is_old_format ? "true" : "false") +
+                 ", \"first_x\": " + json_number(l.first_x) + ", \"last_x\": " + json_number(l.last_x) +
+                 ", \"file_size\": " + std::to_string(l.file_size) + "}";
+    }
+    files += "\n  ]";
+    return "{\n  \"creator\": \"specio3\",\n  \"files\": " + files + "\n}";
+}
+
+}  // namespace
+
+size_t export_zarr(const std::vector<std::string>& paths, const std::string& output,
+                   const ZarrExportOptions& options) {
+    if (options.zarr_format != 2 && options.zarr_format != 3) {
+        throw std::runtime_error("zarr_format must be 2 or 3, got " + std::to_string(options.zarr_format));
+    }
+    VirtualDataset ds(paths, options.num_threads);
+    const size_t rows = ds.num_rows();
+    const size_t points = ds.num_points();
+    const size_t chunk_rows = std::clamp<size_t>(options.chunk_rows, 1, rows);
+    const size_t chunk_points = options.chunk_points == 0 ? points : std::clamp<size_t>(options.chunk_points, 1, points);
+
+    ZarrStore store(output, options.zarr_format);
+    store.write_group(source_attributes(ds.batch()));
+    store.write_array("y", {rows, points}, {chunk_rows, chunk_points}, {"spectrum", "point"});
+    store.write_array("x", {points}, {points}, {"point"});
+    store.write_array("z", {rows}, {rows}, {"spectrum"});
+
+    write_file(store.chunk_path("x", {0}), ds.x().data(), points * sizeof(double));
+    tracked_vector<double> z(rows);
+    for (size_t r = 0; r < rows; ++r) {
+        auto [file, subfile] = ds.locate(r);
+        z[r] = ds.batch().layouts[file].subfiles[subfile].z_start;
+    }
+    write_file(store.chunk_path("z", {0}), z.data(), rows * sizeof(double));
+
+    // One task per band of chunk_rows spectra: decode the band once, then
+    // write its chunks. Edge chunks are padded to the full chunk shape.
+    const size_t row_chunks = (rows + chunk_rows - 1) / chunk_rows;
+    const size_t point_chunks = (points + chunk_points - 1) / chunk_points;
+    parallel_for(row_chunks, options.num_threads, [&](size_t i) {
+        const size_t r0 = i * chunk_rows;
+        const size_t nr = std::min(chunk_rows, rows - r0);
+        std::vector<size_t> band_rows(nr);
+        for (size_t r = 0; r < nr; ++r) {
+            band_rows[r] = r0 + r;
+        }
+        const tracked_vector<double> band = ds.read_block(band_rows, 0, points, 1);
+
+        tracked_vector<double> chunk(chunk_rows * chunk_points);
+        for (size_t j = 0; j < point_chunks; ++j) {
+            const size_t p0 = j * chunk_points;
+            const size_t np = std::min(chunk_points, points - p0);
+            std::fill(chunk.begin(), chunk.end(), 0.0);
+            for (size_t r = 0; r < nr; ++r) {
+                std::copy_n(band.data() + r * points + p0, np, chunk.data() + r * chunk_points);
+            }
+            write_file(store.chunk_path("y", {i, j}), chunk.data(), chunk.size() * sizeof(double));
+        }
+    });
+    return rows;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Options for export_zarr().
+ */
+struct ZarrExportOptions {
+    int zarr_format = 2;          ///< 2 (.zarray/.zattrs) or 3 (zarr.json)
+    size_t chunk_rows = 1024;     ///< Spectra per chunk
+    size_t chunk_points = 0;      ///< Points per chunk (0 = whole spectra)
+    size_t num_threads = 0;       ///< Worker threads (0 = all cores)
+};
+
+/**
+ * Write SPC files sharing one X axis as an uncompressed Zarr directory store.
+ *
+ * The store is a group holding three float64 arrays:
+ *   y  (num_spectra x num_points), chunked as chunk_rows x chunk_points
+ *   x  (num_points), the common X axis
+ *   z  (num_spectra), z_start of every subfile
+ * and group attributes describing every source file (path, first row,
+ * subfile count and header fields). Dimension names are recorded in the
+ * form xarray expects. Each task decodes one band of chunk_rows spectra and
+ * writes all of its chunks, so chunks are written in parallel and each file
+ * is read once.
+ *
+ * @param paths SPC files (Y-only or XY, same number of points)
+ * @param output Directory to create; existing chunk files are overwritten
+ * @param options Format, chunk shape and threads
+ * @return Number of spectra written
+ * @throws std::runtime_error if an input cannot be read, the files do not
+ *         share an X axis, the options are invalid or the store cannot be written
+ */
+size_t export_zarr(const std::vector<std::string>& paths, const std::string& output,
+                   const ZarrExportOptions& options);
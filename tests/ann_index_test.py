@@ -0,0 +1,45 @@
+import os
+import tempfile
+import unittest
+from pathlib import Path
+
+import specio3
+
+
+class AnnIndexTests(unittest.TestCase):
+    def setUp(self):
+        self.data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(self.data_path, f) for f in os.listdir(self.data_path) if f.lower().endswith('.spc')
+        )
+        self.tmp = tempfile.TemporaryDirectory()
+        self.index_path = os.path.join(self.tmp.name, 'archive.spcann')
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def test_search_finds_itself(self):
+        index = specio3.build_ann_index(self.files, self.index_path, 500.0, 4000.0, 512, max_neighbors=8)
+        self.assertEqual(len(index), len(self.files))
+        for query in self.files[::7]:
+            indices, scores = index.search(query, k=5)
+            self.assertEqual(indices.shape, (1, 5))
+            self.assertEqual(index.entry(indices[0, 0]), (query, 0))
+            self.assertAlmostEqual(float(scores[0, 0]), 1.0, places=4)
+
+    def test_pca_reduction_agrees_with_exact_search(self):
+        index = specio3.build_ann_index(
+            self.files, self.index_path, 500.0, 4000.0, 512, pca_components=8, num_threads=2
+        )
+        self.assertEqual(index.pca_components, 8)
+        lib = specio3.build_library(
+            self.files, os.path.join(self.tmp.name, 'ref.spclib'), 500.0, 4000.0, 512, metric='cosine'
+        )
+        x, y = specio3.read_spc(self.files[10])[0]
+        ann_indices, _ = index.search((x, y), k=1, ef=len(self.files))
+        exact_indices, _ = lib.search((x, y), k=1)
+        self.assertEqual(ann_indices[0, 0], exact_indices[0, 0])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,66 @@
+import os
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+from tests.spc_data import write_spc, write_xyxy_spc
+
+
+class BandIntegrationTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[:6]
+        self.bands = [(1000.0, 1100.0), (2000.0, 1900.0), (-10.0, -5.0)]
+        self.tmp = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def _check(self, paths, bands):
+        """Compare integrate_bands with NumPy over the points of each band, sorted by X."""
+        areas, heights = specio3.integrate_bands(paths, bands)
+        spectra = [s for path in paths for s in specio3.read_spc(path)]
+        self.assertEqual(areas.shape, (len(spectra), len(bands)))
+        self.assertEqual(heights.shape, areas.shape)
+
+        for row, (x, y) in enumerate(spectra):
+            for col, (lo, hi) in enumerate(bands):
+                inside = (x >= min(lo, hi)) & (x <= max(lo, hi))
+                if not inside.any():
+                    self.assertTrue(np.isnan(areas[row, col]))
+                    self.assertTrue(np.isnan(heights[row, col]))
+                    continue
+                order = np.argsort(x[inside], kind='stable')
+                xb, yb = x[inside][order], y[inside][order]
+                expected = np.sum(0.5 * (yb[1:] + yb[:-1]) * np.diff(xb))
+                self.assertAlmostEqual(areas[row, col], expected, delta=1e-9 * abs(expected) + 1e-12)
+                self.assertEqual(heights[row, col], yb.max())
+
+    def test_matches_numpy(self):
+        self._check(self.files, self.bands)
+
+    def test_xy_multifile(self):
+        rng = np.random.default_rng(4)
+        x = 400.0 + 2.5 * np.arange(300)
+        y = rng.normal(size=(5, x.size))
+        bands = [(500.0, 520.0), (1100.0, 1000.0), (399.0, 401.0), (1146.0, 2000.0), (0.0, 100.0)]
+        ascending = write_spc(os.path.join(self.tmp.name, 'ascending.spc'), list(y), x=x)
+        descending = write_spc(os.path.join(self.tmp.name, 'descending.spc'), list(y), x=x[::-1])
+        self._check([ascending, descending], bands)
+
+    def test_xyxy_unsorted_x(self):
+        path = write_xyxy_spc(os.path.join(self.tmp.name, 'xyxy.spc'))
+        self._check([path], [(0.0, 10.0), (2.0, 5.0), (8.0, 9.0), (-5.0, -3.0), (100.0, 200.0)])
+
+    def test_single_path(self):
+        areas, _ = specio3.integrate_bands(self.files[0], self.bands[:1], num_threads=1)
+        self.assertEqual(areas.shape, (1, 1))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,114 @@
+import os
+import socket
+import sys
+import tempfile
+import threading
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+from specio3.daemon import SpectrumServer
+
+
+@unittest.skipUnless(sys.platform.startswith('linux') and hasattr(socket, 'send_fds'),
+                     'specio3d needs Linux descriptor passing')
+class DaemonTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[:3]
+        self.tmp = tempfile.TemporaryDirectory()
+        self.merged = os.path.join(self.tmp.name, 'merged.spc')
+        specio3.merge_spc(self.files, self.merged)
+
+        self.socket_path = os.path.join(self.tmp.name, 'specio3d.sock')
+        self.server = SpectrumServer(self.socket_path, cache_bytes=64 << 20)
+        self.thread = threading.Thread(target=self.server.serve_forever, daemon=True)
+        self.thread.start()
+        self.client = specio3.DaemonClient(self.socket_path)
+
+    def tearDown(self):
+        self.client.close()
+        self.server.shutdown()
+        self.server.server_close()
+        self.tmp.cleanup()
+
+    def test_matches_read_spc(self):
+        expected = specio3.read_spc(self.merged)
+        x, y, offsets, z = self.client.read(self.merged)
+        self.assertEqual(len(offsets), len(expected) + 1)
+        self.assertEqual(z.shape, (len(expected),))
+        for i, (ex, ey) in enumerate(expected):
+            np.testing.assert_array_equal(x[offsets[i]:offsets[i + 1]], ex)
+            np.testing.assert_array_equal(y[offsets[i]:offsets[i + 1]], ey)
+        self.assertFalse(y.flags.writeable)
+
+    def test_selection(self):
+        expected = specio3.read_spc(self.merged)
+        x, y, offsets, _ = self.client.read(self.merged, subfiles=(1, 3), x_range=(1000, 2000), step=3)
+        self.assertEqual(len(offsets), 3)
+        for i, (ex, ey) in enumerate(expected[1:3]):
+            keep = (ex >= 1000) & (ex <= 2000)
+            np.testing.assert_array_equal(x[offsets[i]:offsets[i + 1]], ex[keep][::3])
+            np.testing.assert_array_equal(y[offsets[i]:offsets[i + 1]], ey[keep][::3])
+
+    def test_cache_hits(self):
+        first = self.client.read(self.merged, subfiles=(0, 2))
+        second = self.client.read(self.merged, subfiles=(0, 2))
+        np.testing.assert_array_equal(first[1], second[1])
+        stats = self.client.stats()
+        self.assertEqual(stats['misses'], 1)
+        self.assertEqual(stats['hits'], 1)
+        self.assertEqual(stats['segments'], 1)
+
+    def test_concurrent_clients_with_evictions(self):
+        # A one-byte cache evicts a segment on every miss, racing with sends to other clients
+        socket_path = os.path.join(self.tmp.name, 'tiny.sock')
+        server = SpectrumServer(socket_path, cache_bytes=1)
+        thread = threading.Thread(target=server.serve_forever, daemon=True)
+        thread.start()
+        expected = specio3.read_spc(self.merged)
+        failures = []
+
+        def worker(seed):
+            try:
+                with specio3.DaemonClient(socket_path) as client:
+                    for i in range(20):
+                        first = (seed + i) % len(expected)
+                        step = 1 + (seed + i) % 4
+                        x, y, offsets, _ = client.read(self.merged, subfiles=(first, first + 1), step=step)
+                        np.testing.assert_array_equal(x, expected[first].x[::step])
+                        np.testing.assert_array_equal(y, expected[first].y[::step])
+            except Exception as e:  # reported on the main thread
+                failures.append(e)
+
+        threads = [threading.Thread(target=worker, args=(seed,)) for seed in range(6)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        try:
+            self.assertEqual(failures, [])
+            stats = server.stats()
+            self.assertGreater(stats['evictions'], 0)
+            self.assertLessEqual(stats['segments'], 1)
+        finally:
+            server.shutdown()
+            server.server_close()
+
+    def test_errors(self):
+        with self.assertRaises(RuntimeError):
+            self.client.read(os.path.join(self.tmp.name, 'missing.spc'))
+        with self.assertRaises(RuntimeError):
+            self.client.read(self.merged, subfiles=(0, 10))
+        with self.assertRaises(RuntimeError):
+            self.client.read(self.merged, step=0)
+        # The connection stays usable after an error
+        self.assertEqual(len(self.client.read(self.merged)[2]), 4)
+
+
+if __name__ == '__main__':
+    unittest.main()
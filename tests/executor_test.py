@@ -0,0 +1,81 @@
+import multiprocessing
+import os
+import sys
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+
+
+def _read_in_child(path):
+    x, y, z = specio3.read_spc_matrix(path, transpose=True, num_threads=2)
+    return float(y.sum())
+
+
+class ExecutorTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.path = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[0]
+        self.default_threads = specio3.get_num_threads()
+
+    def tearDown(self):
+        specio3.set_num_threads(0)
+
+    def test_set_num_threads(self):
+        specio3.set_num_threads(3)
+        self.assertEqual(specio3.get_num_threads(), 3)
+        specio3.set_num_threads(0)
+        self.assertEqual(specio3.get_num_threads(), self.default_threads)
+        with self.assertRaises(ValueError):
+            specio3.set_num_threads(-1)
+
+    def test_results_independent_of_pool_size(self):
+        specio3.set_num_threads(1)
+        _, expected, _ = specio3.read_spc_matrix(self.path, transpose=True)
+        specio3.set_num_threads(4)
+        _, actual, _ = specio3.read_spc_matrix(self.path, transpose=True)
+        np.testing.assert_array_equal(actual, expected)
+
+    def test_stats(self):
+        specio3.set_num_threads(2)
+        specio3.reset_executor_stats()
+        specio3.read_spc_matrix(self.path, transpose=True)
+        stats = specio3.executor_stats()
+        self.assertEqual(stats['num_threads'], 2)
+        self.assertGreater(stats['jobs'], 0)
+        self.assertGreater(stats['tasks'], 0)
+        self.assertGreaterEqual(stats['utilization'], 0.0)
+        specio3.reset_executor_stats()
+        self.assertEqual(specio3.executor_stats()['jobs'], 0)
+
+    @unittest.skipUnless(sys.platform.startswith('linux'), 'thread affinity is Linux-only')
+    def test_affinity(self):
+        allowed = os.sched_getaffinity(0)
+        cpu = min(allowed)
+        specio3.set_thread_affinity([cpu])
+        self.assertEqual(specio3.thread_affinity(), [cpu])
+        specio3.read_spc_matrix(self.path, num_threads=2)
+        specio3.set_thread_affinity([])
+        self.assertEqual(specio3.thread_affinity(), [])
+        with self.assertRaises(RuntimeError):
+            specio3.set_thread_affinity([-1])
+        unavailable = next(c for c in range(1024) if c not in allowed)
+        with self.assertRaisesRegex(RuntimeError, 'not available'):
+            specio3.set_thread_affinity([unavailable])
+        self.assertEqual(specio3.thread_affinity(), [])
+
+    @unittest.skipUnless(hasattr(os, 'fork'), 'requires fork')
+    def test_fork_after_parallel_read(self):
+        specio3.set_num_threads(4)
+        expected = _read_in_child(self.path)
+        with multiprocessing.get_context('fork').Pool(2) as pool:
+            results = pool.map(_read_in_child, [self.path] * 4)
+        self.assertEqual(results, [expected] * 4)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,64 @@
+import os
+import sys
+import sysconfig
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+from specio3 import _specio3
+from tests.spc_data import common_length_files
+
+
+class FreeThreadingTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.paths = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )
+
+    @unittest.skipUnless(sysconfig.get_config_var('Py_GIL_DISABLED'), 'requires a free-threaded interpreter')
+    def test_import_keeps_gil_disabled(self):
+        self.assertFalse(sys._is_gil_enabled())
+
+    def test_concurrent_reads_match_serial_reads(self):
+        expected = [specio3.read_spc(p) for p in self.paths]
+        with ThreadPoolExecutor(max_workers=8) as pool:
+            results = list(pool.map(specio3.read_spc, self.paths * 4))
+        for i, spectra in enumerate(results):
+            reference = expected[i % len(self.paths)]
+            self.assertEqual(len(spectra), len(reference))
+            for (x, y), (ex, ey) in zip(spectra, reference):
+                np.testing.assert_array_equal(x, ex)
+                np.testing.assert_array_equal(y, ey)
+
+    def test_shared_native_iterators(self):
+        # Several threads draining one loader or reader each get distinct items
+        def drain(next_item):
+            items = []
+            item = next_item()
+            while item is not None:
+                items.append(item)
+                item = next_item()
+            return items
+
+        paths, _ = common_length_files()
+        loader = _specio3.BatchLoader(paths, batch_size=2, prefetch=2)
+        for epoch in range(3):
+            loader.start_epoch(epoch)
+            with ThreadPoolExecutor(max_workers=4) as pool:
+                batches = sum(pool.map(drain, [loader.next] * 4), [])
+            rows = np.concatenate([rows for _, rows in batches])
+            np.testing.assert_array_equal(np.sort(rows), np.arange(loader.num_rows))
+            self.assertEqual(len(batches), len(loader))
+
+        reader = _specio3.CompletionReader(self.paths, 4)
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            done = sum(pool.map(drain, [reader.next] * 4), [])
+        self.assertEqual(sorted(index for index, _ in done), list(range(len(self.paths))))
+
+
+if __name__ == '__main__':
+    unittest.main()
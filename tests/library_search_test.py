@@ -0,0 +1,53 @@
+import os
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+
+
+class LibrarySearchTests(unittest.TestCase):
+    def setUp(self):
+        self.data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(self.data_path, f) for f in os.listdir(self.data_path) if f.lower().endswith('.spc')
+        )
+        self.tmp = tempfile.TemporaryDirectory()
+        self.lib_path = os.path.join(self.tmp.name, 'ref.spclib')
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def test_search_finds_itself(self):
+        lib = specio3.build_library(self.files, self.lib_path, 500.0, 4000.0, 1024)
+        self.assertEqual(len(lib), len(self.files))
+        self.assertEqual(lib.metric, 'pearson')
+
+        query = self.files[3]
+        indices, scores = lib.search(query, k=3)
+        self.assertEqual(indices.shape, (1, 3))
+        self.assertEqual(lib.entry(indices[0, 0]), (query, 0))
+        self.assertAlmostEqual(float(scores[0, 0]), 1.0, places=4)
+        self.assertTrue(np.all(np.diff(scores[0]) <= 0))
+
+    def test_search_matches_numpy(self):
+        lib = specio3.build_library(self.files[:8], self.lib_path, 500.0, 4000.0, 512, metric='cosine')
+        x, y = specio3.read_spc(self.files[0])[0]
+        indices, scores = lib.search((x, y), k=len(lib))
+
+        grid = lib.grid
+        order = np.argsort(x)
+        q = np.interp(grid, x[order], y[order])
+        expected = []
+        for path in self.files[:8]:
+            rx, ry = specio3.read_spc(path)[0]
+            o = np.argsort(rx)
+            r = np.interp(grid, rx[o], ry[o])
+            expected.append(np.dot(q, r) / (np.linalg.norm(q) * np.linalg.norm(r)))
+        np.testing.assert_allclose(scores[0], np.sort(expected)[::-1], atol=1e-4)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,67 @@
+import pickle
+import unittest
+
+import numpy as np
+
+import specio3
+from tests.spc_data import common_length_files
+
+
+class LoaderTests(unittest.TestCase):
+    def setUp(self):
+        self.files = common_length_files()[0][:12]
+        self.expected = np.vstack([y for path in self.files for _, y in specio3.read_spc(path)]).astype(np.float32)
+
+    def _epoch(self, loader):
+        return [(y.copy(), rows.copy()) for y, rows in loader]
+
+    def test_sequential(self):
+        loader = specio3.Loader(self.files, batch_size=5, prefetch=3)
+        self.assertEqual(len(loader), 3)
+        batches = self._epoch(loader)
+        self.assertEqual([len(rows) for _, rows in batches], [5, 5, 2])
+        for y, rows in batches:
+            self.assertEqual(y.dtype, np.float32)
+            np.testing.assert_array_equal(y, self.expected[rows])
+        np.testing.assert_array_equal(np.concatenate([rows for _, rows in batches]), np.arange(12))
+
+    def test_seeded_shuffle(self):
+        loader = specio3.Loader(self.files, batch_size=4, shuffle=True, seed=7)
+        first = np.concatenate([rows for _, rows in self._epoch(loader)])
+        second = np.concatenate([rows for _, rows in self._epoch(loader)])
+        self.assertEqual(sorted(first), list(range(12)))
+        self.assertFalse(np.array_equal(first, second))
+
+        for prefetch in (0, 4):
+            again = specio3.Loader(self.files, batch_size=4, shuffle=True, seed=7, prefetch=prefetch)
+            np.testing.assert_array_equal(np.concatenate([rows for _, rows in self._epoch(again)]), first)
+            again.set_epoch(1)
+            batches = self._epoch(again)
+            np.testing.assert_array_equal(np.concatenate([rows for _, rows in batches]), second)
+            for y, rows in batches:
+                np.testing.assert_array_equal(y, self.expected[rows])
+
+    def test_drop_last_and_restart(self):
+        loader = specio3.Loader(self.files, batch_size=5, drop_last=True)
+        self.assertEqual(len(loader), 2)
+        abandoned = iter(loader)
+        next(abandoned)
+        self.assertEqual(len(self._epoch(loader)), 2)
+        self.assertEqual(list(abandoned), [])
+
+    def test_pickle(self):
+        loader = specio3.Loader(self.files, batch_size=4, shuffle=True, seed=3)
+        restored = pickle.loads(pickle.dumps(loader))
+        for (y, rows), (ry, rrows) in zip(self._epoch(loader), self._epoch(restored)):
+            np.testing.assert_array_equal(rows, rrows)
+            np.testing.assert_array_equal(y, ry)
+
+    def test_invalid_arguments(self):
+        with self.assertRaises(ValueError):
+            specio3.Loader(self.files, batch_size=0)
+        with self.assertRaises(ValueError):
+            specio3.Loader(self.files, batch_size=1, prefetch=-1)
+
+
+if __name__ == '__main__':
+    unittest.main()
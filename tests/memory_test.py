@@ -0,0 +1,44 @@
+import os
+import unittest
+from pathlib import Path
+
+import specio3
+
+
+class AllocationStatsTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.path = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[0]
+
+    def test_last_read_covers_spectra(self):
+        x, y = specio3.read_spc(self.path)[0]
+        stats = specio3.allocation_stats()
+        self.assertGreater(stats['allocations'], 0)
+        self.assertEqual(stats['allocations'], stats['deallocations'])
+        self.assertGreaterEqual(stats['peak_bytes'], x.nbytes + y.nbytes)
+        self.assertEqual(stats['bytes_in_use'], 0)
+
+    def test_returned_arrays_stay_in_use(self):
+        x, y, z = specio3.read_spc_matrix(self.path)
+        stats = specio3.allocation_stats('last_read')
+        self.assertEqual(stats['bytes_in_use'], x.nbytes + y.nbytes + z.nbytes)
+        self.assertGreaterEqual(stats['peak_bytes'], stats['bytes_in_use'])
+
+    def test_global_counters_and_reset(self):
+        specio3.reset_allocation_stats()
+        before = specio3.allocation_stats('global')
+        self.assertEqual(before['allocations'], 0)
+        specio3.read_spc(self.path)
+        after = specio3.allocation_stats('global')
+        self.assertGreater(after['allocations'], 0)
+        self.assertGreater(specio3.allocation_stats('thread')['allocations'], 0)
+
+    def test_unknown_scope_raises(self):
+        with self.assertRaises(RuntimeError):
+            specio3.allocation_stats('process')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,96 @@
+import os
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+from tests.spc_data import write_spc, write_xyxy_spc
+
+
+class MultifileEditTests(unittest.TestCase):
+    def setUp(self):
+        self.data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.paths = [os.path.join(self.data_path, f) for f in ('022b4asf.spc', '040b4ana.spc', '040b4anb.spc')]
+        self.tmp = tempfile.TemporaryDirectory()
+        self.merged = os.path.join(self.tmp.name, 'merged.spc')
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def assert_same_spectra(self, actual, expected):
+        self.assertEqual(len(actual), len(expected))
+        for (x, y), (ex, ey) in zip(actual, expected):
+            np.testing.assert_array_equal(x, ex)
+            np.testing.assert_array_equal(y, ey)
+
+    def expected(self):
+        return [s for path in self.paths for s in specio3.read_spc(path)]
+
+    def test_merge_concatenates_subfiles(self):
+        self.assertEqual(specio3.merge_spc(self.paths, self.merged), len(self.paths))
+        self.assert_same_spectra(specio3.read_spc(self.merged), self.expected())
+
+    def test_split_round_trip(self):
+        specio3.merge_spc(self.paths, self.merged)
+        parts = specio3.split_spc(self.merged, os.path.join(self.tmp.name, 'parts'), num_threads=2)
+        self.assertEqual([os.path.basename(p) for p in parts], [f'merged_{i:05d}.spc' for i in range(3)])
+        for part, spectrum in zip(parts, self.expected()):
+            self.assert_same_spectra(specio3.read_spc(part), [spectrum])
+
+        remerged = os.path.join(self.tmp.name, 'remerged.spc')
+        specio3.merge_spc(parts, remerged)
+        with open(self.merged, 'rb') as a, open(remerged, 'rb') as b:
+            self.assertEqual(a.read(), b.read())
+
+    def test_extract_reorders(self):
+        specio3.merge_spc(self.paths, self.merged)
+        extracted = os.path.join(self.tmp.name, 'extracted.spc')
+        specio3.extract_subfiles(self.merged, [2, 0, 2], extracted)
+        expected = self.expected()
+        self.assert_same_spectra(specio3.read_spc(extracted), [expected[2], expected[0], expected[2]])
+
+    def test_new_format_xy_and_xyxy(self):
+        # New-format files with stored X: a 2-subfile and a single-subfile XY file, and an XYXY file
+        x = np.linspace(100.0, 200.0, 16)
+        xy = [write_spc(os.path.join(self.tmp.name, 'xy2.spc'), [np.arange(16.0), -np.arange(16.0)], x=x),
+              write_spc(os.path.join(self.tmp.name, 'xy1.spc'), [np.full(16, 0.5)], x=x)]
+        xyxy = write_xyxy_spc(os.path.join(self.tmp.name, 'xyxy.spc'))
+        for inputs in (xy, [xyxy, xyxy]):
+            expected = [s for path in inputs for s in specio3.read_spc(path)]
+            self.assertEqual(specio3.merge_spc(inputs, self.merged), len(expected))
+            self.assert_same_spectra(specio3.read_spc(self.merged), expected)
+            extracted = os.path.join(self.tmp.name, 'extracted.spc')
+            specio3.extract_subfiles(self.merged, [2, 0], extracted)
+            self.assert_same_spectra(specio3.read_spc(extracted), [expected[2], expected[0]])
+            parts = specio3.split_spc(self.merged, os.path.join(self.tmp.name, 'parts'))
+            for part, spectrum in zip(parts, expected):
+                self.assert_same_spectra(specio3.read_spc(part), [spectrum])
+        with self.assertRaises(RuntimeError):
+            specio3.merge_spc([xy[0], xyxy], self.merged)
+
+    def test_subfile_limit(self):
+        # Subheader indices are 16-bit; a tiny XY file keeps the 65535-subfile output small
+        small = write_spc(os.path.join(self.tmp.name, 'small.spc'), [[1.0, 2.0]], x=[0.0, 1.0])
+        out = os.path.join(self.tmp.name, 'out.spc')
+        specio3.extract_subfiles(small, [0] * 65535, out)
+        self.assertEqual(len(specio3.read_spc_ragged(out)[3]), 65535)
+        with self.assertRaisesRegex(RuntimeError, '65535'):
+            specio3.extract_subfiles(small, [0] * 65536, out)
+        with self.assertRaisesRegex(RuntimeError, '65535'):
+            specio3.merge_spc([out, small], self.merged)
+
+    def test_errors(self):
+        incompatible = os.path.join(self.data_path, '087b4ana.spc')
+        with self.assertRaises(RuntimeError):
+            specio3.merge_spc([self.paths[0], incompatible], self.merged)
+        with self.assertRaises(RuntimeError):
+            specio3.merge_spc([], self.merged)
+        specio3.merge_spc(self.paths, self.merged)
+        with self.assertRaises(RuntimeError):
+            specio3.extract_subfiles(self.merged, [3], os.path.join(self.tmp.name, 'out.spc'))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,38 @@
+import unittest
+
+import numpy as np
+
+import specio3
+from tests.spc_data import common_length_files
+
+
+class ProjectionTests(unittest.TestCase):
+    def setUp(self):
+        # Projection needs a common length
+        self.files = common_length_files()[0][:10]
+        self.num_points = len(specio3.read_spc(self.files[0])[0][1])
+        rng = np.random.default_rng(0)
+        self.loadings = rng.standard_normal((self.num_points, 4))
+        self.offset = rng.standard_normal(self.num_points) * 0.01
+
+    def test_matches_numpy(self):
+        y = np.vstack([spectrum[1] for f in self.files for spectrum in specio3.read_spc(f)])
+        expected = (y - self.offset) @ self.loadings
+
+        scores = specio3.read_spc(self.files, project=self.loadings, offset=self.offset)
+        self.assertEqual(scores.shape, (len(self.files), 4))
+        np.testing.assert_allclose(scores, expected, rtol=1e-9, atol=1e-9)
+
+    def test_single_path_and_vector_loadings(self):
+        y = specio3.read_spc(self.files[0])[0][1]
+        scores = specio3.read_spc(self.files[0], project=self.loadings[:, 0], num_threads=1)
+        self.assertEqual(scores.shape, (1, 1))
+        np.testing.assert_allclose(scores[0, 0], y @ self.loadings[:, 0], rtol=1e-9)
+
+    def test_length_mismatch_raises(self):
+        with self.assertRaises(RuntimeError):
+            specio3.read_spc(self.files[:1], project=self.loadings[:-1])
+
+
+if __name__ == '__main__':
+    unittest.main()
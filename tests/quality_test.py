@@ -0,0 +1,116 @@
+import os
+import shutil
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+from specio3 import QualityFlag
+from tests.spc_data import write_spc
+
+
+class QualityCheckTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )
+        self.tmp = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def _patched(self, codes):
+        """Copy of an old-format file (256-byte header, then word-swapped int32 Y) with some raw codes replaced."""
+        path = os.path.join(self.tmp.name, 'patched.spc')
+        shutil.copyfile(self.files[0], path)
+        num_points = len(specio3.read_spc(path)[0].y)
+        self.assertEqual(os.path.getsize(path), 256 + 4 * num_points)
+        with open(path, 'r+b') as f:
+            for index, code in codes.items():
+                f.seek(256 + 4 * index)
+                swapped = ((code & 0xFFFF) << 16) | (code >> 16)
+                f.write(int(swapped).to_bytes(4, 'little'))
+        return path
+
+    def test_counters_match_numpy(self):
+        for path in self.files[:10]:
+            spectra = specio3.read_spc(path)
+            checked, quality = specio3.read_spc(path, check_quality=True)
+            self.assertEqual(len(quality), len(spectra))
+            for (x, y), (cx, cy), q in zip(spectra, checked, quality):
+                np.testing.assert_array_equal(cy, y)
+                self.assertEqual(q['nan_count'], 0)
+                self.assertEqual(q['inf_count'], 0)
+                self.assertEqual(q['negative_count'], np.count_nonzero(y < 0))
+                self.assertEqual(q['y_min'], y.min())
+                self.assertEqual(q['y_max'], y.max())
+                self.assertEqual(bool(q['flags'] & QualityFlag.NEGATIVE), bool((y < 0).any()))
+
+    def test_saturation(self):
+        path = self._patched({i: 0x7FFFFFFF for i in list(range(100, 105)) + [2000]})
+        _, quality = specio3.read_spc(path, check_quality=True)
+        self.assertEqual(quality[0]['saturated_count'], 6)
+        self.assertEqual(quality[0]['saturated_run'], 5)
+        self.assertTrue(quality[0]['flags'] & QualityFlag.SATURATED)
+
+    def test_flat(self):
+        num_points = len(specio3.read_spc(self.files[0])[0].y)
+        path = self._patched({i: 1000 for i in range(num_points)})
+        _, quality = specio3.read_spc(path, check_quality=True)
+        self.assertEqual(QualityFlag(int(quality[0]['flags'])), QualityFlag.FLAT)
+        self.assertEqual(quality[0]['y_min'], quality[0]['y_max'])
+
+    def test_float_special_values(self):
+        # Float Y (exponent 0x80): -0.0 is not negative, -inf is
+        y = np.array([1.5, np.nan, np.inf, -np.inf, -0.0, -2.0, 3.25, 0.0, -7.5])
+        path = write_spc(os.path.join(self.tmp.name, 'float.spc'), [y])
+        ((_, cy),), quality = specio3.read_spc(path, check_quality=True)
+        np.testing.assert_array_equal(cy, y)
+        q = quality[0]
+        self.assertEqual((q['nan_count'], q['inf_count'], q['negative_count'], q['saturated_count']), (1, 2, 3, 0))
+        self.assertEqual(q['negative_count'], np.count_nonzero(y < 0))
+        self.assertEqual((q['y_min'], q['y_max']), (-7.5, 3.25))
+        self.assertEqual(QualityFlag(int(q['flags'])), QualityFlag.NON_FINITE | QualityFlag.NEGATIVE)
+
+    def test_float_edge_cases(self):
+        zeros = write_spc(os.path.join(self.tmp.name, 'zeros.spc'), [[0.0, -0.0, 0.0]])
+        _, quality = specio3.read_spc(zeros, check_quality=True)
+        self.assertEqual(QualityFlag(int(quality[0]['flags'])), QualityFlag.FLAT)
+        self.assertEqual(quality[0]['negative_count'], 0)
+
+        nonfinite = write_spc(os.path.join(self.tmp.name, 'nonfinite.spc'), [[np.nan, -np.inf]])
+        _, quality = specio3.read_spc(nonfinite, check_quality=True)
+        self.assertEqual(QualityFlag(int(quality[0]['flags'])), QualityFlag.NON_FINITE | QualityFlag.NEGATIVE)
+        self.assertEqual((quality[0]['y_min'], quality[0]['y_max']), (np.inf, -np.inf))
+
+    def test_int16(self):
+        codes = [100, -3, 32767, 32767, 32767, -32768, 0, 32767]
+        # Exponent 16 scales 16-bit codes by 2**0
+        path = write_spc(os.path.join(self.tmp.name, 'int16.spc'), [codes], exponent=16, int16=True)
+        ((_, y),), quality = specio3.read_spc(path, check_quality=True)
+        np.testing.assert_array_equal(y, codes)
+        q = quality[0]
+        self.assertEqual((q['saturated_count'], q['saturated_run'], q['negative_count']), (4, 3, 2))
+        self.assertEqual((q['y_min'], q['y_max']), (-32768.0, 32767.0))
+        self.assertEqual(QualityFlag(int(q['flags'])), QualityFlag.SATURATED | QualityFlag.NEGATIVE)
+
+    def test_matrix_matches_read_spc(self):
+        merged = os.path.join(self.tmp.name, 'merged.spc')
+        specio3.merge_spc(self.files[:3], merged)
+        _, expected = specio3.read_spc(merged, check_quality=True)
+        for transpose in (False, True):
+            x, y, z, quality = specio3.read_spc_matrix(merged, transpose=transpose, check_quality=True)
+            self.assertEqual(quality.dtype, expected.dtype)
+            np.testing.assert_array_equal(quality, expected)
+        self.assertEqual(len(specio3.read_spc_matrix(merged)), 3)
+
+    def test_project_rejects_quality(self):
+        with self.assertRaises(ValueError):
+            specio3.read_spc(self.files[0], project=np.ones((10, 1)), check_quality=True)
+
+
+if __name__ == '__main__':
+    unittest.main()
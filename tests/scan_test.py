@@ -0,0 +1,106 @@
+import os
+import struct
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+
+
+class ScanTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )
+        self.tmp = tempfile.TemporaryDirectory()
+        self.merged = os.path.join(self.tmp.name, 'merged.spc')
+        specio3.merge_spc(self.files[:5], self.merged)
+        # merge_spc keeps the inputs' z (all 0 here); give the subfiles z = 10, 20, ... 50.
+        # Old-format multifiles keep their 32-byte subheaders together after the 256-byte header.
+        with open(self.merged, 'r+b') as f:
+            for s in range(5):
+                f.seek(256 + 32 * s + 4)
+                f.write(struct.pack('<f', 10.0 * (s + 1)))
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def _expected(self, paths, z=(-np.inf, np.inf), x=(-np.inf, np.inf), max_points=0):
+        rows = []
+        for i, path in enumerate(paths):
+            subfile_zs = specio3.read_spc_ragged(path)[3]
+            for s, (sx, sy) in enumerate(specio3.read_spc(path)):
+                subfile_z = subfile_zs[s]
+                if not z[0] <= subfile_z <= z[1]:
+                    continue
+                window = np.flatnonzero((sx >= x[0]) & (sx <= x[1]))
+                if max_points and len(window) > max_points:
+                    window = window[np.arange(max_points) * len(window) // max_points]
+                rows.append((sx[window], sy[window], subfile_z, (i, s)))
+        return rows
+
+    def _assert_matches(self, result, rows):
+        self.assertEqual(len(result.offsets), len(rows) + 1)
+        for r, (x, y, z, source) in enumerate(rows):
+            lo, hi = result.offsets[r], result.offsets[r + 1]
+            np.testing.assert_array_equal(result.x[lo:hi], x.astype(result.x.dtype))
+            np.testing.assert_array_equal(result.y[lo:hi], y.astype(result.y.dtype))
+            self.assertEqual(result.z[r], z)
+            self.assertEqual(tuple(result.source[r]), source)
+
+    def test_everything(self):
+        result = specio3.scan(self.files[:3]).collect()
+        self._assert_matches(result, self._expected(self.files[:3]))
+
+    def test_selections(self):
+        result = specio3.scan(self.merged).decimate(50).x_range(1800, 1000).select_z(15, 45).collect()
+        self._assert_matches(result, self._expected([self.merged], (15, 45), (1000, 1800), 50))
+        np.testing.assert_array_equal(result.z, [20, 30, 40])
+        np.testing.assert_array_equal(result.source[:, 1], [1, 2, 3])
+        self.assertEqual(len(specio3.scan(self.merged).select_z(None, 30).select_z(25).collect().z), 1)
+
+    def test_selections_narrow(self):
+        narrowed = specio3.scan(self.files[0]).x_range(500, 3000).x_range(1000, None).decimate(100).decimate(500)
+        expected = specio3.scan(self.files[0]).x_range(1000, 3000).decimate(100).collect()
+        result = narrowed.collect()
+        np.testing.assert_array_equal(result.x, expected.x)
+        np.testing.assert_array_equal(result.y, expected.y)
+
+    def test_astype(self):
+        result = specio3.scan([Path(self.merged)]).x_range(1000, 1100).astype(np.float32).collect()
+        self.assertEqual(result.y.dtype, np.float32)
+        self._assert_matches(result, self._expected([self.merged], x=(1000, 1100)))
+        with self.assertRaises(TypeError):
+            specio3.scan(self.merged).astype(np.int32)
+
+    def test_map_stats(self):
+        paths = [self.merged] + self.files[5:7]
+        stats = specio3.scan(paths).x_range(1600, 1700).map_stats().collect()
+        rows = self._expected(paths, x=(1600, 1700))
+        self.assertEqual(len(stats['mean']), len(rows))
+        for r, (_, y, z, source) in enumerate(rows):
+            self.assertEqual(stats['count'][r], len(y))
+            self.assertEqual(stats['min'][r], y.min())
+            self.assertEqual(stats['max'][r], y.max())
+            self.assertAlmostEqual(stats['mean'][r], y.mean(), delta=1e-9 * abs(y.mean()))
+            self.assertAlmostEqual(stats['std'][r], y.std(), delta=1e-9 * y.std())
+            self.assertEqual(tuple(stats['source'][r]), source)
+
+    def test_empty_selection(self):
+        result = specio3.scan(self.merged).x_range(1e6, 2e6).collect()
+        self.assertEqual(len(result.x), 0)
+        self.assertTrue(np.all(result.offsets == 0))
+        stats = specio3.scan(self.merged).x_range(1e6, 2e6).map_stats().collect()
+        self.assertTrue(np.all(stats['count'] == 0))
+        self.assertTrue(np.all(np.isnan(stats['mean'])))
+
+    def test_missing_file(self):
+        with self.assertRaisesRegex(RuntimeError, 'missing.spc'):
+            specio3.scan([self.files[0], os.path.join(self.tmp.name, 'missing.spc')]).collect()
+
+
+if __name__ == '__main__':
+    unittest.main()
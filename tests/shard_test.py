@@ -0,0 +1,64 @@
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+import specio3
+from tests.spc_data import data_files
+
+
+class ShardTests(unittest.TestCase):
+    def setUp(self):
+        self.paths = data_files()[:6]
+        self.tmp = tempfile.TemporaryDirectory()
+        self.shard_path = os.path.join(self.tmp.name, 'test.spcshard')
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def assert_same_spectra(self, actual, expected):
+        self.assertEqual(len(actual), len(expected))
+        for (x, y), (ex, ey) in zip(actual, expected):
+            np.testing.assert_array_equal(x, ex)
+            np.testing.assert_array_equal(y, ey)
+
+    def test_members_match_standalone_files(self):
+        shard = specio3.pack_shard(self.paths, self.shard_path)
+        self.assertEqual(len(shard), len(self.paths))
+        for i, path in enumerate(self.paths):
+            name = os.path.basename(path)
+            self.assertIn(name, shard)
+            expected = specio3.read_spc(path)
+            self.assert_same_spectra(shard.read(i), expected)
+            self.assert_same_spectra(shard.read(name), expected)
+            with open(path, 'rb') as f:
+                self.assertEqual(shard.read_bytes(name), f.read())
+
+    def test_index_summary(self):
+        shard = specio3.pack_shard(self.paths, self.shard_path, names=[f'm{i}' for i in range(len(self.paths))])
+        info = shard.info('m2')
+        self.assertEqual(info['length'], os.path.getsize(self.paths[2]))
+        self.assertEqual(info['offset'] % 64, 0)
+        self.assertEqual(info['num_subfiles'], len(specio3.read_spc(self.paths[2])))
+        self.assertEqual(shard.names, [f'm{i}' for i in range(len(self.paths))])
+
+    def test_scan_in_order(self):
+        shard = specio3.pack_shard(self.paths, self.shard_path)
+        scanned = list(shard.scan(batch_size=4, num_threads=2))
+        self.assertEqual([name for name, _ in scanned], [os.path.basename(p) for p in self.paths])
+        for (_, spectra), path in zip(scanned, self.paths):
+            self.assert_same_spectra(spectra, specio3.read_spc(path))
+
+    def test_errors(self):
+        with self.assertRaises(RuntimeError):
+            specio3.pack_shard([self.paths[0], self.paths[0]], self.shard_path)
+        shard = specio3.pack_shard(self.paths, self.shard_path)
+        with self.assertRaises(RuntimeError):
+            shard.read('missing.spc')
+        with self.assertRaises(RuntimeError):
+            specio3.Shard(self.paths[0])
+
+
+if __name__ == '__main__':
+    unittest.main()
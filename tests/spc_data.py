@@ -0,0 +1,109 @@
+"""Sample and synthetic SPC files shared by the test modules."""
+import functools
+import os
+import struct
+from pathlib import Path
+from typing import List, Tuple
+
+import numpy as np
+
+import specio3
+
+DATA_PATH = os.path.join(Path(__file__).parent.absolute(), 'data')
+
+
+def data_files() -> List[str]:
+    """Every sample file in tests/data, sorted by path."""
+    return sorted(os.path.join(DATA_PATH, f) for f in os.listdir(DATA_PATH) if f.lower().endswith('.spc'))
+
+
+@functools.lru_cache(maxsize=None)
+def _point_counts() -> Tuple[Tuple[str, int], ...]:
+    return tuple((path, len(specio3.read_spc(path)[0].y)) for path in data_files())
+
+
+def common_length_files() -> Tuple[List[str], List[str]]:
+    """
+    Split the sample files by point count.
+
+    Returns
+    -------
+    common, others
+        The files sharing the most common point count (enough to stack into
+        one matrix), and the remaining files, both sorted by path.
+    """
+    counts = [n for _, n in _point_counts()]
+    common = max(set(counts), key=counts.count)
+    return ([path for path, n in _point_counts() if n == common],
+            [path for path, n in _point_counts() if n != common])
+
+
+def write_spc(path, y, x=None, xyxy=False, exponent=-128, int16=False, x_range=(0.0, 1.0), z=None) -> str:
+    """
+    Write a synthetic new-format SPC file.
+
+    Parameters
+    ----------
+    path : str
+        Output file.
+    y : list of array_like
+        Y values of each subfile, stored as float32 when ``exponent`` is -128
+        and as raw integer codes (int32, or int16 with ``int16``) otherwise.
+        More than one subfile makes a multifile.
+    x : array_like or list of array_like, optional
+        Shared X axis of an XY file, or with ``xyxy`` one X axis per subfile.
+        Y-only files span ``x_range`` instead.
+    z : sequence of float, optional
+        Subfile Z values; the subfile index by default.
+
+    Returns
+    -------
+    str
+        ``path``.
+    """
+    multifile = len(y) > 1 or xyxy
+    y_dtype = '<f4' if exponent == -128 else ('<i2' if int16 else '<i4')
+    header = bytearray(512)
+    header[0] = (0x80 if x is not None else 0) | (0x10 if multifile else 0) | (0x40 if xyxy else 0) | int(int16)
+    header[1] = exponent & 0xFF
+    if x is not None:
+        axis = np.asarray(x[0] if xyxy else x, '<f4')
+        struct.pack_into('<H', header, 2, len(axis))
+        struct.pack_into('<ff', header, 8, axis[0], axis[-1])
+    else:
+        struct.pack_into('<ff', header, 8, *x_range)
+    struct.pack_into('<I', header, 22, len(y))
+
+    body = bytearray()
+    if x is not None and not xyxy:
+        body += np.asarray(x, '<f4').tobytes()
+    if multifile:
+        for i, values in enumerate(y):
+            sub = bytearray(32)
+            sub[1] = exponent & 0xFF
+            zi = float(i if z is None else z[i])
+            struct.pack_into('<Hff', sub, 2, i, zi, zi)
+            struct.pack_into('<I', sub, 16, len(values) if xyxy else 0)
+            body += sub
+    for i, values in enumerate(y):
+        if xyxy:
+            body += np.asarray(x[i], '<f4').tobytes()
+        body += np.asarray(values, y_dtype).tobytes()
+    with open(path, 'wb') as f:
+        f.write(bytes(header) + bytes(body))
+    return path
+
+
+def write_xyxy_spc(path) -> str:
+    """
+    Write an XYXY file of three peak lists of different lengths whose X
+    values are unsorted and include NaN, +Inf, points outside [0, 10] and
+    points exactly on 0 and 10. Z is 0.5, 1.5, 2.5.
+    """
+    x = [[5.0, 1.0, 3.0, 9.5, 2.0],
+         [np.nan, -4.0, 10.0, 0.0, 20.0, 2.5, 7.5],
+         [6.0, np.inf, 4.0]]
+    y = [[1.0, 2.0, 3.0, 4.0, 5.0],
+         [10.0, 20.0, 30.0, 40.0, 50.0, 60.0, 70.0],
+         [-1.5, 2.25, 8.0]]
+    return write_spc(path, y, x=x, xyxy=True, z=[0.5, 1.5, 2.5])
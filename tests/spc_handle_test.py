@@ -0,0 +1,61 @@
+import os
+import tempfile
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+
+
+class SpcHandleTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[:3]
+        self.tmp = tempfile.TemporaryDirectory()
+        self.merged = os.path.join(self.tmp.name, 'merged.spc')
+        specio3.merge_spc(self.files, self.merged)
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def test_matches_read_spc(self):
+        expected = specio3.read_spc(self.merged)
+        handle = specio3.SPCHandle(self.merged)
+        self.assertEqual(len(handle), len(expected))
+        for (x, y), (ex, ey) in zip(handle, expected):
+            np.testing.assert_array_equal(x, ex)
+            np.testing.assert_array_equal(y, ey)
+        np.testing.assert_array_equal(handle.read(-1).y, expected[-1].y)
+        np.testing.assert_array_equal(handle.read_y(1, 100, 150), expected[1].y[100:150])
+        np.testing.assert_array_equal(handle.read_y(1, -10), expected[1].y[-10:])
+        self.assertEqual(handle.z.shape, (len(expected),))
+
+    def test_concurrent_reads(self):
+        expected = specio3.read_spc(self.merged)
+        handle = specio3.SPCHandle(self.merged)
+        indices = [i % len(handle) for i in range(64)]
+        with ThreadPoolExecutor(max_workers=8) as pool:
+            results = list(pool.map(handle.read, indices))
+        for i, (x, y) in zip(indices, results):
+            np.testing.assert_array_equal(x, expected[i].x)
+            np.testing.assert_array_equal(y, expected[i].y)
+
+    def test_errors(self):
+        handle = specio3.SPCHandle(self.merged)
+        with self.assertRaises(IndexError):
+            handle.read(len(handle))
+        with self.assertRaises(RuntimeError):
+            specio3.SPCHandle(os.path.join(self.tmp.name, 'missing.spc'))
+        # The native range check runs before the output is allocated
+        n = handle.num_points(0)
+        for first, count in ((0, 2**62), (n, 1), (n + 1, 0)):
+            with self.assertRaisesRegex(RuntimeError, 'out of range'):
+                handle._handle.read_y(0, first, count)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,126 @@
+import os
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+from tests.spc_data import write_spc, write_xyxy_spc
+
+
+class SpcMatrixTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[:3]
+
+    def test_matches_read_spc(self):
+        for path in self.files:
+            spectra = specio3.read_spc(path)
+            expected = np.vstack([y for _, y in spectra])
+
+            x, y, z = specio3.read_spc_matrix(path)
+            np.testing.assert_array_equal(x, spectra[0][0])
+            np.testing.assert_array_equal(y, expected)
+            self.assertEqual(z.shape, (len(spectra),))
+
+            _, yt, _ = specio3.read_spc_matrix(path, transpose=True, num_threads=2)
+            self.assertTrue(yt.flags['C_CONTIGUOUS'])
+            np.testing.assert_array_equal(yt, expected.T)
+
+    def test_transpose_partial_tiles(self):
+        # 150 subfiles and 601 points leave partial tiles along both axes (64 subfiles x 256 points)
+        rng = np.random.default_rng(8)
+        codes = rng.integers(-2**31, 2**31, size=(150, 601))
+        codes[70, 300:305] = 2**31 - 1  # a saturated run in the second row of tiles
+        with tempfile.TemporaryDirectory() as tmp:
+            path = write_spc(os.path.join(tmp, 'tiles.spc'), list(codes), x=np.arange(601.0), exponent=8)
+            spectra, expected_quality = specio3.read_spc(path, check_quality=True)
+            expected = np.vstack([y for _, y in spectra])
+            for num_threads in (1, 3):
+                _, yt, z = specio3.read_spc_matrix(path, transpose=True, num_threads=num_threads)
+                self.assertEqual(yt.shape, (601, 150))
+                np.testing.assert_array_equal(yt, expected.T)
+                np.testing.assert_array_equal(z, np.arange(150))
+                _, yt, _, quality = specio3.read_spc_matrix(path, transpose=True, num_threads=num_threads,
+                                                            check_quality=True)
+                np.testing.assert_array_equal(yt, expected.T)
+                np.testing.assert_array_equal(quality, expected_quality)
+
+    def test_no_subfiles(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = write_spc(os.path.join(tmp, 'empty.spc'), [[1.0, 2.0], [3.0, 4.0]], x=[0.0, 1.0])
+            with open(path, 'r+b') as f:
+                f.seek(22)  # subfile count of a multifile
+                f.write((0).to_bytes(4, 'little'))
+            with self.assertRaisesRegex(RuntimeError, 'no subfiles'):
+                specio3.read_spc_matrix(path)
+
+    def test_ragged_matches_read_spc(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            merged = os.path.join(tmp, 'merged.spc')
+            specio3.merge_spc(self.files, merged)
+            # Peak lists of 5, 7 and 3 points, X including NaN and Inf
+            xyxy = write_xyxy_spc(os.path.join(tmp, 'xyxy.spc'))
+            for path in self.files + [merged, xyxy]:
+                spectra = specio3.read_spc(path)
+                x, y, offsets, z = specio3.read_spc_ragged(path, num_threads=2)
+                self.assertEqual(offsets.dtype, np.int64)
+                np.testing.assert_array_equal(np.diff(offsets), [len(s.x) for s in spectra])
+                self.assertEqual(offsets[-1], len(x))
+                np.testing.assert_array_equal(x, np.concatenate([s.x for s in spectra]))
+                np.testing.assert_array_equal(y, np.concatenate([s.y for s in spectra]))
+                self.assertEqual(z.shape, (len(spectra),))
+            _, _, offsets, z = specio3.read_spc_ragged(xyxy)
+            np.testing.assert_array_equal(offsets, [0, 5, 12, 15])
+            np.testing.assert_array_equal(z, [0.5, 1.5, 2.5])
+
+    def test_binned_matches_histogram(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            merged = os.path.join(tmp, 'merged.spc')
+            specio3.merge_spc(self.files, merged)
+            spectra = specio3.read_spc(merged)
+            for kwargs in ({'width': 10.0}, {'width': 2.5, 'x_range': (1000, 1800)},
+                           {'edges': [500, 1000, 1001, 1700, 4000]}):
+                values, edges, z = specio3.read_spc_binned(merged, num_threads=2, **kwargs)
+                self.assertEqual(values.shape, (len(spectra), len(edges) - 1))
+                self.assertEqual(z.shape, (len(spectra),))
+                for row, (x, y) in zip(values, spectra):
+                    expected, _ = np.histogram(x, edges, weights=y)
+                    np.testing.assert_allclose(row, expected, rtol=1e-12)
+            _, edges, _ = specio3.read_spc_binned(merged, width=10.0)
+            self.assertLessEqual(edges[0], spectra[0].x.min())
+            self.assertGreaterEqual(edges[-1], spectra[0].x.max())
+
+    def test_binned_xyxy_matches_histogram(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = write_xyxy_spc(os.path.join(tmp, 'xyxy.spc'))
+            spectra = specio3.read_spc(path)
+            finite = [(s.x[np.isfinite(s.x)], s.y[np.isfinite(s.x)]) for s in spectra]
+            for kwargs in ({'edges': [0.0, 2.5, 5.0, 7.5, 10.0]}, {'width': 3.0}, {'width': 1.0, 'x_range': (0.0, 10.0)}):
+                values, edges, z = specio3.read_spc_binned(path, num_threads=2, **kwargs)
+                np.testing.assert_array_equal(z, [0.5, 1.5, 2.5])
+                for row, (x, y) in zip(values, finite):
+                    expected, _ = np.histogram(x, edges, weights=y)
+                    np.testing.assert_array_equal(row, expected)
+            # The point on the last edge (10.0) falls in the last bin
+            values, _, _ = specio3.read_spc_binned(path, edges=[0.0, 5.0, 10.0])
+            self.assertEqual(values[1, 1], 30.0 + 70.0)
+            # Without a range, width bins span the finite X of every subfile
+            _, edges, _ = specio3.read_spc_binned(path, width=3.0)
+            self.assertEqual(edges[0], -4.0)
+            self.assertGreaterEqual(edges[-1], 20.0)
+
+    def test_binned_arguments(self):
+        with self.assertRaises(ValueError):
+            specio3.read_spc_binned(self.files[0])
+        with self.assertRaises(ValueError):
+            specio3.read_spc_binned(self.files[0], edges=[0, 1], width=1.0)
+        with self.assertRaises(RuntimeError):
+            specio3.read_spc_binned(self.files[0], edges=[0, 2, 1])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -1,7 +1,10 @@
 import os
+import tempfile
 import unittest
+import numpy as np
 import specio3
 from pathlib import Path
+from tests.spc_data import write_spc
 
 class SpcFileTests(unittest.TestCase):
     def setUp(self):
@@ -25,6 +28,32 @@ class SpcFileTests(unittest.TestCase):
         for file in files:
             self._test_read_multifile(file)
 
+    def test_streamed_file_matches_in_memory(self):
+        # Files over 4 MiB are streamed instead of read whole; the first 100
+        # subfiles on their own make a small file that takes the in-memory path
+        rng = np.random.default_rng(9)
+        codes = rng.integers(-2**31, 2**31, size=(1100, 1000))
+        x = 400.0 + 0.5 * np.arange(1000)
+        with tempfile.TemporaryDirectory() as tmp:
+            large = write_spc(os.path.join(tmp, 'large.spc'), list(codes), x=x, exponent=10)
+            small = write_spc(os.path.join(tmp, 'small.spc'), list(codes[:100]), x=x, exponent=10)
+            self.assertGreater(os.path.getsize(large), 4 << 20)
+            self.assertLess(os.path.getsize(small), 4 << 20)
+
+            streamed, streamed_quality = specio3.read_spc(large, check_quality=True)
+            in_memory, in_memory_quality = specio3.read_spc(small, check_quality=True)
+            self.assertEqual(len(streamed), 1100)
+            for a, b in zip(streamed, in_memory):
+                np.testing.assert_array_equal(a.x, b.x)
+                np.testing.assert_array_equal(a.y, b.y)
+            np.testing.assert_array_equal(streamed_quality[:100], in_memory_quality)
+
+            # Every subfile against the memory-mapped matrix reader
+            _, values, _, quality = specio3.read_spc_matrix(large, check_quality=True)
+            np.testing.assert_array_equal(np.vstack([y for _, y in streamed]), values)
+            np.testing.assert_array_equal(streamed[0].x, x)
+            np.testing.assert_array_equal(streamed_quality, quality)
+
 
 if __name__ == '__main__':
     unittest.main()
\ No newline at end of file
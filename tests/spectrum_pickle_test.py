@@ -0,0 +1,50 @@
+import os
+import pickle
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+
+
+class SpectrumPickleTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.path = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[0]
+        self.spectra = specio3.read_spc(self.path)
+
+    def test_read_spc_returns_spectrum_tuples(self):
+        spectrum = self.spectra[0]
+        self.assertIsInstance(spectrum, specio3.Spectrum)
+        self.assertIsInstance(spectrum, tuple)
+        x, y = spectrum
+        self.assertIs(x, spectrum.x)
+        self.assertIs(y, spectrum.y)
+
+    def test_protocol_5_buffers_are_out_of_band(self):
+        buffers = []
+        data = pickle.dumps(self.spectra, protocol=5, buffer_callback=buffers.append)
+        self.assertEqual(len(buffers), 2 * len(self.spectra))
+        self.assertLess(len(data), sum(s.y.nbytes for s in self.spectra))
+
+        restored = pickle.loads(data, buffers=buffers)
+        for original, copy in zip(self.spectra, restored):
+            self.assertIsInstance(copy, specio3.Spectrum)
+            np.testing.assert_array_equal(copy.x, original.x)
+            np.testing.assert_array_equal(copy.y, original.y)
+            self.assertTrue(np.shares_memory(copy.y, original.y))
+
+    def test_in_band_protocols_round_trip(self):
+        for protocol in (2, 4, 5):
+            restored = pickle.loads(pickle.dumps(self.spectra, protocol=protocol))
+            for original, copy in zip(self.spectra, restored):
+                self.assertIsInstance(copy, specio3.Spectrum)
+                np.testing.assert_array_equal(copy.y, original.y)
+                self.assertFalse(np.shares_memory(copy.y, original.y))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,49 @@
+import os
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+
+
+class IterReadTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )
+
+    def test_yields_every_file_once(self):
+        results = list(specio3.iter_read(self.files, num_threads=4))
+        self.assertEqual(sorted(path for path, _ in results), self.files)
+        for path, spectra in results:
+            expected = specio3.read_spc(path)
+            self.assertEqual(len(spectra), len(expected))
+            for (x, y), (ex, ey) in zip(spectra, expected):
+                np.testing.assert_array_equal(x, ex)
+                np.testing.assert_array_equal(y, ey)
+
+    def test_single_path(self):
+        ((path, spectra),) = list(specio3.iter_read(Path(self.files[0])))
+        self.assertEqual(path, self.files[0])
+        self.assertIsInstance(spectra[0], specio3.Spectrum)
+        self.assertEqual(list(specio3.iter_read([])), [])
+
+    def test_error_names_file(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            missing = os.path.join(tmp, 'missing.spc')
+            with self.assertRaisesRegex(RuntimeError, 'missing.spc'):
+                for _ in specio3.iter_read(self.files[:3] + [missing]):
+                    pass
+
+    def test_abandoned_iteration(self):
+        results = specio3.iter_read(self.files)
+        next(results)
+        results.close()
+        del results
+
+
+if __name__ == '__main__':
+    unittest.main()
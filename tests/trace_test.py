@@ -0,0 +1,78 @@
+import os
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+
+import specio3
+from tests.spc_data import write_spc
+
+
+class TraceTests(unittest.TestCase):
+    def setUp(self):
+        data_path = os.path.join(Path(__file__).parent.absolute(), 'data')
+        self.files = sorted(
+            os.path.join(data_path, f) for f in os.listdir(data_path) if f.lower().endswith('.spc')
+        )[:4]
+        self.tmp = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.tmp.cleanup()
+
+    def _check_multifile(self, path, targets):
+        """Compare read_trace with the nearest non-NaN X of every subfile returned by read_spc."""
+        spectra = specio3.read_spc(path)
+        values, z = specio3.read_trace(path, targets)
+        self.assertEqual(values.shape, (len(spectra), len(targets)))
+        np.testing.assert_array_equal(z, np.arange(len(spectra)))  # write_spc's default Z
+        for row, (x, y) in enumerate(spectra):
+            for col, target in enumerate(targets):
+                distance = np.abs(x - target)
+                if np.isnan(distance).all():
+                    self.assertTrue(np.isnan(values[row, col]))
+                else:
+                    self.assertEqual(values[row, col], y[np.nanargmin(distance)])
+
+    def test_matches_nearest_point(self):
+        for path in self.files:
+            x, y = specio3.read_spc(path)[0]
+            targets = [x[10] + 1e-6, 0.5 * (x[100] + x[101]) + 1e-3, x[-1] + 1000.0]
+            values, z = specio3.read_trace(path, targets)
+            self.assertEqual(values.shape, (1, len(targets)))
+            self.assertEqual(z.shape, (1,))
+            for col, target in enumerate(targets):
+                self.assertEqual(values[0, col], y[np.argmin(np.abs(x - target))])
+
+    def test_xy_multifile(self):
+        # More subfiles than one gather task covers
+        rng = np.random.default_rng(6)
+        x = 1000.0 - 4.0 * np.arange(50)
+        path = write_spc(os.path.join(self.tmp.name, 'xy.spc'), list(rng.normal(size=(1500, x.size))), x=x)
+        self._check_multifile(path, [1000.0, 901.0, 898.0, 500.0, 2000.0, -5.0])
+
+    def test_xyxy_unsorted_x(self):
+        rng = np.random.default_rng(7)
+        x, y = [], []
+        for i in range(1200):
+            xi = rng.uniform(0.0, 100.0, size=int(rng.integers(1, 12)))
+            xi[rng.random(xi.size) < 0.2] = np.nan
+            x.append(xi)
+            y.append(rng.normal(size=xi.size))
+        x[3][:] = np.nan
+        path = write_spc(os.path.join(self.tmp.name, 'xyxy.spc'), y, x=x, xyxy=True)
+        self._check_multifile(path, [0.0, 12.5, 50.0, 99.0, 250.0])
+
+    def test_scalar_position(self):
+        x, y = specio3.read_spc(self.files[0])[0]
+        values, _ = specio3.read_trace(self.files[0], x=float(x[5]))
+        self.assertEqual(values.shape, (1,))
+        self.assertEqual(values[0], y[5])
+
+    def test_non_finite_position_raises(self):
+        with self.assertRaises(RuntimeError):
+            specio3.read_trace(self.files[0], x=float('nan'))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,92 @@
+import os
+import pickle
+import tempfile
+import unittest
+
+import numpy as np
+
+import specio3
+from tests.spc_data import common_length_files, write_spc
+
+
+class VirtualDatasetTests(unittest.TestCase):
+    def setUp(self):
+        self.paths, others = common_length_files()
+        self.other = others[0] if others else None
+        self.x = specio3.read_spc(self.paths[0])[0][0]
+        self.matrix = np.vstack([y for p in self.paths for _, y in specio3.read_spc(p)])
+
+    def test_shape_and_axis(self):
+        ds = specio3.VirtualDataset(self.paths)
+        self.assertEqual(ds.shape, self.matrix.shape)
+        self.assertEqual(len(ds), self.matrix.shape[0])
+        np.testing.assert_array_equal(ds.x, self.x)
+        self.assertEqual(ds.location(1), (self.paths[1], 0))
+
+    def test_indexing_matches_eager_matrix(self):
+        ds = specio3.VirtualDataset(self.paths, cache_rows=4)
+        keys = [
+            np.s_[0], np.s_[-1], np.s_[1:5], np.s_[::-2], np.s_[:, 100], np.s_[2, 7],
+            np.s_[[3, 0, 3], 10:500:7], np.s_[1:4, ::-1], np.s_[..., 5:9], np.s_[0:0],
+            np.s_[:, [30, 2, 18]],
+        ]
+        for key in keys:
+            np.testing.assert_array_equal(ds[key], self.matrix[key])
+        np.testing.assert_array_equal(np.asarray(ds), self.matrix)
+
+    def test_row_cache_is_bounded(self):
+        ds = specio3.VirtualDataset(self.paths, cache_rows=3)
+        first = ds[0:5]
+        self.assertEqual(len(ds._cache), 3)
+        np.testing.assert_array_equal(ds[0:5], first)
+        ds[:, 10:20]
+        self.assertEqual(len(ds._cache), 3)
+
+    def test_out_of_range_raises(self):
+        ds = specio3.VirtualDataset(self.paths)
+        with self.assertRaises(IndexError):
+            ds[len(ds)]
+        with self.assertRaises(IndexError):
+            ds[0, ds.shape[1]]
+
+    def test_mismatched_files_raise(self):
+        if self.other is None:
+            self.skipTest('all test files have the same length')
+        with self.assertRaises(RuntimeError):
+            specio3.VirtualDataset([self.paths[0], self.other])
+
+    def test_x_axes_are_compared(self):
+        # Evenly spaced and exact in float32, so a Y-only file generates the same axis
+        x = 400.0 + 25.0 * np.arange(57)
+        y = [np.arange(57.0)]
+        with tempfile.TemporaryDirectory() as tmp:
+            xy = write_spc(os.path.join(tmp, 'xy.spc'), y, x=x)
+            same = write_spc(os.path.join(tmp, 'same.spc'), y, x=x)
+            yonly = write_spc(os.path.join(tmp, 'yonly.spc'), y, x_range=(400.0, 1800.0))
+            # Same points and endpoints, but not evenly spaced
+            shifted = write_spc(os.path.join(tmp, 'shifted.spc'), y, x=np.r_[x[0], x[1:-1] + 1.0, x[-1]])
+
+            ds = specio3.VirtualDataset([xy, same, yonly])
+            self.assertEqual(ds.shape, (3, 57))
+            np.testing.assert_array_equal(ds.x, x)
+            for paths in ([xy, shifted], [shifted, yonly], [yonly, shifted]):
+                with self.assertRaisesRegex(RuntimeError, 'X axis differs'):
+                    specio3.VirtualDataset(paths)
+
+    def test_pickles_by_path(self):
+        ds = specio3.VirtualDataset(self.paths)
+        restored = pickle.loads(pickle.dumps(ds))
+        np.testing.assert_array_equal(restored[1], self.matrix[1])
+
+    def test_dask_adapter(self):
+        try:
+            import dask  # noqa: F401
+        except ImportError:
+            self.skipTest('dask is not installed')
+        array = specio3.VirtualDataset(self.paths).to_dask(rows_per_chunk=3)
+        self.assertEqual(array.shape, self.matrix.shape)
+        np.testing.assert_allclose(array.mean(axis=0).compute(), self.matrix.mean(axis=0))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,72 @@
+import json
+import os
+import shutil
+import tempfile
+import unittest
+
+import numpy as np
+
+import specio3
+from tests.spc_data import common_length_files
+
+
+def read_y(store, zarr_format):
+    """Assemble the y array from raw chunk files without the zarr package."""
+    if zarr_format == 2:
+        meta = json.load(open(os.path.join(store, 'y', '.zarray')))
+        chunk_shape = meta['chunks']
+        key = lambda i, j: os.path.join(store, 'y', f'{i}.{j}')
+    else:
+        meta = json.load(open(os.path.join(store, 'y', 'zarr.json')))
+        chunk_shape = meta['chunk_grid']['configuration']['chunk_shape']
+        key = lambda i, j: os.path.join(store, 'y', 'c', str(i), str(j))
+    (rows, points), (cr, cp) = meta['shape'], chunk_shape
+    nr, np_ = -(-rows // cr), -(-points // cp)
+    y = np.empty((nr * cr, np_ * cp))
+    for i in range(nr):
+        for j in range(np_):
+            y[i * cr:(i + 1) * cr, j * cp:(j + 1) * cp] = np.fromfile(key(i, j), '<f8').reshape(cr, cp)
+    return y[:rows, :points]
+
+
+class ZarrExportTests(unittest.TestCase):
+    def setUp(self):
+        self.paths = common_length_files()[0][:7]
+        self.matrix = np.vstack([y for p in self.paths for _, y in specio3.read_spc(p)])
+        self.tmp = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.tmp)
+
+    def test_round_trip_both_formats(self):
+        for zarr_format in (2, 3):
+            store = os.path.join(self.tmp, f'v{zarr_format}.zarr')
+            rows = specio3.export_zarr(self.paths, store, chunks=(3, 1000), zarr_format=zarr_format, num_threads=2)
+            self.assertEqual(rows, len(self.matrix))
+            np.testing.assert_array_equal(read_y(store, zarr_format), self.matrix)
+
+    def test_attributes_describe_sources(self):
+        store = os.path.join(self.tmp, 'run.zarr')
+        specio3.export_zarr(self.paths, store)
+        attrs = json.load(open(os.path.join(store, '.zattrs')))
+        self.assertEqual([f['path'] for f in attrs['files']], self.paths)
+        self.assertEqual(attrs['files'][1]['first_row'], 1)
+        x = np.fromfile(os.path.join(store, 'x', '0'), '<f8')
+        np.testing.assert_array_equal(x, specio3.read_spc(self.paths[0])[0][0])
+
+    def test_zarr_package_reads_store(self):
+        try:
+            import zarr
+        except ImportError:
+            self.skipTest('zarr is not installed')
+        store = os.path.join(self.tmp, 'run.zarr')
+        specio3.export_zarr(self.paths, store, chunks=(2, 500))
+        np.testing.assert_array_equal(zarr.open(store, mode='r')['y'][:], self.matrix)
+
+    def test_invalid_format_raises(self):
+        with self.assertRaises(RuntimeError):
+            specio3.export_zarr(self.paths, os.path.join(self.tmp, 'bad.zarr'), zarr_format=4)
+
+
+if __name__ == '__main__':
+    unittest.main()